@@ -0,0 +1,195 @@
+#include <Common.h>
+#include <PixelConversion.h>
+
+#include <chrono>
+#include <random>
+
+// Pixel conversion micro-benchmark: every instruction set the CPU supports against the scalar loops, once the vector
+// paths have been checked to write the same bytes as the scalar conversion (for widths with a partial vector tail).
+// ---------------------------------------------------------
+
+constexpr std::array kValidationWidths = { 1U, 3U, 7U, 13U, 15U, 17U, 31U, 33U, 45U, 63U, 65U, 127U, 1001U, 4097U };
+
+// A 4096 x 4096 image, the conversions run once per decoded texture.
+constexpr size_t   kBenchmarkTexelCount = 4096U * 4096U;
+constexpr uint32_t kBenchmarkRuns       = 10U;
+
+// Written past the end of every destination, a conversion must not touch it.
+constexpr size_t  kGuardBytes = 64U;
+constexpr uint8_t kGuardValue = 0xCDU;
+
+constexpr std::array kISAs = { PixelConversionISA::Scalar, PixelConversionISA::SSE41, PixelConversionISA::AVX2 };
+
+struct Conversion
+{
+    const char* name;
+
+    // Bytes per element read / written (an element is a texel or a channel).
+    size_t sourceStride;
+    size_t destinationStride;
+
+    void (*pConvert)(const std::byte* pSource, std::byte* pDestination, size_t elementCount);
+};
+
+// clang-format off
+static const std::array kConversions = {
+    Conversion { "Gray -> RGBA",       1U, 4U, [](const std::byte* pS, std::byte* pD, size_t n) { ConvertGrayToRGBA(reinterpret_cast<const uint8_t*>(pS), reinterpret_cast<uint8_t*>(pD), n); } },
+    Conversion { "Gray Alpha -> RGBA", 2U, 4U, [](const std::byte* pS, std::byte* pD, size_t n) { ConvertGrayAlphaToRGBA(reinterpret_cast<const uint8_t*>(pS), reinterpret_cast<uint8_t*>(pD), n); } },
+    Conversion { "RGB -> RGBA",        3U, 4U, [](const std::byte* pS, std::byte* pD, size_t n) { ConvertRGBToRGBA(reinterpret_cast<const uint8_t*>(pS), reinterpret_cast<uint8_t*>(pD), n); } },
+    Conversion { "UNorm16 -> UNorm8",  2U, 1U, [](const std::byte* pS, std::byte* pD, size_t n) { ConvertUNorm16ToUNorm8(reinterpret_cast<const uint16_t*>(pS), reinterpret_cast<uint8_t*>(pD), n); } },
+    Conversion { "Float -> Half",      4U, 2U, [](const std::byte* pS, std::byte* pD, size_t n) { ConvertFloatToHalf(reinterpret_cast<const float*>(pS), reinterpret_cast<uint16_t*>(pD), n); } },
+};
+// clang-format on
+
+static const char* GetISAName(PixelConversionISA isa)
+{
+    switch (isa)
+    {
+        case PixelConversionISA::SSE41: return "SSE4.1";
+        case PixelConversionISA::AVX2:  return "AVX2";
+        default:                        return "Scalar";
+    }
+}
+
+// Random bytes, or random floats mixed with the values the half conversion has to special case.
+static std::vector<std::byte> CreateSource(const Conversion& conversion, size_t elementCount, std::mt19937& random)
+{
+    std::vector<std::byte> source(conversion.sourceStride * elementCount);
+
+    if (conversion.pConvert != kConversions.back().pConvert)
+    {
+        std::uniform_int_distribution<uint32_t> byteDistribution(0U, 255U);
+
+        for (auto& value : source)
+            value = static_cast<std::byte>(byteDistribution(random));
+
+        return source;
+    }
+
+    constexpr std::array kSpecialValues = { 0.0F, -0.0F, 1.0F, 65504.0F, 65520.0F, 1e-5F, 6e-8F, 1e-10F, -3.0e38F };
+
+    std::uniform_real_distribution<float> floatDistribution(-70000.0F, 70000.0F);
+    std::uniform_int_distribution<size_t> specialDistribution(0U, kSpecialValues.size() + 3U);
+
+    auto* pValues = reinterpret_cast<float*>(source.data());
+
+    for (size_t i = 0U; i < elementCount; i++)
+    {
+        auto special = specialDistribution(random);
+
+        if (special < kSpecialValues.size())
+            pValues[i] = kSpecialValues.at(special);
+        else if (special == kSpecialValues.size())
+            pValues[i] = std::numeric_limits<float>::infinity();
+        else if (special == kSpecialValues.size() + 1U)
+            pValues[i] = std::numeric_limits<float>::quiet_NaN();
+        else
+            pValues[i] = floatDistribution(random) * (special == kSpecialValues.size() + 2U ? 1e-4F : 1.0F);
+    }
+
+    return source;
+}
+
+static std::vector<std::byte> Convert(const Conversion& conversion, const std::vector<std::byte>& source, size_t elementCount, PixelConversionISA isa)
+{
+    std::vector<std::byte> destination(conversion.destinationStride * elementCount + kGuardBytes, static_cast<std::byte>(kGuardValue));
+
+    SetPixelConversionMaxISA(isa);
+    conversion.pConvert(source.data(), destination.data(), elementCount);
+
+    return destination;
+}
+
+static bool Validate(std::mt19937& random)
+{
+    auto isValid = true;
+
+    for (const auto& conversion : kConversions)
+    {
+        for (auto width : kValidationWidths)
+        {
+            auto source    = CreateSource(conversion, width, random);
+            auto reference = Convert(conversion, source, width, PixelConversionISA::Scalar);
+
+            for (auto isa : kISAs)
+            {
+                if (isa == PixelConversionISA::Scalar || !IsPixelConversionISASupported(isa))
+                    continue;
+
+                // Also covers the guard bytes.
+                if (Convert(conversion, source, width, isa) != reference)
+                {
+                    spdlog::error("{} | {} | Width {}: does not match the scalar conversion.", conversion.name, GetISAName(isa), width);
+                    isValid = false;
+                }
+            }
+        }
+    }
+
+    return isValid;
+}
+
+static void Benchmark(std::mt19937& random)
+{
+    for (const auto& conversion : kConversions)
+    {
+        auto source = CreateSource(conversion, kBenchmarkTexelCount, random);
+
+        std::vector<std::byte> destination(conversion.destinationStride * kBenchmarkTexelCount);
+
+        double scalarMilliseconds = 0.0;
+
+        for (auto isa : kISAs)
+        {
+            if (!IsPixelConversionISASupported(isa))
+            {
+                spdlog::info("{:<20} | {:<6} | Not supported by the CPU.", conversion.name, GetISAName(isa));
+                continue;
+            }
+
+            SetPixelConversionMaxISA(isa);
+
+            // Best of the runs (the first one also faults in the destination pages).
+            auto bestMilliseconds = std::numeric_limits<double>::max();
+
+            for (uint32_t run = 0U; run < kBenchmarkRuns; run++)
+            {
+                auto startTime = std::chrono::high_resolution_clock::now();
+
+                conversion.pConvert(source.data(), destination.data(), kBenchmarkTexelCount);
+
+                auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime);
+
+                bestMilliseconds = std::min(bestMilliseconds, elapsed.count());
+            }
+
+            if (isa == PixelConversionISA::Scalar)
+                scalarMilliseconds = bestMilliseconds;
+
+            auto sourceMegabytes = static_cast<double>(source.size()) / (1024.0 * 1024.0);
+
+            spdlog::info("{:<20} | {:<6} | {:8.3f} ms | {:8.1f} MB/s | {:5.2f}x",
+                         conversion.name,
+                         GetISAName(isa),
+                         bestMilliseconds,
+                         sourceMegabytes / (bestMilliseconds / 1000.0),
+                         scalarMilliseconds / bestMilliseconds);
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 random(1337U);
+
+    if (!Validate(random))
+        return 1;
+
+    spdlog::info("Validated every conversion against the scalar loops.");
+
+    Benchmark(random);
+
+    SetPixelConversionMaxISA(PixelConversionISA::AVX2);
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Constants
+// ---------------------------------
+
+struct Constants
+{
+    float4 _FrustumPlanes[6];
+    float3 _CameraPosition;
+    uint   _MeshletCount;
+    uint   _FrameIndex;
+};
+[[vk::push_constant]] Constants gConstants;
+
+// Inputs
+// ---------------------------------
+
+struct Meshlet
+{
+    float3 center;
+    float  radius;
+    float3 coneApex;
+    float  coneCutoff;
+    float3 coneAxis;
+    uint   triangleOffset;
+    uint   triangleCount;
+    uint   drawItemIndex;
+    uint   drawCommandOffset;
+    uint   drawCountIndex;
+};
+
+#include "VertexStreams.hlsl"
+
+// Matches VkDrawIndexedIndirectCommand.
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int  vertexOffset;
+    uint firstInstance;
+};
+
+[[vk::binding(0, 0)]]
+StructuredBuffer<Meshlet> _Meshlets;
+
+[[vk::binding(1, 0)]]
+StructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
+
+[[vk::binding(5, 0)]]
+StructuredBuffer<float4x4> _InstanceTransforms;
+
+// Outputs
+// ---------------------------------
+
+[[vk::binding(2, 0)]]
+RWStructuredBuffer<DrawIndexedIndirectCommand> _DrawCommands;
+
+[[vk::binding(3, 0)]]
+RWByteAddressBuffer _DrawCounts;
+
+// Last frame each draw item had a visible cluster (read back by the registry to rank textures for eviction).
+[[vk::binding(4, 0)]]
+RWByteAddressBuffer _DrawItemFeedback;
+
+// Implementation
+// ---------------------------------
+
+bool IsOutsideFrustum(float3 centerWS, float radiusWS)
+{
+    [unroll]
+    for (uint planeIndex = 0u; planeIndex < 6u; planeIndex++)
+    {
+        if (dot(gConstants._FrustumPlanes[planeIndex].xyz, centerWS) + gConstants._FrustumPlanes[planeIndex].w < -radiusWS)
+            return true;
+    }
+
+    return false;
+}
+
+// Ref: https://github.com/zeux/meshoptimizer#mesh-shading
+bool IsBackfacing(float3 coneApexWS, float3 coneAxisWS, float coneCutoff)
+{
+    return dot(normalize(coneApexWS - gConstants._CameraPosition), coneAxisWS) >= coneCutoff;
+}
+
+bool IsClusterCulled(Meshlet meshlet, float4x4 matrixM)
+{
+    float3 axisX = mul(matrixM, float4(1, 0, 0, 0)).xyz;
+    float3 axisY = mul(matrixM, float4(0, 1, 0, 0)).xyz;
+    float3 axisZ = mul(matrixM, float4(0, 0, 1, 0)).xyz;
+
+    float3 axisScale = float3(length(axisX), length(axisY), length(axisZ));
+
+    // Conservatively scale the bounds by the largest axis scale of the draw item.
+    float scaleMax = max(axisScale.x, max(axisScale.y, axisScale.z));
+    float scaleMin = min(axisScale.x, min(axisScale.y, axisScale.z));
+
+    float3 centerWS = mul(matrixM, float4(meshlet.center, 1.0)).xyz;
+
+    if (IsOutsideFrustum(centerWS, meshlet.radius * scaleMax))
+        return true;
+
+    // The cone cutoff is only preserved by a uniform scale without mirroring.
+    float determinant = dot(cross(axisX, axisY), axisZ);
+
+    if (determinant <= 0.0 || scaleMax - scaleMin > 1e-3 * scaleMax)
+        return false;
+
+    // Normals transform by the inverse-transpose, i.e. the cofactor matrix up to the (positive) determinant.
+    float3x3 cofactorM = float3x3(cross(axisY, axisZ), cross(axisZ, axisX), cross(axisX, axisY));
+
+    float3 coneApexWS = mul(matrixM, float4(meshlet.coneApex, 1.0)).xyz;
+    float3 coneAxisWS = normalize(mul(meshlet.coneAxis, cofactorM));
+
+    return IsBackfacing(coneApexWS, coneAxisWS, meshlet.coneCutoff);
+}
+
+[numthreads(64, 1, 1)]
+void Main(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    if (dispatchThreadID.x >= gConstants._MeshletCount)
+        return;
+
+    Meshlet meshlet = _Meshlets[dispatchThreadID.x];
+
+    // Freed range of the meshlet heap.
+    if (meshlet.drawItemIndex == 0xFFFFFFFFu)
+        return;
+
+    DrawItemMetaData metaData = _DrawItemMetaData[meshlet.drawItemIndex];
+
+    // The cluster is drawn for every instance of the draw item as soon as one of them sees it.
+    bool isVisible = false;
+
+    for (uint instanceIndex = 0u; instanceIndex < metaData.instanceCount && !isVisible; instanceIndex++)
+    {
+        float4x4 matrixM = mul(_InstanceTransforms[metaData.instanceOffset + instanceIndex], metaData.matrixM);
+
+        isVisible = !IsClusterCulled(meshlet, matrixM);
+    }
+
+    if (!isVisible)
+        return;
+
+    _DrawItemFeedback.Store(meshlet.drawItemIndex << 2u, gConstants._FrameIndex);
+
+    // Compact the surviving clusters into the command range of the draw item's level of detail.
+    uint commandIndex;
+    _DrawCounts.InterlockedAdd(meshlet.drawCountIndex << 2u, 1u, commandIndex);
+
+    DrawIndexedIndirectCommand command;
+    {
+        command.indexCount    = 3u * meshlet.triangleCount;
+        command.instanceCount = metaData.instanceCount;
+        command.firstIndex    = metaData.indexOffset + 3u * meshlet.triangleOffset;
+        command.vertexOffset  = 0;
+
+        // Forwarded to the visibility pass to reconstruct the primitive index within the draw item.
+        command.firstInstance = meshlet.triangleOffset;
+    }
+    _DrawCommands[meshlet.drawCommandOffset + commandIndex] = command;
+}
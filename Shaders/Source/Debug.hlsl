@@ -4,6 +4,7 @@
 struct Constants
 {
     float4x4 _MatrixVP;
+    float2   _RenderResolution;
     uint     DebugModeValue;
     uint     MeshCount;
 };
@@ -15,19 +16,15 @@ struct Interpolators
     float2 texCoord   : TEXCOORD0;
 };
 
-struct DrawItemMetaData
-{
-    float4x4 matrixM;
-    uint     faceCount;
-    uint     materialIndex;
-    uint2    unused;
-};
+#include "VertexStreams.hlsl"
+#include "MaterialParameters.hlsl"
+#include "VisibilityBuffer.hlsl"
 
 // Set #0
 // -----------------
 
 [[vk::binding(0, 0)]]
-Texture2D<uint> _VisibilityBuffer;
+Texture2D<uint2> _VisibilityBuffer;
 
 [[vk::binding(1, 0)]]
 Texture2D<float> _DepthBuffer;
@@ -36,26 +33,32 @@ Texture2D<float> _DepthBuffer;
 // -----------------
 
 [[vk::binding(0, 1)]]
-ByteAddressBuffer _IndexBuffers[];
+ByteAddressBuffer _IndexBuffer;
 
 [[vk::binding(1, 1)]]
-ByteAddressBuffer _VertexBuffers[];
+ByteAddressBuffer _VertexBuffer;
 
 [[vk::binding(2, 1)]]
-ByteAddressBuffer _TexcoordBuffers[];
+ByteAddressBuffer _TexcoordBuffer;
 
 [[vk::binding(3, 1)]]
 StructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
 
+[[vk::binding(4, 1)]]
+StructuredBuffer<float4x4> _InstanceTransforms;
+
 // Set #2
 // -----------------
 
 [[vk::binding(0, 2)]]
-Texture2D<float4> _AlbedoImages[];
+Texture2D<float4> _MaterialImages[];
 
 [[vk::binding(1, 2)]]
 SamplerState _DeviceMaterialImageSampler;
 
+[[vk::binding(2, 2)]]
+StructuredBuffer<MaterialParameters> _MaterialParameters;
+
 float3 ColorCycle(uint index, uint count)
 {
 	float t = frac(index / (float)count);
@@ -67,51 +70,36 @@ float3 ColorCycle(uint index, uint count)
 
 float4 DebugMeshID(Interpolators i)
 {
-    uint visibility = _VisibilityBuffer.Load(uint3(i.positionCS.xy, 0));
+    VisibilitySample visibility;
 
-    if (!visibility)
+    if (!DecodeVisibility(_VisibilityBuffer.Load(uint3(i.positionCS.xy, 0)), visibility))
         return 0;
 
-    return float4(ColorCycle(visibility >> 16U, gConstants.MeshCount), 1);
+    return float4(ColorCycle(visibility.drawItemIndex, gConstants.MeshCount), 1);
 }
 
 float4 DebugPrimitiveID(Interpolators i)
 {
-    uint visibility = _VisibilityBuffer.Load(uint3(i.positionCS.xy, 0));
+    VisibilitySample visibility;
 
-    if (!visibility)
+    if (!DecodeVisibility(_VisibilityBuffer.Load(uint3(i.positionCS.xy, 0)), visibility))
         return 0;
-        
-    // Decode mesh and triangle data. 
-    const uint meshIndex = visibility >> 16U;
-    const uint primIndex = visibility & 0xFFFF;
 
-    return float4(ColorCycle(primIndex, _DrawItemMetaData[meshIndex].faceCount), 1);
+    return float4(ColorCycle(visibility.primitiveIndex, _DrawItemMetaData[visibility.drawItemIndex].faceCount), 1);
 }
 
 #include "Barycentric.hlsl"
 
-float4 DebugBarycentricCoordinate(Interpolators i)
+// Analytic barycentrics (and their screen-space derivatives) of the pixel in the visibility buffer triangle.
+Barycentric::Data ComputePixelBarycentrics(Interpolators i, DrawItemMetaData metaData, uint3 indices, uint instanceIndex)
 {
-    uint visibility = _VisibilityBuffer.Load(uint3(i.positionCS.xy, 0));
-
-    if (!visibility)
-        return 0;
-
-    // Decode mesh and triangle data. 
-    const uint meshIndex = visibility >> 16U;
-    const uint primIndex = visibility & 0xFFFF;
-
-    // Load primitive indices.
-    uint3 indices = _IndexBuffers[NonUniformResourceIndex(meshIndex)].Load3(12U * primIndex);
-
     // Load points.
-    float3 positionOS0 = asfloat(_VertexBuffers[NonUniformResourceIndex(meshIndex)].Load3(12U * indices.x));
-    float3 positionOS1 = asfloat(_VertexBuffers[NonUniformResourceIndex(meshIndex)].Load3(12U * indices.y));
-    float3 positionOS2 = asfloat(_VertexBuffers[NonUniformResourceIndex(meshIndex)].Load3(12U * indices.z));
+    float3 positionOS0 = LoadPositionOS(_VertexBuffer, indices.x, metaData);
+    float3 positionOS1 = LoadPositionOS(_VertexBuffer, indices.y, metaData);
+    float3 positionOS2 = LoadPositionOS(_VertexBuffer, indices.z, metaData);
 
     // Construct the final matrix.
-    float4x4 matrixMVP = mul(gConstants._MatrixVP, _DrawItemMetaData[meshIndex].matrixM);
+    float4x4 matrixMVP = mul(gConstants._MatrixVP, mul(_InstanceTransforms[metaData.instanceOffset + instanceIndex], metaData.matrixM));
 
     // Compute homogenous coordinates.
     float4 positionCS0 = mul(matrixMVP, float4(positionOS0, 1.0));
@@ -119,28 +107,27 @@ float4 DebugBarycentricCoordinate(Interpolators i)
     float4 positionCS2 = mul(matrixMVP, float4(positionOS2, 1.0));
 
     // Need to flip the pixel coordinate. 
-    i.texCoord = float2(i.texCoord.x, 1 - i.texCoord.y);
+    float2 texCoord = float2(i.texCoord.x, 1 - i.texCoord.y);
 
-    // Compute barycentric coordinates.
-    Barycentric::Data barycentrics = Barycentric::Compute(positionCS0, positionCS1, positionCS2, -1 + 2 * i.texCoord, float2(1920, 1080));
+    return Barycentric::Compute(positionCS0, positionCS1, positionCS2, -1 + 2 * texCoord, gConstants._RenderResolution);
+}
 
-#if 1
-    // Lazy gamma-correct.
-    return float4(sqrt(barycentrics.m_lambda), 1);
-#else
-    
-    // Load texture coordinates.
-    float2 st0 = asfloat(_TexcoordBuffers[NonUniformResourceIndex(meshIndex)].Load2((primIndex * 3U + 0U) << 3U));
-    float2 st1 = asfloat(_TexcoordBuffers[NonUniformResourceIndex(meshIndex)].Load2((primIndex * 3U + 1U) << 3U));
-    float2 st2 = asfloat(_TexcoordBuffers[NonUniformResourceIndex(meshIndex)].Load2((primIndex * 3U + 2U) << 3U));
+float4 DebugBarycentricCoordinate(Interpolators i)
+{
+    VisibilitySample visibility;
 
-    float2 st = barycentrics.m_lambda.x * st0 + barycentrics.m_lambda.y * st1 + barycentrics.m_lambda.z * st2;
+    if (!DecodeVisibility(_VisibilityBuffer.Load(uint3(i.positionCS.xy, 0)), visibility))
+        return 0;
 
-    st = float2(st.x, 1.0 - st.y);
+    DrawItemMetaData metaData = _DrawItemMetaData[visibility.drawItemIndex];
 
-    return sqrt(_AlbedoImages[NonUniformResourceIndex(_DrawItemMetaData[meshIndex].materialIndex)].Sample(_DeviceMaterialImageSampler, st));
+    // Load primitive indices.
+    uint3 indices = LoadTriangleIndices(_IndexBuffer, visibility.primitiveIndex, metaData);
+
+    Barycentric::Data barycentrics = ComputePixelBarycentrics(i, metaData, indices, visibility.instanceIndex);
 
-#endif
+    // Lazy gamma-correct.
+    return float4(sqrt(barycentrics.m_lambda), 1);
 }
 
 float4 DebugDepth(Interpolators i)
@@ -150,14 +137,45 @@ float4 DebugDepth(Interpolators i)
 
 float4 DebugAlbedo(Interpolators i)
 {
-    uint visibility = _VisibilityBuffer.Load(uint3(i.positionCS.xy, 0));
+    VisibilitySample visibility;
 
-    if (!visibility)
+    if (!DecodeVisibility(_VisibilityBuffer.Load(uint3(i.positionCS.xy, 0)), visibility))
         return 0;
 
-    float4 albedo = _AlbedoImages[NonUniformResourceIndex(0U)].Load(uint3(0, 0, 0));
+    DrawItemMetaData metaData = _DrawItemMetaData[visibility.drawItemIndex];
+
+    // Every parameter of the pixel is a single fetch.
+    MaterialParameters parameters = _MaterialParameters[metaData.materialIndex];
+
+    float4 baseColor    = GetBaseColorOpacity(parameters);
+    uint   textureIndex = GetTextureIndex(parameters, MATERIAL_TEXTURE_BASE_COLOR);
+
+    if (textureIndex != MATERIAL_TEXTURE_NONE)
+    {
+        uint3 indices = LoadTriangleIndices(_IndexBuffer, visibility.primitiveIndex, metaData);
+
+        Barycentric::Data barycentrics = ComputePixelBarycentrics(i, metaData, indices, visibility.instanceIndex);
+
+        // Load texture coordinates.
+        float2 st0 = LoadTexCoord(_TexcoordBuffer, indices.x, metaData);
+        float2 st1 = LoadTexCoord(_TexcoordBuffer, indices.y, metaData);
+        float2 st2 = LoadTexCoord(_TexcoordBuffer, indices.z, metaData);
+
+        float2 st = barycentrics.m_lambda.x * st0 + barycentrics.m_lambda.y * st1 + barycentrics.m_lambda.z * st2;
+
+        st = float2(st.x, 1.0 - st.y);
+
+        // No hardware derivatives in a full-screen pass, select the mip level from the screen-space barycentric derivatives.
+        float2 stDdx = barycentrics.m_ddx.x * st0 + barycentrics.m_ddx.y * st1 + barycentrics.m_ddx.z * st2;
+        float2 stDdy = barycentrics.m_ddy.x * st0 + barycentrics.m_ddy.y * st1 + barycentrics.m_ddy.z * st2;
+
+        stDdx.y = -stDdx.y;
+        stDdy.y = -stDdy.y;
+
+        baseColor *= _MaterialImages[NonUniformResourceIndex(textureIndex)].SampleGrad(_DeviceMaterialImageSampler, st, stDdx, stDdy);
+    }
 
-    return float4(albedo.rgb, 1);
+    return float4(baseColor.rgb, 1);
 }
 
 float4 Frag(Interpolators i) : SV_Target
@@ -0,0 +1,49 @@
+// Include
+// ---------------------------------
+
+#include "VertexStreams.hlsl"
+
+// Constants
+// ---------------------------------
+
+struct Constants
+{
+    uint _UpdateOffset;
+    uint _UpdateCount;
+};
+[[vk::push_constant]] Constants gConstants;
+
+// Inputs
+// ---------------------------------
+
+struct DrawItemMetaDataUpdate
+{
+    uint             drawItemIndex;
+    uint             unused0;
+    uint             unused1;
+    uint             unused2;
+    DrawItemMetaData metaData;
+};
+
+[[vk::binding(0, 0)]]
+StructuredBuffer<DrawItemMetaDataUpdate> _DrawItemUpdates;
+
+// Outputs
+// ---------------------------------
+
+[[vk::binding(1, 0)]]
+RWStructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
+
+// Implementation
+// ---------------------------------
+
+[numthreads(64, 1, 1)]
+void Main(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    if (dispatchThreadID.x >= gConstants._UpdateCount)
+        return;
+
+    DrawItemMetaDataUpdate update = _DrawItemUpdates[gConstants._UpdateOffset + dispatchThreadID.x];
+
+    _DrawItemMetaData[update.drawItemIndex] = update.metaData;
+}
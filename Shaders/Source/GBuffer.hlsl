@@ -2,6 +2,8 @@
 // ---------------------------------
 
 #include "Barycentric.hlsl"
+#include "VertexStreams.hlsl"
+#include "VisibilityBuffer.hlsl"
 
 // Constants
 // ---------------------------------
@@ -15,30 +17,22 @@ struct Constants
 // Inputs
 // ---------------------------------
 
-// Mesh Meta-data Schema:
-// 0..4 Byte -> Index Start
-// 4..8 Byte -> Position Start
-// TODO the rest...
+// Streams are addressed through the draw item meta-data ranges in the geometry heap.
 
 [[vk::binding(0, 0)]]
-Texture2D<uint> _VisibilityBuffer;
-
-[[vk::binding(1, 0)]]
-ByteAddressBuffer _MeshMetadatas;
+Texture2D<uint2> _VisibilityBuffer;
 
 [[vk::binding(2, 0)]]
-ByteAddressBuffer _IndexBuffers[];
+ByteAddressBuffer _IndexBuffer;
 
 [[vk::binding(3, 0)]]
-ByteAddressBuffer _PositionBuffers[];
-
-// NOTE: For now the below buffer lists are of USD Face-varying primvars. Sample accordingly!
-
-[[vk::binding(4, 0)]]
-ByteAddressBuffer _NormalBuffers[];
+ByteAddressBuffer _PositionBuffer;
 
 [[vk::binding(5, 0)]]
-ByteAddressBuffer _TexcoordBuffers[];
+ByteAddressBuffer _TexcoordBuffer;
+
+[[vk::binding(6, 0)]]
+StructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
 
 // Outputs
 // ---------------------------------
@@ -53,22 +47,23 @@ RWByteAddressBuffer _DummyOutput;
 void Main(uint3 dispatchThreadID : SV_DispatchThreadID)
 {
     // Read off the visibility sample data.
-    uint visibilityData = _VisibilityBuffer.Load(uint3(dispatchThreadID.xy, 0u));
+    uint2 visibilityData = _VisibilityBuffer.Load(uint3(dispatchThreadID.xy, 0u));
+
+    // Decode the draw item, instance and primitive index.
+    VisibilitySample visibility;
 
-    // Decode the mesh index and primitive index.
-    uint meshIndex = visibilityData >> 16u;
-    uint primIndex = visibilityData & 0xFFFF;
+    if (!DecodeVisibility(visibilityData, visibility))
+        return;
 
-    // Read off the mesh meta-data.
-    uint2 meshMetaData = _MeshMetadatas.Load2(meshIndex << 3u);
+    DrawItemMetaData drawItemMetaData = _DrawItemMetaData[visibility.drawItemIndex];
 
     // Read off the triangle indices.
-    uint3 triangleIndices = _IndexBuffers[NonUniformResourceIndex(meshMetaData.x)].Load3((3u * primIndex) << 2u);
+    uint3 triangleIndices = LoadTriangleIndices(_IndexBuffer, visibility.primitiveIndex, drawItemMetaData);
 
-    // Load triangle positions.
-    float4 positionH0 = _PositionBuffers[NonUniformResourceIndex(meshMetaData.y)].Load4(triangleIndices.x << 4u);
-    float4 positionH1 = _PositionBuffers[NonUniformResourceIndex(meshMetaData.y)].Load4(triangleIndices.y << 4u);
-    float4 positionH2 = _PositionBuffers[NonUniformResourceIndex(meshMetaData.y)].Load4(triangleIndices.z << 4u);
+    // Load triangle positions (decoding the compact format if needed).
+    float4 positionH0 = float4(LoadPositionOS(_PositionBuffer, triangleIndices.x, drawItemMetaData), 1.0);
+    float4 positionH1 = float4(LoadPositionOS(_PositionBuffer, triangleIndices.y, drawItemMetaData), 1.0);
+    float4 positionH2 = float4(LoadPositionOS(_PositionBuffer, triangleIndices.z, drawItemMetaData), 1.0);
 
     // Compute the barycentric coordinate + partial derivatives.
     Barycentric::Data barycentric = Barycentric::Compute(positionH0, positionH1, positionH2, float2(0, 0), gConstants._ViewportSize);
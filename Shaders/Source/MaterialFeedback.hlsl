@@ -0,0 +1,95 @@
+// Include
+// ---------------------------------
+
+#include "Barycentric.hlsl"
+#include "VertexStreams.hlsl"
+#include "VisibilityBuffer.hlsl"
+
+// Constants
+// ---------------------------------
+
+struct Constants
+{
+    float4x4 _MatrixVP;
+    float2   _RenderResolution;
+    uint     _FrameIndex;
+};
+[[vk::push_constant]] Constants gConstants;
+
+// Inputs
+// ---------------------------------
+
+[[vk::binding(0, 0)]]
+Texture2D<uint2> _VisibilityBuffer;
+
+[[vk::binding(0, 1)]]
+ByteAddressBuffer _IndexBuffer;
+
+[[vk::binding(1, 1)]]
+ByteAddressBuffer _VertexBuffer;
+
+[[vk::binding(2, 1)]]
+ByteAddressBuffer _TexcoordBuffer;
+
+[[vk::binding(3, 1)]]
+StructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
+
+[[vk::binding(4, 1)]]
+StructuredBuffer<float4x4> _InstanceTransforms;
+
+// Outputs
+// ---------------------------------
+
+// Per material slot: frame index (upper 28 bits) | texel resolution log2 (lower 4 bits).
+[[vk::binding(1, 0)]]
+RWByteAddressBuffer _MaterialFeedback;
+
+// Implementation
+// ---------------------------------
+
+// Request the texel resolution (log2, along the longest axis) the material needs for one texel per pixel, read back by
+// the resource registry to stream the mip levels of its texture. One thread per 4x4 tile, a single pixel of each tile
+// is visited per frame.
+[numthreads(8, 8, 1)]
+void Main(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    uint frameSample = gConstants._FrameIndex & 15U;
+
+    uint2 pixel = (dispatchThreadID.xy << 2U) + uint2(frameSample & 3U, frameSample >> 2U);
+
+    if (any(pixel >= (uint2)gConstants._RenderResolution))
+        return;
+
+    VisibilitySample visibility;
+
+    if (!DecodeVisibility(_VisibilityBuffer.Load(uint3(pixel, 0)), visibility))
+        return;
+
+    DrawItemMetaData metaData = _DrawItemMetaData[visibility.drawItemIndex];
+
+    uint3 indices = LoadTriangleIndices(_IndexBuffer, visibility.primitiveIndex, metaData);
+
+    float4x4 matrixMVP = mul(gConstants._MatrixVP, mul(_InstanceTransforms[metaData.instanceOffset + visibility.instanceIndex], metaData.matrixM));
+
+    float4 positionCS0 = mul(matrixMVP, float4(LoadPositionOS(_VertexBuffer, indices.x, metaData), 1.0));
+    float4 positionCS1 = mul(matrixMVP, float4(LoadPositionOS(_VertexBuffer, indices.y, metaData), 1.0));
+    float4 positionCS2 = mul(matrixMVP, float4(LoadPositionOS(_VertexBuffer, indices.z, metaData), 1.0));
+
+    float2 pixelNdc = -1 + 2 * (pixel + 0.5) / gConstants._RenderResolution;
+
+    Barycentric::Data barycentrics = Barycentric::Compute(positionCS0, positionCS1, positionCS2, pixelNdc, gConstants._RenderResolution);
+
+    float2 st0 = LoadTexCoord(_TexcoordBuffer, indices.x, metaData);
+    float2 st1 = LoadTexCoord(_TexcoordBuffer, indices.y, metaData);
+    float2 st2 = LoadTexCoord(_TexcoordBuffer, indices.z, metaData);
+
+    // Texture coordinate footprint of the pixel.
+    float2 stDdx = barycentrics.m_ddx.x * st0 + barycentrics.m_ddx.y * st1 + barycentrics.m_ddx.z * st2;
+    float2 stDdy = barycentrics.m_ddy.x * st0 + barycentrics.m_ddy.y * st1 + barycentrics.m_ddy.z * st2;
+
+    float footprint = max(max(length(stDdx), length(stDdy)), 1e-6);
+
+    uint resolutionLog2 = (uint)clamp(ceil(-log2(footprint)), 0.0, 15.0);
+
+    _MaterialFeedback.InterlockedMax(metaData.materialIndex << 2U, (gConstants._FrameIndex << 4U) | resolutionLog2);
+}
@@ -0,0 +1,60 @@
+#ifndef MATERIAL_PARAMETERS_HLSL
+#define MATERIAL_PARAMETERS_HLSL
+
+// Textured inputs (matches MaterialTexture in ResourceRegistry.h).
+#define MATERIAL_TEXTURE_BASE_COLOR 0u
+#define MATERIAL_TEXTURE_METALNESS  1u
+#define MATERIAL_TEXTURE_ROUGHNESS  2u
+#define MATERIAL_TEXTURE_NORMAL     3u
+#define MATERIAL_TEXTURE_EMISSIVE   4u
+
+#define MATERIAL_TEXTURE_NONE 0xFFFFu
+
+// Surface parameters of a material slot (matches DeviceMaterialParameters in ResourceRegistry.h), 16-bit packed:
+//   packed0: base color rgb, opacity | emissive rgb, metalness (half floats)
+//   packed1: roughness, normal scale (half floats) | texture indices (one per input) + padding
+struct MaterialParameters
+{
+    uint4 packed0;
+    uint4 packed1;
+};
+
+float2 UnpackHalf2(uint packed)
+{
+    return float2(f16tof32(packed), f16tof32(packed >> 16u));
+}
+
+float4 GetBaseColorOpacity(MaterialParameters parameters)
+{
+    return float4(UnpackHalf2(parameters.packed0.x), UnpackHalf2(parameters.packed0.y));
+}
+
+float3 GetEmissive(MaterialParameters parameters)
+{
+    return float3(UnpackHalf2(parameters.packed0.z), f16tof32(parameters.packed0.w));
+}
+
+float GetMetalness(MaterialParameters parameters)
+{
+    return f16tof32(parameters.packed0.w >> 16u);
+}
+
+float GetRoughness(MaterialParameters parameters)
+{
+    return f16tof32(parameters.packed1.x);
+}
+
+float GetNormalScale(MaterialParameters parameters)
+{
+    return f16tof32(parameters.packed1.x >> 16u);
+}
+
+// Bindless material image of an input, MATERIAL_TEXTURE_NONE if it only uses the factor.
+uint GetTextureIndex(MaterialParameters parameters, uint input)
+{
+    uint packed = parameters.packed1[1u + (input >> 1u)];
+
+    return (packed >> ((input & 1u) << 4u)) & 0xFFFFu;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef VERTEX_STREAMS_HLSL
+#define VERTEX_STREAMS_HLSL
+
+// Draw item flags (matches the flags in MeshProcessing.h).
+#define DRAW_ITEM_FLAG_QUANTIZED_VERTICES (1u << 0u)
+
+struct DrawItemMetaData
+{
+    float4x4 matrixM;
+    uint     faceCount;
+    uint     materialIndex;
+    uint     flags;
+    uint     instanceOffset;
+
+    // Dequantization of the position stream (identity unless DRAW_ITEM_FLAG_QUANTIZED_VERTICES is set).
+    float4   positionScale;
+    float4   positionOffset;
+
+    // Range in the instance transform buffer (a single identity for non-instanced draw items).
+    uint     instanceCount;
+
+    // Geometry heap ranges (first index, byte offsets of the vertex streams).
+    uint     indexOffset;
+    uint     positionBufferOffset;
+    uint     texCoordBufferOffset;
+};
+
+// Triangle indices are relative to the draw item's vertex ranges.
+uint3 LoadTriangleIndices(ByteAddressBuffer indexBuffer, uint primitiveIndex, DrawItemMetaData metaData)
+{
+    return indexBuffer.Load3((metaData.indexOffset + 3u * primitiveIndex) << 2u);
+}
+
+// Positions are either float3 or 16-bit UNORM (xyz + padding) relative to the mesh AABB.
+float3 LoadPositionOS(ByteAddressBuffer vertexBuffer, uint vertexIndex, DrawItemMetaData metaData)
+{
+    if (metaData.flags & DRAW_ITEM_FLAG_QUANTIZED_VERTICES)
+    {
+        uint2 packed = vertexBuffer.Load2(metaData.positionBufferOffset + (vertexIndex << 3u));
+
+        float3 positionUnorm = float3(packed.x & 0xFFFF, packed.x >> 16u, packed.y & 0xFFFF) / 65535.0;
+
+        return metaData.positionOffset.xyz + metaData.positionScale.xyz * positionUnorm;
+    }
+
+    return asfloat(vertexBuffer.Load3(metaData.positionBufferOffset + 12u * vertexIndex));
+}
+
+// Texture coordinates share the index buffer with the positions, either float2 or half2.
+float2 LoadTexCoord(ByteAddressBuffer texCoordBuffer, uint vertexIndex, DrawItemMetaData metaData)
+{
+    if (metaData.flags & DRAW_ITEM_FLAG_QUANTIZED_VERTICES)
+    {
+        uint packed = texCoordBuffer.Load(metaData.texCoordBufferOffset + (vertexIndex << 2u));
+
+        return f16tof32(uint2(packed & 0xFFFF, packed >> 16u));
+    }
+
+    return asfloat(texCoordBuffer.Load2(metaData.texCoordBufferOffset + (vertexIndex << 3u)));
+}
+
+#endif
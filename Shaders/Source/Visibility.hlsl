@@ -1,23 +1,61 @@
+#include "VertexStreams.hlsl"
+#include "VisibilityBuffer.hlsl"
+
 struct Constants
 {
-    float4x4 _MatrixMVP;
+    float4x4 _MatrixVP;
     uint     _MeshID;
     uint     _MeshCount;
 };
 [[vk::push_constant]] Constants gConstants;
 
+[[vk::binding(0, 0)]]
+StructuredBuffer<DrawItemMetaData> _DrawItemMetaData;
+
+[[vk::binding(1, 0)]]
+StructuredBuffer<float4x4> _InstanceTransforms;
+
+// Position stream of every draw item (geometry heap), bound once for the whole pass.
+[[vk::binding(2, 0)]]
+ByteAddressBuffer _PositionBuffer;
+
 struct VertexInput
 {
-    [[vk::location(0)]] float3 positionOS : POSITION;
+    // Index buffer values are relative to the draw item's position range.
+    uint vertexID : SV_VertexID;
+
+    // Meshlets are drawn as sub-ranges of the index buffer, the cluster culling pass writes the triangle offset here.
+    [[vk::builtin("BaseInstance")]] uint triangleOffset : BASE_INSTANCE;
+
+    // Includes the base instance (SPIR-V InstanceIndex), subtract the triangle offset for the index within the draw item's instance range.
+    uint instanceID : SV_InstanceID;
+};
+
+struct Interpolators
+{
+    float4               positionCS     : SV_Position;
+    nointerpolation uint triangleOffset : TEXCOORD0;
+    nointerpolation uint instanceIndex  : TEXCOORD1;
 };
 
-float4 Vert(VertexInput input) : SV_Position
+Interpolators Vert(VertexInput input)
 {
-    return mul(gConstants._MatrixMVP, float4(input.positionOS, 1.0));
+    DrawItemMetaData metaData = _DrawItemMetaData[gConstants._MeshID];
+
+    uint instanceIndex = input.instanceID - input.triangleOffset;
+
+    float3 positionOS = LoadPositionOS(_PositionBuffer, input.vertexID, metaData);
+
+    float4 positionWS = mul(_InstanceTransforms[metaData.instanceOffset + instanceIndex], mul(metaData.matrixM, float4(positionOS, 1.0)));
+
+    Interpolators output;
+    output.positionCS     = mul(gConstants._MatrixVP, positionWS);
+    output.triangleOffset = input.triangleOffset;
+    output.instanceIndex  = instanceIndex;
+    return output;
 }
 
-uint Frag(uint primitiveID : SV_PrimitiveID) : SV_Target
+uint2 Frag(Interpolators input, uint primitiveID : SV_PrimitiveID) : SV_Target
 {
-    // Warning: Bad things will happen for index count greater than 1 << 16u. 
-    return gConstants._MeshID << 16u | primitiveID;
-}
\ No newline at end of file
+    return EncodeVisibility(gConstants._MeshID, input.instanceIndex, input.triangleOffset + primitiveID);
+}
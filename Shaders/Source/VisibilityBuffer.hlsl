@@ -0,0 +1,32 @@
+#ifndef VISIBILITY_BUFFER_HLSL
+#define VISIBILITY_BUFFER_HLSL
+
+// Visibility buffer sample layout (R32G32_UINT):
+//   x: draw item index (lower 16 bits) | instance index within the draw item (upper 16 bits)
+//   y: primitive index, relative to the first triangle of the draw item's LOD chain
+// The buffer is cleared to VISIBILITY_EMPTY, which the draw item / instance limits keep out of reach.
+#define VISIBILITY_EMPTY 0xFFFFFFFFu
+
+struct VisibilitySample
+{
+    uint drawItemIndex;
+    uint instanceIndex;
+    uint primitiveIndex;
+};
+
+uint2 EncodeVisibility(uint drawItemIndex, uint instanceIndex, uint primitiveIndex)
+{
+    return uint2(drawItemIndex | (instanceIndex << 16u), primitiveIndex);
+}
+
+// Returns false for pixels no triangle was rasterized to.
+bool DecodeVisibility(uint2 data, out VisibilitySample visibility)
+{
+    visibility.drawItemIndex  = data.x & 0xFFFF;
+    visibility.instanceIndex  = data.x >> 16u;
+    visibility.primitiveIndex = data.y;
+
+    return data.x != VISIBILITY_EMPTY;
+}
+
+#endif
@@ -196,17 +196,48 @@ bool SelectVulkanPhysicalDevice(const VkInstance& vkInstance, const std::vector<
     return true;
 }
 
+// For optional extensions, enabled only when the selected physical device supports them.
+bool IsDeviceExtensionSupported(const VkPhysicalDevice& vkPhysicalDevice, const char* extensionName)
+{
+    uint32_t supportedDeviceExtensionCount = 0U;
+    vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, nullptr, &supportedDeviceExtensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> supportedDeviceExtensions(supportedDeviceExtensionCount);
+    vkEnumerateDeviceExtensionProperties(vkPhysicalDevice, nullptr, &supportedDeviceExtensionCount, supportedDeviceExtensions.data());
+
+    return std::ranges::any_of(supportedDeviceExtensions,
+                               [&](const VkExtensionProperties& deviceExtension)
+                               {
+                                   return strcmp(deviceExtension.extensionName, extensionName) == 0; // NOLINT
+                               });
+}
+
 bool CreateVulkanLogicalDevice(const VkPhysicalDevice&         vkPhysicalDevice,
                                const std::vector<const char*>& requiredExtensions,
                                uint32_t                        vkGraphicsQueueIndex,
+                               uint32_t                        vkTransferQueueIndex,
                                VkDevice&                       vkLogicalDevice)
 {
     float graphicsQueuePriority = 1.0;
+    float transferQueuePriority = 0.5;
+
+    std::vector<VkDeviceQueueCreateInfo> vkQueueCreateInfos;
 
     VkDeviceQueueCreateInfo vkGraphicsQueueCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
     vkGraphicsQueueCreateInfo.queueFamilyIndex        = vkGraphicsQueueIndex;
     vkGraphicsQueueCreateInfo.queueCount              = 1U;
     vkGraphicsQueueCreateInfo.pQueuePriorities        = &graphicsQueuePriority;
+    vkQueueCreateInfos.push_back(vkGraphicsQueueCreateInfo);
+
+    // Dedicated upload queue, if the device exposes one.
+    if (vkTransferQueueIndex != vkGraphicsQueueIndex)
+    {
+        VkDeviceQueueCreateInfo vkTransferQueueCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+        vkTransferQueueCreateInfo.queueFamilyIndex        = vkTransferQueueIndex;
+        vkTransferQueueCreateInfo.queueCount              = 1U;
+        vkTransferQueueCreateInfo.pQueuePriorities        = &transferQueuePriority;
+        vkQueueCreateInfos.push_back(vkTransferQueueCreateInfo);
+    }
 
     VkPhysicalDeviceDescriptorIndexingFeaturesEXT        descriptorIndexing = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
     VkPhysicalDeviceFragmentShaderBarycentricFeaturesKHR baryFeature = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADER_BARYCENTRIC_FEATURES_KHR };
@@ -255,10 +286,14 @@ bool CreateVulkanLogicalDevice(const VkPhysicalDevice&         vkPhysicalDevice,
             return false;
     }
 
+    // The bindless material images are re-written while the set is bound (see ResourceRegistry).
+    if (vulkan12Features.descriptorBindingSampledImageUpdateAfterBind != VK_TRUE || vulkan12Features.descriptorBindingPartiallyBound != VK_TRUE)
+        return false;
+
     VkDeviceCreateInfo vkLogicalDeviceCreateInfo      = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
     vkLogicalDeviceCreateInfo.pNext                   = &vulkan10Features;
-    vkLogicalDeviceCreateInfo.pQueueCreateInfos       = &vkGraphicsQueueCreateInfo;
-    vkLogicalDeviceCreateInfo.queueCreateInfoCount    = 1U;
+    vkLogicalDeviceCreateInfo.pQueueCreateInfos       = vkQueueCreateInfos.data();
+    vkLogicalDeviceCreateInfo.queueCreateInfoCount    = static_cast<uint32_t>(vkQueueCreateInfos.size());
     vkLogicalDeviceCreateInfo.enabledExtensionCount   = static_cast<uint32_t>(requiredExtensions.size());
     vkLogicalDeviceCreateInfo.ppEnabledExtensionNames = requiredExtensions.data();
 
@@ -334,9 +369,13 @@ void SetDefaultRenderState(VkCommandBuffer commandBuffer)
     vkCmdSetPrimitiveTopologyEXT(commandBuffer, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 }
 
-bool GetVulkanQueueIndices(const VkInstance& vkInstance, const VkPhysicalDevice& vkPhysicalDevice, uint32_t& vkQueueIndexGraphics)
+bool GetVulkanQueueIndices(const VkInstance&       vkInstance,
+                           const VkPhysicalDevice& vkPhysicalDevice,
+                           uint32_t&               vkQueueIndexGraphics,
+                           uint32_t&               vkQueueIndexTransfer)
 {
     vkQueueIndexGraphics = UINT_MAX;
+    vkQueueIndexTransfer = UINT_MAX;
 
     uint32_t queueFamilyCount = 0U;
     vkGetPhysicalDeviceQueueFamilyProperties(vkPhysicalDevice, &queueFamilyCount, nullptr);
@@ -357,6 +396,25 @@ bool GetVulkanQueueIndices(const VkInstance& vkInstance, const VkPhysicalDevice&
         break;
     }
 
+    // Prefer a transfer-only family (copy engine), otherwise an async compute family, otherwise share the graphics queue.
+    for (uint32_t queueFamilyIndex = 0; queueFamilyIndex < queueFamilyCount; queueFamilyIndex++)
+    {
+        const auto& properties = queueFamilyProperties[queueFamilyIndex];
+
+        if ((properties.queueFlags & VK_QUEUE_TRANSFER_BIT) == 0U || (properties.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0U)
+            continue;
+
+        // Image copies are split into bands of rows, which requires a texel granular family.
+        if (properties.minImageTransferGranularity.width == 0U || properties.minImageTransferGranularity.height == 0U)
+            continue;
+
+        if (vkQueueIndexTransfer == UINT_MAX || (properties.queueFlags & VK_QUEUE_COMPUTE_BIT) == 0U)
+            vkQueueIndexTransfer = queueFamilyIndex;
+    }
+
+    if (vkQueueIndexTransfer == UINT_MAX)
+        vkQueueIndexTransfer = vkQueueIndexGraphics;
+
     return vkQueueIndexGraphics != UINT_MAX;
 }
 
@@ -380,7 +438,9 @@ void VulkanColorImageBarrier(VkCommandBuffer       vkCommand,
                              VkAccessFlags2        vkAccessSrc,
                              VkAccessFlags2        vkAccessDst,
                              VkPipelineStageFlags2 vkStageSrc,
-                             VkPipelineStageFlags2 vkStageDst)
+                             VkPipelineStageFlags2 vkStageDst,
+                             uint32_t              vkBaseMipLevel,
+                             uint32_t              vkMipLevelCount)
 {
     VkImageMemoryBarrier2 vkImageBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
     {
@@ -393,7 +453,7 @@ void VulkanColorImageBarrier(VkCommandBuffer       vkCommand,
         vkImageBarrier.dstStageMask        = vkStageDst;
         vkImageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         vkImageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        vkImageBarrier.subresourceRange    = { VK_IMAGE_ASPECT_COLOR_BIT, 0U, 1U, 0U, 1U };
+        vkImageBarrier.subresourceRange    = { VK_IMAGE_ASPECT_COLOR_BIT, vkBaseMipLevel, vkMipLevelCount, 0U, VK_REMAINING_ARRAY_LAYERS };
     }
 
     VkDependencyInfo vkDependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
@@ -405,6 +465,29 @@ void VulkanColorImageBarrier(VkCommandBuffer       vkCommand,
     vkCmdPipelineBarrier2(vkCommand, &vkDependencyInfo);
 }
 
+void VulkanMemoryBarrier(VkCommandBuffer       vkCommand,
+                         VkAccessFlags2        vkAccessSrc,
+                         VkAccessFlags2        vkAccessDst,
+                         VkPipelineStageFlags2 vkStageSrc,
+                         VkPipelineStageFlags2 vkStageDst)
+{
+    VkMemoryBarrier2 vkMemoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    {
+        vkMemoryBarrier.srcAccessMask = vkAccessSrc;
+        vkMemoryBarrier.dstAccessMask = vkAccessDst;
+        vkMemoryBarrier.srcStageMask  = vkStageSrc;
+        vkMemoryBarrier.dstStageMask  = vkStageDst;
+    }
+
+    VkDependencyInfo vkDependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    {
+        vkDependencyInfo.memoryBarrierCount = 1U;
+        vkDependencyInfo.pMemoryBarriers    = &vkMemoryBarrier;
+    }
+
+    vkCmdPipelineBarrier2(vkCommand, &vkDependencyInfo);
+}
+
 void DebugLabelImageResource(RenderContext* pRenderContext, const Image& imageResource, const char* labelName)
 {
 #ifdef USE_VK_LABELS
@@ -469,7 +552,7 @@ void SingleShotCommandBegin(RenderContext* pRenderContext, VkCommandBuffer& vkCo
     Check(vkBeginCommandBuffer(vkCommandBuffer, &vkCommandsBeginInfo), "Failed to begin recording commands");
 }
 
-void SingleShotCommandEnd(RenderContext* pRenderContext, VkCommandBuffer& vkCommandBuffer)
+void SingleShotCommandEnd(RenderContext* pRenderContext, VkCommandBuffer& vkCommandBuffer, VkCommandPool vkCommandPool)
 {
     Check(vkEndCommandBuffer(vkCommandBuffer), "Failed to end recording commands");
 
@@ -483,11 +566,105 @@ void SingleShotCommandEnd(RenderContext* pRenderContext, VkCommandBuffer& vkComm
 
     Check(vkQueueSubmit(pRenderContext->GetCommandQueue(), 1U, &vkSubmitInfo, VK_NULL_HANDLE), "Failed to submit commands to the graphics queue.");
 
-    // Wait for the commands to complete.
+    // Wait for the commands to complete (only this queue, the lock is held anyway).
     // -----------------------------------------------------
-    Check(vkDeviceWaitIdle(pRenderContext->GetDevice()), "Failed to wait for commands to finish dispatching.");
+    Check(vkQueueWaitIdle(pRenderContext->GetCommandQueue()), "Failed to wait for commands to finish dispatching.");
+
+    vkFreeCommandBuffers(pRenderContext->GetDevice(),
+                         vkCommandPool != VK_NULL_HANDLE ? vkCommandPool : pRenderContext->GetCommandPool(),
+                         1U,
+                         &vkCommandBuffer);
 }
 
+void VulkanGenerateMips(VkCommandBuffer vkCommand, const MipGeneration& mipGeneration)
+{
+    auto GetMipOffset = [&](uint32_t mipLevel)
+    {
+        return VkOffset3D { static_cast<int32_t>(std::max(mipGeneration.extent.width >> mipLevel, 1U)),
+                            static_cast<int32_t>(std::max(mipGeneration.extent.height >> mipLevel, 1U)),
+                            1 };
+    };
+
+    // The other levels are never written by the upload queue, their contents start out undefined.
+    if (mipGeneration.mipLevels > 1U)
+    {
+        VulkanColorImageBarrier(vkCommand,
+                                mipGeneration.image,
+                                VK_IMAGE_LAYOUT_UNDEFINED,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_ACCESS_2_NONE,
+                                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                VK_PIPELINE_STAGE_2_NONE,
+                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                1U,
+                                mipGeneration.mipLevels - 1U);
+    }
+
+    // Each level is filtered from the previous one (linear filtering of sRGB formats happens in linear space).
+    for (uint32_t mipLevel = 1U; mipLevel < mipGeneration.mipLevels; mipLevel++)
+    {
+        VkImageBlit vkImageBlit = {};
+        {
+            vkImageBlit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel - 1U, 0U, 1U };
+            vkImageBlit.srcOffsets[1]  = GetMipOffset(mipLevel - 1U);
+            vkImageBlit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0U, 1U };
+            vkImageBlit.dstOffsets[1]  = GetMipOffset(mipLevel);
+        }
+
+        vkCmdBlitImage(vkCommand,
+                       mipGeneration.image,
+                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       mipGeneration.image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1U,
+                       &vkImageBlit,
+                       VK_FILTER_LINEAR);
+
+        VulkanColorImageBarrier(vkCommand,
+                                mipGeneration.image,
+                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                VK_ACCESS_2_TRANSFER_READ_BIT,
+                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                mipLevel,
+                                1U);
+    }
+
+    VulkanColorImageBarrier(vkCommand,
+                            mipGeneration.image,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_ACCESS_2_SHADER_READ_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                            0U,
+                            mipGeneration.mipLevels);
+}
+
+uint32_t GetMipChainLevels(VkExtent3D extent) { return static_cast<uint32_t>(std::bit_width(std::max(extent.width, extent.height))); }
+
+VkDeviceSize GetMipChainSize(VkExtent3D extent, VkFormat format, VkDeviceSize bytesPerBlock, uint32_t mipLevels)
+{
+    auto blockDim = GetFormatBlockDim(format);
+
+    VkDeviceSize size = 0U;
+
+    for (uint32_t mipLevel = 0U; mipLevel < mipLevels; mipLevel++)
+    {
+        auto blocksWide = (std::max(extent.width >> mipLevel, 1U) + blockDim - 1U) / blockDim;
+        auto blocksHigh = (std::max(extent.height >> mipLevel, 1U) + blockDim - 1U) / blockDim;
+
+        size += bytesPerBlock * blocksWide * blocksHigh;
+    }
+
+    return size;
+}
+
+uint32_t GetFormatBlockDim(VkFormat format) { return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK ? 4U : 1U; }
+
 void InitializeUserInterface(RenderContext* pRenderContext)
 {
     IMGUI_CHECKVERSION();
@@ -599,35 +776,24 @@ void BindGraphicsShaders(VkCommandBuffer cmd, VkShaderEXT vkVertexShader, VkShad
     vkCmdBindShadersEXT(cmd, static_cast<uint32_t>(vkGraphicsShaderStageBits.size()), vkGraphicsShaderStageBits.data(), vkGraphicsShaders.data());
 }
 
-// Local utility for emplacing an alpha value every 12 bytes.
-void InterleaveImageAlpha(stbi_uc** pImageData, int& width, int& height, int& channels)
+// Current usage and budget of the device local heaps (VK_EXT_memory_budget, estimated by VMA otherwise).
+void GetDeviceMemoryBudget(VmaAllocator vmaAllocator, uint64_t& usageBytes, uint64_t& budgetBytes)
 {
-    auto* pAlphaImage = new unsigned char[width * height * 4U]; // NOLINT
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+    vmaGetMemoryProperties(vmaAllocator, &pMemoryProperties);
 
-    for (int i = 0; i < width * height; ++i)
-    {
-        switch (channels)
-        {
-            case 1U:
-                pAlphaImage[i * 4 + 0] = (*pImageData)[i * channels + 0]; // NOLINT R
-                pAlphaImage[i * 4 + 1] = (*pImageData)[i * channels + 0]; // NOLINT G
-                pAlphaImage[i * 4 + 2] = (*pImageData)[i * channels + 0]; // NOLINT B
-                break;
-            case 3U:
-                pAlphaImage[i * 4 + 0] = (*pImageData)[i * channels + 0]; // NOLINT R
-                pAlphaImage[i * 4 + 1] = (*pImageData)[i * channels + 1]; // NOLINT G
-                pAlphaImage[i * 4 + 2] = (*pImageData)[i * channels + 2]; // NOLINT B
-                break;
-        }
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets {};
+    vmaGetHeapBudgets(vmaAllocator, heapBudgets.data());
 
-        pAlphaImage[i * 4 + 3] = 255; // NOLINT A (fully opaque)
-    }
+    usageBytes  = 0U;
+    budgetBytes = 0U;
 
-    // Free the original image memory
-    stbi_image_free(*pImageData);
-
-    *pImageData = pAlphaImage;
+    for (uint32_t heapIndex = 0U; heapIndex < pMemoryProperties->memoryHeapCount; heapIndex++)
+    {
+        if ((pMemoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0U)
+            continue;
 
-    // There is now an alpha channel.
-    channels = 4U;
+        usageBytes += heapBudgets[heapIndex].usage;
+        budgetBytes += heapBudgets[heapIndex].budget;
+    }
 }
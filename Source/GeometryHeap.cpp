@@ -0,0 +1,142 @@
+#include <Common.h>
+#include <GeometryHeap.h>
+#include <MeshProcessing.h>
+#include <RenderContext.h>
+
+// Meshlet and instance ranges are addressed by element, their offsets must stay multiples of the element size.
+static_assert(sizeof(Meshlet) == 64U && sizeof(GfMatrix4f) == 64U);
+
+// Capacity, usage and range alignment of each stream heap.
+struct GeometryStreamDesc
+{
+    const char*        name;
+    VkDeviceSize       size;
+    VkBufferUsageFlags usage;
+    VkDeviceSize       alignment;
+};
+
+static constexpr std::array<GeometryStreamDesc, static_cast<uint32_t>(GeometryStream::Count)> kGeometryStreamDescs = {
+    { { "GeometryHeap - Index", kGeometryHeapIndexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 4U },
+      { "GeometryHeap - Position", kGeometryHeapPositionBytes, 0x0, 16U },
+      { "GeometryHeap - TexCoord", kGeometryHeapTexCoordBytes, 0x0, 16U },
+      { "GeometryHeap - Meshlet", kGeometryHeapMeshletBytes, 0x0, sizeof(Meshlet) },
+      { "GeometryHeap - Instance", kGeometryHeapInstanceBytes, 0x0, sizeof(GfMatrix4f) } }
+};
+
+GeometryHeap::GeometryHeap(RenderContext* pRenderContext) : m_RenderContext(pRenderContext)
+{
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_RenderContext->GetDevicePhysical(), &physicalDeviceProperties);
+
+    // The streams are written by the upload queue and read by the graphics queue without ownership transfers
+    // (the frame already waits on the upload timeline).
+    std::array<uint32_t, 2> queueFamilyIndices = { m_RenderContext->GetCommandQueueIndex(), m_RenderContext->GetTransferQueueIndex() };
+
+    for (uint32_t streamIndex = 0U; streamIndex < static_cast<uint32_t>(GeometryStream::Count); streamIndex++)
+    {
+        const auto& streamDesc = kGeometryStreamDescs[streamIndex];
+
+        // Each stream is bound as a single storage buffer.
+        auto size = std::min(streamDesc.size, static_cast<VkDeviceSize>(physicalDeviceProperties.limits.maxStorageBufferRange));
+
+        if (size < streamDesc.size)
+            spdlog::warn("{} clamped to the device storage buffer range ({} MB).", streamDesc.name, size >> 20U);
+
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        {
+            bufferInfo.size  = size;
+            bufferInfo.usage = streamDesc.usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+            if (m_RenderContext->HasDedicatedTransferQueue())
+            {
+                bufferInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+                bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+                bufferInfo.pQueueFamilyIndices   = queueFamilyIndices.data();
+            }
+        }
+
+        VmaAllocationCreateInfo allocInfo = {};
+        {
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+        }
+
+        auto& buffer = m_Buffers[streamIndex];
+
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(), &bufferInfo, &allocInfo, &buffer.buffer, &buffer.bufferAllocation, nullptr),
+              "Failed to create geometry heap memory.");
+
+        buffer.bufferInfo = bufferInfo;
+
+        DebugLabelBufferResource(m_RenderContext, buffer, streamDesc.name);
+
+        // Suballocator over the buffer (TLSF is the default virtual block algorithm).
+        VmaVirtualBlockCreateInfo blockInfo = {};
+        {
+            blockInfo.size = size;
+        }
+        Check(vmaCreateVirtualBlock(&blockInfo, &m_Blocks[streamIndex]), "Failed to create geometry heap allocator.");
+    }
+}
+
+GeometryAllocation GeometryHeap::Allocate(GeometryStream stream, VkDeviceSize size)
+{
+    GeometryAllocation allocation {};
+
+    if (size == 0U)
+        return allocation;
+
+    auto streamIndex = static_cast<uint32_t>(stream);
+
+    VmaVirtualAllocationCreateInfo allocInfo = {};
+    {
+        allocInfo.size      = size;
+        allocInfo.alignment = kGeometryStreamDescs[streamIndex].alignment;
+    }
+
+    if (vmaVirtualAllocate(m_Blocks[streamIndex], &allocInfo, &allocation.allocation, &allocation.offset) != VK_SUCCESS)
+    {
+        spdlog::critical("{} exhausted, failed to allocate {} bytes.", kGeometryStreamDescs[streamIndex].name, size);
+        Check(false, "Geometry heap exhausted.");
+    }
+
+    allocation.size = size;
+
+    return allocation;
+}
+
+void GeometryHeap::Free(GeometryStream stream, GeometryAllocation* pAllocation)
+{
+    if (pAllocation->allocation == VK_NULL_HANDLE)
+        return;
+
+    vmaVirtualFree(m_Blocks[static_cast<uint32_t>(stream)], pAllocation->allocation);
+
+    *pAllocation = {};
+}
+
+void GeometryHeap::ReportStatistics()
+{
+    for (uint32_t streamIndex = 0U; streamIndex < static_cast<uint32_t>(GeometryStream::Count); streamIndex++)
+    {
+        VmaStatistics statistics;
+        vmaGetVirtualBlockStatistics(m_Blocks[streamIndex], &statistics);
+
+        spdlog::info("{} | Ranges: {} | Used: {} / {} MB",
+                     kGeometryStreamDescs[streamIndex].name,
+                     statistics.allocationCount,
+                     statistics.allocationBytes >> 20U,
+                     m_Buffers[streamIndex].bufferInfo.size >> 20U);
+    }
+}
+
+void GeometryHeap::Destroy()
+{
+    for (uint32_t streamIndex = 0U; streamIndex < static_cast<uint32_t>(GeometryStream::Count); streamIndex++)
+    {
+        vmaClearVirtualBlock(m_Blocks[streamIndex]);
+        vmaDestroyVirtualBlock(m_Blocks[streamIndex]);
+
+        vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_Buffers[streamIndex].buffer, m_Buffers[streamIndex].bufferAllocation);
+    }
+}
@@ -0,0 +1,213 @@
+#include <Common.h>
+#include <HostArena.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+// Granularity of committed memory (a multiple of the 2 MB huge page size).
+constexpr uint64_t kHostArenaChunkBytes = 64LL * 1024 * 1024;
+
+// Thread local bump blocks, allocations larger than a quarter block go straight to the shared cursor.
+constexpr uint64_t kHostArenaBlockBytes     = 4LL * 1024 * 1024;
+constexpr uint64_t kHostArenaDirectMinBytes = kHostArenaBlockBytes / 4U;
+
+constexpr uint64_t kHostArenaAlignment = 16U;
+
+// Virtual Memory Utility
+// ------------------------------------------------------------
+
+static std::byte* ReserveAddressSpace(uint64_t size)
+{
+#ifdef _WIN32
+    return static_cast<std::byte*>(VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS));
+#else
+    void* pData = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return pData != MAP_FAILED ? static_cast<std::byte*>(pData) : nullptr;
+#endif
+}
+
+static void ReleaseAddressSpace(std::byte* pData, uint64_t size)
+{
+#ifdef _WIN32
+    VirtualFree(pData, 0U, MEM_RELEASE);
+#else
+    munmap(pData, size);
+#endif
+}
+
+static bool CommitMemory(std::byte* pData, uint64_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(pData, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    if (mprotect(pData, size, PROT_READ | PROT_WRITE) != 0)
+        return false;
+
+    // Staging data is streamed through linearly, back it with transparent huge pages where available.
+    madvise(pData, size, MADV_HUGEPAGE);
+    return true;
+#endif
+}
+
+static void DecommitMemory(std::byte* pData, uint64_t size)
+{
+#ifdef _WIN32
+    VirtualFree(pData, size, MEM_DECOMMIT);
+#else
+    madvise(pData, size, MADV_DONTNEED);
+    mprotect(pData, size, PROT_NONE);
+#endif
+}
+
+// Implementation
+// ------------------------------------------------------------
+
+HostArena::HostArena(uint64_t reserveBytes) : m_ReserveBytes((reserveBytes + kHostArenaChunkBytes - 1U) / kHostArenaChunkBytes * kHostArenaChunkBytes)
+{
+    m_pBase = ReserveAddressSpace(m_ReserveBytes);
+    Check(m_pBase != nullptr, "Failed to reserve host arena address space.");
+
+    m_Chunks = std::make_unique<Chunk[]>(m_ReserveBytes / kHostArenaChunkBytes);
+}
+
+HostArena::~HostArena()
+{
+    if (m_pBase != nullptr)
+        ReleaseAddressSpace(m_pBase, m_ReserveBytes);
+}
+
+void* HostArena::Allocate(uint64_t size)
+{
+    if (size == 0U)
+        return nullptr;
+
+    size = (size + kHostArenaAlignment - 1U) & ~(kHostArenaAlignment - 1U);
+
+    uint64_t offset = 0U;
+
+    if (size >= kHostArenaDirectMinBytes)
+    {
+        offset = m_Cursor.fetch_add(size);
+        Check(offset + size <= m_ReserveBytes, "Host arena address space exhausted.");
+    }
+    else
+    {
+        auto& block = m_ThreadBlocks.local();
+
+        if (block.offset + size > block.end)
+        {
+            RetireBlock(&block);
+
+            // The block itself keeps its chunks committed until the thread moves on to the next one.
+            block.offset = m_Cursor.fetch_add(kHostArenaBlockBytes);
+            block.end    = block.offset + kHostArenaBlockBytes;
+            Check(block.end <= m_ReserveBytes, "Host arena address space exhausted.");
+
+            AddReference(block.offset, kHostArenaBlockBytes);
+        }
+
+        offset        = block.offset;
+        block.offset += size;
+    }
+
+    AddReference(offset, size);
+
+    return m_pBase + offset;
+}
+
+void HostArena::Release(const void* pData, uint64_t size)
+{
+    if (pData == nullptr || size == 0U)
+        return;
+
+    size = (size + kHostArenaAlignment - 1U) & ~(kHostArenaAlignment - 1U);
+
+    RemoveReference(static_cast<uint64_t>(static_cast<const std::byte*>(pData) - m_pBase), size);
+}
+
+void HostArena::Reset()
+{
+    for (auto& block : m_ThreadBlocks)
+        RetireBlock(&block);
+
+    // Rewinding over a live allocation would hand its memory out a second time.
+    auto chunkCount = (m_Cursor.load() + kHostArenaChunkBytes - 1U) / kHostArenaChunkBytes;
+
+    for (uint64_t chunkIndex = 0U; chunkIndex < std::min(chunkCount, m_ReserveBytes / kHostArenaChunkBytes); chunkIndex++)
+        Check(m_Chunks[chunkIndex].referenceCount.load() == 0U, "Host arena reset while allocations are still alive.");
+
+    m_Cursor.store(0U);
+}
+
+void HostArena::AddReference(uint64_t offset, uint64_t size)
+{
+    for (auto chunkIndex = offset / kHostArenaChunkBytes; chunkIndex <= (offset + size - 1U) / kHostArenaChunkBytes; chunkIndex++)
+    {
+        auto& chunk = m_Chunks[chunkIndex];
+
+        // A chunk referenced by someone else can not be decommitted, it only needs to be waited on if still being committed.
+        if (chunk.referenceCount.fetch_add(1U) != 0U && chunk.committed.load())
+            continue;
+
+        std::lock_guard lock(m_ChunkMutex);
+
+        if (chunk.committed.load())
+            continue;
+
+        Check(CommitMemory(m_pBase + chunkIndex * kHostArenaChunkBytes, kHostArenaChunkBytes), "Failed to commit host arena memory.");
+
+        chunk.committed.store(true);
+
+        auto committedBytes = m_CommittedBytes.fetch_add(kHostArenaChunkBytes) + kHostArenaChunkBytes;
+
+        auto peakCommittedBytes = m_PeakCommittedBytes.load();
+        while (committedBytes > peakCommittedBytes && !m_PeakCommittedBytes.compare_exchange_weak(peakCommittedBytes, committedBytes)) {}
+    }
+}
+
+void HostArena::RemoveReference(uint64_t offset, uint64_t size)
+{
+    for (auto chunkIndex = offset / kHostArenaChunkBytes; chunkIndex <= (offset + size - 1U) / kHostArenaChunkBytes; chunkIndex++)
+    {
+        auto& chunk = m_Chunks[chunkIndex];
+
+        if (chunk.referenceCount.fetch_sub(1U) != 1U)
+            continue;
+
+        std::lock_guard lock(m_ChunkMutex);
+
+        // Another allocation may have landed in the chunk in the meantime.
+        if (!chunk.committed.load() || chunk.referenceCount.load() != 0U)
+            continue;
+
+        // Publish the decommit before checking again, a concurrent AddReference either observes it (and waits on the lock)
+        // or its reference is observed here.
+        chunk.committed.store(false);
+
+        if (chunk.referenceCount.load() != 0U)
+        {
+            chunk.committed.store(true);
+            continue;
+        }
+
+        DecommitMemory(m_pBase + chunkIndex * kHostArenaChunkBytes, kHostArenaChunkBytes);
+
+        m_CommittedBytes.fetch_sub(kHostArenaChunkBytes);
+    }
+}
+
+void HostArena::RetireBlock(ThreadBlock* pBlock)
+{
+    if (pBlock->end == 0U)
+        return;
+
+    RemoveReference(pBlock->end - kHostArenaBlockBytes, kHostArenaBlockBytes);
+
+    *pBlock = {};
+}
@@ -0,0 +1,284 @@
+#include <Common.h>
+#include <ImageLoader.h>
+#include <PixelConversion.h>
+
+#include <cstddef>
+
+ImageLoader::ImageLoader(const std::string& resolvedPath, const ImageLoadOptions& options) : m_Format(VK_FORMAT_UNDEFINED)
+{
+    auto extension = std::filesystem::path(resolvedPath).extension().string();
+
+    if (extension == ".dds")
+    {
+        Check(dds::readFile(resolvedPath, &m_DDSImage) == 0U, "Failed to load DDS image to memory.");
+
+        // Read out the image data.
+        m_Width  = static_cast<int>(m_DDSImage.width);
+        m_Height = static_cast<int>(m_DDSImage.height);
+
+        // Extract pointer to image data.
+        m_Data = m_DDSImage.mipmaps.front().data();
+
+        // Pre-computed levels are uploaded as-is.
+        m_MipLevels = static_cast<uint32_t>(m_DDSImage.mipmaps.size());
+
+        // Array layers / cube faces are stored one after another, each with its full mip chain.
+        size_t layerBytes = 0U;
+
+        for (const auto& mipmap : m_DDSImage.mipmaps)
+            layerBytes += mipmap.size();
+
+        m_ArrayLayers = std::max(static_cast<uint32_t>(m_DDSImage.data.size() / std::max(layerBytes, static_cast<size_t>(1U))), 1U);
+        m_IsCubemap   = m_ArrayLayers == m_DDSImage.arraySize * 6U;
+
+        for (uint32_t layer = 0U; layer < m_ArrayLayers; layer++)
+        {
+            for (const auto& mipmap : m_DDSImage.mipmaps)
+                m_Levels.emplace_back(reinterpret_cast<const std::byte*>(mipmap.data()) + layer * layerBytes, mipmap.size()); // NOLINT
+        }
+
+        // Extract the format.
+        m_Format = dds::getVulkanFormat(m_DDSImage.format, m_DDSImage.supportsAlpha);
+
+        // Size of a texel block (4x4 texels for block compressed formats).
+        auto blockDim = GetFormatBlockDim(m_Format);
+
+        m_BytesPerPixel = (dds::getBitsPerPixel(m_DDSImage.format) * blockDim * blockDim) >> 3U;
+    }
+#ifdef USE_KTX
+    else if (extension == ".ktx2")
+    {
+        LoadKTX2(resolvedPath, options);
+    }
+#endif
+    else
+    {
+        std::ifstream file(resolvedPath, std::ios::binary | std::ios::ate);
+
+        std::vector<std::byte> fileData(file.is_open() ? static_cast<size_t>(file.tellg()) : 0U);
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+        LoadSTB(fileData, options);
+    }
+}
+
+ImageLoader::ImageLoader(std::span<const std::byte> fileData, const ImageLoadOptions& options) : m_Format(VK_FORMAT_UNDEFINED)
+{
+    LoadSTB(fileData, options);
+}
+
+ImageLoader::~ImageLoader()
+{
+    if (m_pSTBData != nullptr)
+        stbi_image_free(m_pSTBData);
+
+#ifdef USE_KTX
+    if (m_pKTXTexture != nullptr)
+        ktxTexture_Destroy(ktxTexture(m_pKTXTexture));
+#endif
+}
+
+#ifdef USE_KTX
+void ImageLoader::LoadKTX2(const std::string& resolvedPath, const ImageLoadOptions& options)
+{
+    PROFILE_START("Load KTX2 Image");
+
+    // Supercompressed (zstd / zlib) levels are inflated while loading.
+    if (ktxTexture2_CreateFromNamedFile(resolvedPath.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &m_pKTXTexture) != KTX_SUCCESS)
+    {
+        spdlog::warn("Failed to load KTX2 image: {}", resolvedPath);
+
+        PROFILE_END;
+        return;
+    }
+
+    // Basis Universal (ETC1S / UASTC) payloads are transcoded to a block compressed format if the device can sample
+    // them, or to RGBA otherwise. Color data goes to BC7 to keep it in sRGB.
+    if (ktxTexture2_NeedsTranscoding(m_pKTXTexture))
+    {
+        auto componentCount = ktxTexture2_GetNumComponents(m_pKTXTexture);
+
+        auto targetFormat = KTX_TTF_RGBA32;
+
+        if (options.supportsBlockCompression)
+        {
+            if (!options.isColor && componentCount == 1U)
+                targetFormat = KTX_TTF_BC4_R;
+            else if (!options.isColor && componentCount == 2U)
+                targetFormat = KTX_TTF_BC5_RG;
+            else
+                targetFormat = KTX_TTF_BC7_RGBA;
+        }
+
+        if (ktxTexture2_TranscodeBasis(m_pKTXTexture, targetFormat, 0) != KTX_SUCCESS)
+        {
+            spdlog::warn("Failed to transcode KTX2 image: {}", resolvedPath);
+
+            PROFILE_END;
+            return;
+        }
+    }
+
+    auto* pTexture = ktxTexture(m_pKTXTexture);
+
+    m_Width         = static_cast<int>(pTexture->baseWidth);
+    m_Height        = static_cast<int>(pTexture->baseHeight);
+    m_Format        = static_cast<VkFormat>(m_pKTXTexture->vkFormat);
+    m_BytesPerPixel = ktxTexture_GetElementSize(pTexture);
+    m_MipLevels     = pTexture->numLevels;
+    m_ArrayLayers   = pTexture->numLayers * pTexture->numFaces;
+    m_IsCubemap     = pTexture->isCubemap;
+
+    for (uint32_t layer = 0U; layer < pTexture->numLayers; layer++)
+    {
+        for (uint32_t face = 0U; face < pTexture->numFaces; face++)
+        {
+            for (uint32_t mipLevel = 0U; mipLevel < m_MipLevels; mipLevel++)
+            {
+                ktx_size_t levelOffset = 0U;
+                ktxTexture_GetImageOffset(pTexture, mipLevel, layer, face, &levelOffset);
+
+                m_Levels.emplace_back(reinterpret_cast<const std::byte*>(ktxTexture_GetData(pTexture)) + levelOffset, ktxTexture_GetImageSize(pTexture, mipLevel)); // NOLINT
+            }
+        }
+    }
+
+    m_Data = m_Levels.front().data();
+
+    PROFILE_END;
+}
+#endif
+
+void ImageLoader::LoadSTB(std::span<const std::byte> fileData, const ImageLoadOptions& options)
+{
+    PROFILE_START("Load Image");
+
+    // The rest of the mip chain is generated on the device.
+    m_MipLevels = 1U;
+
+    const auto* pFileData    = reinterpret_cast<const stbi_uc*>(fileData.data());
+    auto        fileDataSize = static_cast<int>(fileData.size());
+
+    int channels = 0;
+
+    // High dynamic range images are stored as half floats (always with four channels).
+    if (stbi_is_hdr_from_memory(pFileData, fileDataSize) != 0)
+    {
+        auto* pFloatData = stbi_loadf_from_memory(pFileData, fileDataSize, &m_Width, &m_Height, &channels, 4);
+        m_pSTBData       = pFloatData;
+
+        if (pFloatData == nullptr)
+        {
+            PROFILE_END;
+            return;
+        }
+
+        auto channelCount = static_cast<size_t>(m_Width) * m_Height * 4U;
+
+        m_ConvertedData.resize(channelCount * sizeof(uint16_t));
+        ConvertFloatToHalf(pFloatData, reinterpret_cast<uint16_t*>(m_ConvertedData.data()), channelCount);
+
+        m_Data          = m_ConvertedData.data();
+        m_Format        = VK_FORMAT_R16G16B16A16_SFLOAT;
+        m_BytesPerPixel = 8U;
+
+        PROFILE_END;
+        return;
+    }
+
+    const auto* pTexels = static_cast<const uint8_t*>(nullptr);
+
+    // 16-bit images are narrowed to 8-bit.
+    if (stbi_is_16_bit_from_memory(pFileData, fileDataSize) != 0)
+    {
+        auto* pWideData = stbi_load_16_from_memory(pFileData, fileDataSize, &m_Width, &m_Height, &channels, 0);
+        m_pSTBData      = pWideData;
+
+        if (pWideData != nullptr)
+        {
+            auto channelCount = static_cast<size_t>(m_Width) * m_Height * channels;
+
+            m_ConvertedData.resize(channelCount);
+            ConvertUNorm16ToUNorm8(pWideData, reinterpret_cast<uint8_t*>(m_ConvertedData.data()), channelCount);
+
+            pTexels = reinterpret_cast<const uint8_t*>(m_ConvertedData.data());
+        }
+    }
+    else
+    {
+        pTexels    = stbi_load_from_memory(pFileData, fileDataSize, &m_Width, &m_Height, &channels, 0);
+        m_pSTBData = const_cast<uint8_t*>(pTexels); // NOLINT
+    }
+
+    if (pTexels == nullptr)
+    {
+        PROFILE_END;
+        return;
+    }
+
+    auto texelCount = static_cast<size_t>(m_Width) * m_Height;
+
+    // sRGB only applies to the color channels, grey + alpha color images are expanded to RGBA to keep alpha linear.
+    auto preserveChannels = options.preserveChannels && (channels == 1 || (channels == 2 && !options.isColor));
+
+    if (channels == 4 || preserveChannels)
+    {
+        m_Data = pTexels;
+    }
+    else
+    {
+        // Expanded into a separate buffer, the 16-bit narrowing buffer cannot be converted in place.
+        std::vector<std::byte> expandedData(texelCount * 4U);
+
+        switch (channels)
+        {
+            case 1: ConvertGrayToRGBA(pTexels, reinterpret_cast<uint8_t*>(expandedData.data()), texelCount); break;
+            case 2: ConvertGrayAlphaToRGBA(pTexels, reinterpret_cast<uint8_t*>(expandedData.data()), texelCount); break;
+            case 3: ConvertRGBToRGBA(pTexels, reinterpret_cast<uint8_t*>(expandedData.data()), texelCount); break;
+            default: Check(false, "Unsupported image channel count."); break;
+        }
+
+        m_ConvertedData = std::move(expandedData);
+        m_Data          = m_ConvertedData.data();
+
+        channels = 4;
+    }
+
+    // Replicate preserved grey into the color channels.
+    if (channels == 1 && options.isColor)
+        m_Components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE };
+
+    static constexpr std::array<VkFormat, 4> kColorFormats    = { VK_FORMAT_R8_SRGB, VK_FORMAT_R8G8_SRGB, VK_FORMAT_R8G8B8_SRGB, VK_FORMAT_R8G8B8A8_SRGB };
+    static constexpr std::array<VkFormat, 4> kNonColorFormats = { VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM };
+
+    m_Format        = options.isColor ? kColorFormats.at(channels - 1) : kNonColorFormats.at(channels - 1);
+    m_BytesPerPixel = static_cast<uint32_t>(channels);
+
+    PROFILE_END;
+}
+
+void ImageLoader::CopyMipLevels(void* pDestination, uint32_t arrayLayers) const
+{
+    auto* pLevelDestination = static_cast<std::byte*>(pDestination);
+
+    VkExtent3D extent = { static_cast<uint32_t>(m_Width), static_cast<uint32_t>(m_Height), 1U };
+
+    for (uint32_t mipLevel = 0U; mipLevel < m_MipLevels; mipLevel++)
+    {
+        auto levelBytes = GetMipChainSize(extent, m_Format, m_BytesPerPixel, mipLevel + 1U) - GetMipChainSize(extent, m_Format, m_BytesPerPixel, mipLevel);
+
+        for (uint32_t layer = 0U; layer < arrayLayers; layer++)
+        {
+            const auto& level = m_Levels.empty() ? std::span<const std::byte>() : m_Levels[layer * m_MipLevels + mipLevel];
+
+            const void* pLevelSource = m_Levels.empty() ? m_Data : level.data();
+            auto        sourceBytes  = m_Levels.empty() ? levelBytes : std::min(static_cast<VkDeviceSize>(level.size()), levelBytes);
+
+            memcpy(pLevelDestination, pLevelSource, sourceBytes);
+
+            pLevelDestination += levelBytes; // NOLINT
+        }
+    }
+}
@@ -4,8 +4,43 @@
 // Limits
 // ---------------------------------------------------------
 
-constexpr uint64_t kHostBufferPoolMaxBytes = 512LL * 1024 * 1024;
-constexpr uint64_t kHostImagePoolMaxBytes  = 2048LL * 1024 * 1024;
+// Address space reserved for the host staging arenas (only committed on demand).
+constexpr uint64_t kHostBufferArenaReserveBytes = 256LL * 1024 * 1024 * 1024;
+constexpr uint64_t kHostImageArenaReserveBytes  = 256LL * 1024 * 1024 * 1024;
+
+constexpr uint32_t kMaxDrawItemUpdatesPerFrame = 4096U;
+
+// Draw item slots and instances per draw item (the visibility buffer encodes both indices in 16 bits, the all-ones
+// pattern is reserved for empty pixels).
+constexpr uint32_t kMaxDrawItems         = 1U << 16U;
+constexpr uint32_t kMaxDrawItemInstances = (1U << 16U) - 1U;
+
+// Material slots of the bindless material image array.
+constexpr uint32_t kMaxMaterials = 4096U;
+
+// Persistently mapped host -> device upload ring, submitted in batches of a few dozen megabytes.
+constexpr uint64_t kStagingRingBytes  = 256LL * 1024 * 1024;
+constexpr uint64_t kStagingBatchBytes = 32LL * 1024 * 1024;
+constexpr uint32_t kStagingBatchCount = 4U;
+
+// Device geometry heaps shared by every draw item (clamped to the device storage buffer range).
+constexpr uint64_t kGeometryHeapIndexBytes    = 512LL * 1024 * 1024;
+constexpr uint64_t kGeometryHeapPositionBytes = 256LL * 1024 * 1024;
+constexpr uint64_t kGeometryHeapTexCoordBytes = 128LL * 1024 * 1024;
+constexpr uint64_t kGeometryHeapMeshletBytes  = 64LL * 1024 * 1024;
+constexpr uint64_t kGeometryHeapInstanceBytes = 64LL * 1024 * 1024;
+
+// Material textures are evicted to host memory above this fraction of the device local heap budget (least recently
+// visible first), and restored once visible again while they fit below it.
+constexpr double   kDeviceMemoryBudgetUsage = 0.9;
+constexpr uint32_t kResidencyUpdateFrames   = 30U;
+constexpr uint32_t kResidencyIdleFrames     = 120U;
+
+// Material textures with a full host mip chain are streamed: first uploaded from the level no larger than the initial
+// resolution (log2, 64 texels), then refined to the level requested by the material feedback (uploading at most this
+// many bytes per residency update).
+constexpr uint32_t kStreamingInitialResolutionLog2 = 6U;
+constexpr uint64_t kStreamingUploadBytes           = 128LL * 1024 * 1024;
 
 // Logging + crash utility when an assertion fails.
 // ---------------------------------------------------------
@@ -142,6 +177,27 @@ struct Image
     VkImageCreateInfo imageInfo       = {};
 };
 
+// Mip chain of an uploaded image, generated (from the first level) once the graphics queue acquires it.
+// ---------------------------------------------------------
+
+struct MipGeneration
+{
+    VkImage    image;
+    VkExtent3D extent;
+    uint32_t   mipLevels;
+};
+
+// Stable reference to a draw item slot, invalidated once the slot is freed (and possibly re-used).
+// ---------------------------------------------------------
+
+struct DrawItemHandle
+{
+    uint32_t index      = UINT32_MAX;
+    uint32_t generation = 0U;
+
+    [[nodiscard]] inline bool IsValid() const { return index != UINT32_MAX; }
+};
+
 // Utility Functions.
 // ---------------------------------------------------------
 
@@ -153,22 +209,28 @@ bool CreateMeshDataDescriptorLayout(const VkDevice& vkLogicalDevice, VkDescripto
 
 bool SelectVulkanPhysicalDevice(const VkInstance& vkInstance, const std::vector<const char*>& requiredExtensions, VkPhysicalDevice& vkPhysicalDevice);
 
+bool IsDeviceExtensionSupported(const VkPhysicalDevice& vkPhysicalDevice, const char* extensionName);
+
 bool CreateVulkanLogicalDevice(const VkPhysicalDevice&         vkPhysicalDevice,
                                const std::vector<const char*>& requiredExtensions,
                                uint32_t                        vkGraphicsQueueIndex,
+                               uint32_t                        vkTransferQueueIndex,
                                VkDevice&                       vkLogicalDevice);
 
 bool LoadByteCode(const char* filePath, std::vector<char>& byteCode);
 
 void SetDefaultRenderState(VkCommandBuffer commandBuffer);
 
-bool GetVulkanQueueIndices(const VkInstance& vkInstance, const VkPhysicalDevice& vkPhysicalDevice, uint32_t& vkQueueIndexGraphics);
+bool GetVulkanQueueIndices(const VkInstance&       vkInstance,
+                           const VkPhysicalDevice& vkPhysicalDevice,
+                           uint32_t&               vkQueueIndexGraphics,
+                           uint32_t&               vkQueueIndexTransfer);
 
 bool CreateRenderingAttachments(RenderContext* pRenderContext, Image& colorAttachment, Image& depthAttachment);
 
 void SingleShotCommandBegin(RenderContext* pRenderContext, VkCommandBuffer& vkCommandBuffer, VkCommandPool vkCommandPool = VK_NULL_HANDLE);
 
-void SingleShotCommandEnd(RenderContext* pRenderContext, VkCommandBuffer& vkCommandBuffer);
+void SingleShotCommandEnd(RenderContext* pRenderContext, VkCommandBuffer& vkCommandBuffer, VkCommandPool vkCommandPool = VK_NULL_HANDLE);
 
 void NameVulkanObject(VkDevice vkLogicalDevice, VkObjectType vkObjectType, uint64_t vkObject, const std::string& vkObjectName);
 
@@ -183,7 +245,26 @@ void VulkanColorImageBarrier(VkCommandBuffer       vkCommand,
                              VkAccessFlags2        vkAccessSrc,
                              VkAccessFlags2        vkAccessDst,
                              VkPipelineStageFlags2 vkStageSrc,
-                             VkPipelineStageFlags2 vkStageDst);
+                             VkPipelineStageFlags2 vkStageDst,
+                             uint32_t              vkBaseMipLevel  = 0U,
+                             uint32_t              vkMipLevelCount = 1U);
+
+void VulkanMemoryBarrier(VkCommandBuffer       vkCommand,
+                         VkAccessFlags2        vkAccessSrc,
+                         VkAccessFlags2        vkAccessDst,
+                         VkPipelineStageFlags2 vkStageSrc,
+                         VkPipelineStageFlags2 vkStageDst);
+
+// Blit the mip chain down from the first level (left in transfer source layout), every level ends up shader readable.
+void VulkanGenerateMips(VkCommandBuffer vkCommand, const MipGeneration& mipGeneration);
+
+// Number of levels of a full mip chain, and the size of the first levels packed tightly (in texel blocks of the format).
+uint32_t GetMipChainLevels(VkExtent3D extent);
+
+VkDeviceSize GetMipChainSize(VkExtent3D extent, VkFormat format, VkDeviceSize bytesPerBlock, uint32_t mipLevels);
+
+// Width / height of the texel blocks of a format (4 for block compressed formats, 1 otherwise).
+uint32_t GetFormatBlockDim(VkFormat format);
 
 void InitializeUserInterface(RenderContext* pRenderContext);
 
@@ -191,6 +272,6 @@ void DrawUserInterface(RenderContext* pRenderContext, uint32_t swapChainImageInd
 
 void BindGraphicsShaders(VkCommandBuffer cmd, VkShaderEXT vkVertexShader, VkShaderEXT vkFragmentShader);
 
-void InterleaveImageAlpha(stbi_uc** pImageData, int& width, int& height, int& channels);
+void GetDeviceMemoryBudget(VmaAllocator vmaAllocator, uint64_t& usageBytes, uint64_t& budgetBytes);
 
 #endif
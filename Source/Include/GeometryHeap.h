@@ -0,0 +1,56 @@
+#ifndef GEOMETRY_HEAP_H
+#define GEOMETRY_HEAP_H
+
+class RenderContext;
+
+// Large device buffers holding the geometry streams of every draw item, suballocated with a TLSF allocator
+// (VMA virtual blocks). Draw items address their ranges by offset, so shaders bind each stream once.
+// Not thread-safe, owned by the commit task.
+// ---------------------------------------------------------
+
+enum class GeometryStream : uint32_t
+{
+    Index,
+    Position,
+    TexCoord,
+    Meshlet,
+    Instance,
+    Count
+};
+
+struct GeometryAllocation
+{
+    VmaVirtualAllocation allocation = VK_NULL_HANDLE;
+    VkDeviceSize         offset {};
+    VkDeviceSize         size {};
+};
+
+class GeometryHeap
+{
+public:
+
+    explicit GeometryHeap(RenderContext* pRenderContext);
+
+    GeometryHeap(const GeometryHeap&)            = delete;
+    GeometryHeap& operator=(const GeometryHeap&) = delete;
+
+    // Reserve a range of the stream's buffer, fatal if the heap is exhausted.
+    GeometryAllocation Allocate(GeometryStream stream, VkDeviceSize size);
+
+    void Free(GeometryStream stream, GeometryAllocation* pAllocation);
+
+    void ReportStatistics();
+
+    void Destroy();
+
+    [[nodiscard]] inline const Buffer& GetBuffer(GeometryStream stream) const { return m_Buffers.at(static_cast<uint32_t>(stream)); }
+
+private:
+
+    RenderContext* m_RenderContext;
+
+    std::array<Buffer, static_cast<uint32_t>(GeometryStream::Count)>          m_Buffers {};
+    std::array<VmaVirtualBlock, static_cast<uint32_t>(GeometryStream::Count)> m_Blocks {};
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef HOST_ARENA_H
+#define HOST_ARENA_H
+
+// Growable host staging memory for resource requests.
+// Reserves address space up front and commits it lazily in large chunks, producers bump-allocate from a thread local
+// block and chunks are decommitted as soon as every allocation inside of them has been released.
+// ---------------------------------------------------------
+
+class HostArena
+{
+public:
+
+    explicit HostArena(uint64_t reserveBytes);
+    ~HostArena();
+
+    HostArena(const HostArena&)            = delete;
+    HostArena& operator=(const HostArena&) = delete;
+
+    // Thread-safe, returns nullptr for empty allocations.
+    void* Allocate(uint64_t size);
+
+    // Thread-safe, the size must match the one passed to Allocate.
+    void Release(const void* pData, uint64_t size);
+
+    // Rewind the arena, no allocation may be alive nor in flight on another thread (checked against the chunk references).
+    void Reset();
+
+    [[nodiscard]] inline uint64_t GetCommittedBytes() const { return m_CommittedBytes.load(); }
+    [[nodiscard]] inline uint64_t GetPeakCommittedBytes() const { return m_PeakCommittedBytes.load(); }
+
+private:
+
+    struct Chunk
+    {
+        // Live allocations (and thread blocks) overlapping the chunk.
+        std::atomic<uint32_t> referenceCount {};
+        std::atomic<bool>     committed {};
+    };
+
+    struct ThreadBlock
+    {
+        uint64_t offset {};
+        uint64_t end {};
+    };
+
+    void AddReference(uint64_t offset, uint64_t size);
+    void RemoveReference(uint64_t offset, uint64_t size);
+
+    void RetireBlock(ThreadBlock* pBlock);
+
+    std::byte* m_pBase {};
+    uint64_t   m_ReserveBytes {};
+
+    std::atomic<uint64_t> m_Cursor {};
+
+    std::unique_ptr<Chunk[]> m_Chunks;
+    std::mutex               m_ChunkMutex;
+
+    tbb::enumerable_thread_specific<ThreadBlock> m_ThreadBlocks;
+
+    std::atomic<uint64_t> m_CommittedBytes {};
+    std::atomic<uint64_t> m_PeakCommittedBytes {};
+};
+
+#endif
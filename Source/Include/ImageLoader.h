@@ -0,0 +1,83 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+// Reads and decodes a material image from disk (DDS, KTX2, or any format supported by stb_image).
+// Safe to run concurrently on several threads, each loader owns its decoded texels.
+// ---------------------------------------------------------
+
+struct ImageLoadOptions
+{
+    // Color data is sampled in an sRGB format (8-bit images only).
+    bool isColor = true;
+
+    // Keep grey (and grey + alpha non-color) images in one / two channel formats instead of expanding them to RGBA.
+    bool preserveChannels = false;
+
+    // The device samples BC4 / BC5 / BC7, Basis Universal textures are transcoded to them instead of RGBA.
+    bool supportsBlockCompression = false;
+};
+
+class ImageLoader
+{
+public:
+
+    ImageLoader(const std::string& resolvedPath, const ImageLoadOptions& options);
+
+    // Decode the contents of an stb_image supported file (already read into memory).
+    ImageLoader(std::span<const std::byte> fileData, const ImageLoadOptions& options);
+    ~ImageLoader();
+
+    ImageLoader(const ImageLoader&)            = delete;
+    ImageLoader& operator=(const ImageLoader&) = delete;
+
+    [[nodiscard]] inline const void*     GetData() const { return m_Data; }
+    [[nodiscard]] inline GfVec2i         GetDim() const { return { m_Width, m_Height }; }
+    [[nodiscard]] inline const VkFormat& GetFormat() const { return m_Format; }
+    // Bytes per texel block (a single texel unless the format is block compressed).
+    [[nodiscard]] inline const uint32_t& GetStride() const { return m_BytesPerPixel; }
+    [[nodiscard]] inline const uint32_t& GetMipLevels() const { return m_MipLevels; }
+
+    // Array layers (six per cube map) of DDS / KTX2 images.
+    [[nodiscard]] inline const uint32_t& GetArrayLayers() const { return m_ArrayLayers; }
+    [[nodiscard]] inline bool            IsCubemap() const { return m_IsCubemap; }
+
+    // Swizzle of the sampled image (grey images preserved in a single channel are replicated into RGB).
+    [[nodiscard]] inline const VkComponentMapping& GetComponents() const { return m_Components; }
+
+    // Pack the levels tightly one after another, each holding the first array layers (up to GetArrayLayers()) in order.
+    void CopyMipLevels(void* pDestination, uint32_t arrayLayers = 1U) const;
+
+private:
+
+    // Decode an stb_image supported file and convert it into an upload format.
+    void LoadSTB(std::span<const std::byte> fileData, const ImageLoadOptions& options);
+
+#ifdef USE_KTX
+    // Load a KTX2 file (inflating supercompressed levels), and transcode Basis Universal payloads.
+    void LoadKTX2(const std::string& resolvedPath, const ImageLoadOptions& options);
+#endif
+
+    VkFormat           m_Format {};
+    VkComponentMapping m_Components {};
+    uint32_t           m_BytesPerPixel {};
+    uint32_t           m_MipLevels {};
+    uint32_t           m_ArrayLayers = 1U;
+    bool               m_IsCubemap {};
+    const void*        m_Data {};
+    int                m_Width {};
+    int                m_Height {};
+    dds::Image         m_DDSImage {};
+
+    // Pre-computed levels of DDS / KTX2 images (pointing into the loaded file), layer by layer.
+    std::vector<std::span<const std::byte>> m_Levels;
+
+#ifdef USE_KTX
+    ktxTexture2* m_pKTXTexture {};
+#endif
+
+    // Texels as decoded by stb_image (freed with the loader), and converted from them if needed.
+    void*                  m_pSTBData {};
+    std::vector<std::byte> m_ConvertedData;
+};
+
+#endif
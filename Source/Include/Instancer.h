@@ -0,0 +1,22 @@
+#ifndef INSTANCER_H
+#define INSTANCER_H
+
+// Native / point instancer (flattens the instance primvars into per-instance transforms for a prototype).
+class Instancer final : public HdInstancer
+{
+public:
+
+    Instancer(HdSceneDelegate* pSceneDelegate, const SdfPath& id) : HdInstancer(pSceneDelegate, id) {}
+
+    void Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam, HdDirtyBits* pDirtyBits) override;
+
+    // Transforms of every instance of the prototype, including the ones of the parent instancers (if nested).
+    VtMatrix4dArray ComputeInstanceTransforms(const SdfPath& prototypeId);
+
+private:
+
+    // Instance-rate primvars (translations, rotations, scales, transforms).
+    std::unordered_map<TfToken, VtValue, TfToken::HashFunctor> m_Primvars;
+};
+
+#endif
@@ -10,10 +10,14 @@ public:
     Material(const SdfPath& id, RenderDelegate* pOwner) : HdMaterial(id), m_Owner(pOwner) {}
 
     // MaterialX Standard Surface
-    constexpr static const char* kMaterialInputBaseColor = "base_color";
-    constexpr static const char* kMaterialInputNormal    = "normal";
-    constexpr static const char* kMaterialInputRoughness = "specular_roughness";
-    constexpr static const char* kMaterialInputMetallic  = "metalness";
+    constexpr static const char* kMaterialInputBase          = "base";
+    constexpr static const char* kMaterialInputBaseColor     = "base_color";
+    constexpr static const char* kMaterialInputNormal        = "normal";
+    constexpr static const char* kMaterialInputRoughness     = "specular_roughness";
+    constexpr static const char* kMaterialInputMetallic      = "metalness";
+    constexpr static const char* kMaterialInputEmission      = "emission";
+    constexpr static const char* kMaterialInputEmissionColor = "emission_color";
+    constexpr static const char* kMaterialInputOpacity       = "opacity";
 
     void Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam, HdDirtyBits* pDirtyBits) override;
 
@@ -2,6 +2,7 @@
 #define MESH_H
 
 class RenderDelegate;
+class ResourceRegistry;
 
 class Mesh : public HdMesh
 {
@@ -17,6 +18,13 @@ public:
     inline const GfMatrix4f& GetLocalToWorld() const { return m_LocalToWorld; }
     inline const size_t&     GetMaterialHash() const { return m_MaterialHash; }
 
+    // Draw item slot of this mesh in the resource registry (invalid until the geometry is first synced).
+    inline const DrawItemHandle& GetDrawItemHandle() const { return m_DrawItemHandle; }
+
+    // Instanced prototypes are drawn once per instance transform (applied after the local to world transform).
+    inline bool                           IsInstanced() const { return !GetInstancerId().IsEmpty(); }
+    inline const std::vector<GfMatrix4f>& GetInstanceTransforms() const { return m_InstanceTransforms; }
+
     // Brixelizer utility.
     inline const FfxBrixelizerAABB& GetAABB() const { return m_AABB; }
     inline const FfxFloat32x3x4&    GetLocalToWorld3x4() const { return m_LocalToWorld3x4; }
@@ -28,17 +36,24 @@ protected:
 
 private:
 
+    // Re-process and upload the mesh streams, returns false for prims without geometry.
+    bool SyncGeometry(HdSceneDelegate* pSceneDelegate, ResourceRegistry* pResourceRegistry);
+
     RenderDelegate* m_Owner;
 
+    DrawItemHandle m_DrawItemHandle;
+
     // Store the material id hash.
     // (The parent class does not seem to).
-    size_t m_MaterialHash;
+    size_t m_MaterialHash {};
 
     // For Brixelizer acceleration structure.
     FfxBrixelizerAABB m_AABB;
 
     GfMatrix4f     m_LocalToWorld {};
     FfxFloat32x3x4 m_LocalToWorld3x4 {};
+
+    std::vector<GfMatrix4f> m_InstanceTransforms;
 };
 
 #endif
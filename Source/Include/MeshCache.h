@@ -0,0 +1,85 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+// Persistent on-disk cache of post-processed Mesh::Sync output.
+// Files are keyed by prim path and validated against a hash of the source topology / primvars.
+// ---------------------------------------------------------
+
+enum class MeshCacheStream : uint32_t
+{
+    Index,
+    Vertex,
+    Texcoord,
+    Meshlet,
+    LOD,
+    Count
+};
+
+// Read-only view of a cache file mapped into host memory (unmapped on destruction).
+class MeshCacheEntry
+{
+public:
+
+    MeshCacheEntry() = default;
+    ~MeshCacheEntry() { Release(); }
+
+    MeshCacheEntry(const MeshCacheEntry&)            = delete;
+    MeshCacheEntry& operator=(const MeshCacheEntry&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> GetStream(MeshCacheStream stream) const;
+
+    [[nodiscard]] inline bool IsValid() const { return m_View != nullptr; }
+
+private:
+
+    friend class MeshCache;
+
+    void Release();
+
+    const std::byte* m_View {};
+    size_t           m_ViewSize {};
+
+    // Native file + mapping handles (Win32 only).
+    void* m_FileHandle {};
+    void* m_MappingHandle {};
+};
+
+class MeshCache
+{
+public:
+
+    // NOTE: Bump whenever the stream layout or the processing that produces the streams changes.
+    constexpr static uint32_t kVersion = 4U;
+
+    constexpr static const char* kDefaultDirectory = "MeshCache";
+
+    explicit MeshCache(std::filesystem::path directory = kDefaultDirectory);
+
+    // Combine the inputs that determine the post-processed mesh into a single hash (the AABB is the quantization range).
+    static uint64_t ComputeContentHash(const HdMeshTopology& topology, const VtVec3fArray& points, const VtVec2fArray& texCoords, const FfxBrixelizerAABB& aabb);
+
+    // Returns true and maps the file into the entry if a valid cache file exists for the prim.
+    bool TryLoad(const SdfPath& primPath, uint64_t contentHash, MeshCacheEntry* pEntry);
+
+    // Serialize the post-processed streams for a prim (written to a temporary file and then moved into place).
+    void Store(const SdfPath& primPath, uint64_t contentHash, const std::array<std::span<const std::byte>, static_cast<size_t>(MeshCacheStream::Count)>& streams);
+
+    // Accumulate the time spent producing a mesh, bucketed by whether the cache was hit.
+    void RecordSyncTime(bool cacheHit, std::chrono::nanoseconds duration);
+
+    // Write the hit-rate / timing report to the log and reset the counters.
+    void ReportStatistics();
+
+private:
+
+    [[nodiscard]] std::filesystem::path GetFilePath(const SdfPath& primPath) const;
+
+    std::filesystem::path m_Directory;
+
+    std::atomic<uint32_t> m_HitCount {};
+    std::atomic<uint32_t> m_MissCount {};
+    std::atomic<uint64_t> m_HitTimeNs {};
+    std::atomic<uint64_t> m_MissTimeNs {};
+};
+
+#endif
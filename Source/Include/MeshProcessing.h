@@ -0,0 +1,87 @@
+#ifndef MESH_PROCESSING_H
+#define MESH_PROCESSING_H
+
+// Post-triangulation processing of mesh streams (via meshoptimizer).
+// ---------------------------------------------------------
+
+struct MeshOptimizeStatistics
+{
+    // Average cache miss ratio (transformed vertices per triangle).
+    float acmrBefore {};
+    float acmrAfter {};
+
+    uint32_t vertexCountBefore {};
+    uint32_t vertexCountAfter {};
+};
+
+// Cluster of triangles with bounds for GPU culling (matches the layout in ClusterCull.hlsl).
+struct Meshlet
+{
+    GfVec3f center;
+    float   radius;
+
+    // Normal cone (in the mesh local space).
+    GfVec3f coneApex;
+    float   coneCutoff;
+    GfVec3f coneAxis;
+
+    // Range of the cluster in the (meshlet-ordered) index buffer, in triangles.
+    uint32_t triangleOffset;
+    uint32_t triangleCount;
+
+    // Resolved by the resource registry when the draw item is committed (UINT32_MAX in freed meshlet heap ranges).
+    uint32_t drawItemIndex;
+    uint32_t drawCommandOffset;
+    uint32_t drawCountIndex;
+};
+
+// Maximum number of levels of detail per mesh (including the source mesh).
+constexpr uint32_t kMaxLODCount = 4U;
+
+// Simplified level of detail, stored as a sub-range of the shared index buffer and meshlet list.
+struct MeshLOD
+{
+    uint32_t triangleOffset;
+    uint32_t triangleCount;
+
+    uint32_t meshletOffset;
+    uint32_t meshletCount;
+
+    // Simplification error relative to the source mesh, in mesh local space units.
+    float error;
+};
+
+// Draw item flags (matches the flags in VertexStreams.hlsl).
+constexpr uint32_t kDrawItemFlagQuantizedVertices = 1U << 0U;
+
+// Compact vertex streams: positions are 16-bit UNORM relative to the mesh AABB (xyz + padding for 8 byte alignment),
+// texture coordinates are half floats.
+struct QuantizedVertexStreams
+{
+    std::vector<std::array<uint16_t, 4>> positions;
+    std::vector<std::array<uint16_t, 2>> texCoords;
+};
+
+// Weld the per-vertex positions and face-varying (3 per triangle) texture coordinates into unique vertices indexed
+// by the re-written triangle list. Afterwards both streams are per-vertex.
+// NOTE: Must run before anything re-orders the triangles. A face-varying stream can only follow a re-ordering by
+// matching triangles on their position indices, which is ambiguous for coincident triangles with different texcoords.
+void WeldVertexStreams(VtVec3iArray* pTriangles, VtVec3fArray* pPoints, VtVec2fArray* pTexCoords);
+
+// Optimize the welded mesh streams in place for the post-transform vertex cache, overdraw and vertex fetch.
+void OptimizeMesh(VtVec3iArray* pTriangles, VtVec3fArray* pPoints, VtVec2fArray* pTexCoords, MeshOptimizeStatistics* pStatistics);
+
+// Partition the mesh into meshlets and re-order the triangles so that each meshlet is a contiguous range of the index buffer.
+void BuildMeshlets(VtVec3iArray* pTriangles, const VtVec3fArray& points, std::vector<Meshlet>* pMeshlets);
+
+// Simplify the mesh into a chain of levels of detail, partition every level into meshlets and append them after the
+// source triangles (so that primitive indices stay valid for the whole index buffer).
+void BuildLODChain(VtVec3iArray* pTriangles, const VtVec3fArray& points, std::vector<Meshlet>* pMeshlets, std::vector<MeshLOD>* pLODs);
+
+// Affine transform taking a quantized position back into the mesh local space (positionOS = offset + scale * unorm).
+void GetPositionDequantization(const FfxBrixelizerAABB& aabb, GfVec3f* pScale, GfVec3f* pOffset);
+
+// Encode the position and texture coordinate streams in the compact format.
+void QuantizeVertexStreams(const VtVec3fArray& points, const VtVec2fArray& texCoords, const FfxBrixelizerAABB& aabb, QuantizedVertexStreams* pStreams);
+
+#endif
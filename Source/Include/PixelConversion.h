@@ -0,0 +1,39 @@
+#ifndef PIXEL_CONVERSION_H
+#define PIXEL_CONVERSION_H
+
+// Conversion of decoded image texels into upload formats, vectorized with AVX2 or SSE4.1 (selected at runtime from
+// the CPU features) with a scalar fallback. Source and destination may not overlap.
+// ---------------------------------------------------------
+
+// Grey -> RGBA (grey replicated into the color channels, opaque alpha).
+void ConvertGrayToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount);
+
+// Grey + alpha -> RGBA.
+void ConvertGrayAlphaToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount);
+
+// RGB -> RGBA (opaque alpha).
+void ConvertRGBToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount);
+
+// 16-bit -> 8-bit unsigned normalized channels (truncated, as stb_image does).
+void ConvertUNorm16ToUNorm8(const uint16_t* pSource, uint8_t* pDestination, size_t channelCount);
+
+// 32-bit -> 16-bit floating point channels (round to nearest even).
+void ConvertFloatToHalf(const float* pSource, uint16_t* pDestination, size_t channelCount);
+
+// Instruction set selection
+// ---------------------------------------------------------
+
+enum class PixelConversionISA
+{
+    Scalar,
+    SSE41,
+    AVX2 // And F16C.
+};
+
+// Highest instruction set the conversions may use (AVX2 by default, always capped by the CPU features). Not meant to
+// be changed while conversions run, the benchmark uses it to compare every path against the scalar loops.
+void SetPixelConversionMaxISA(PixelConversionISA isa);
+
+bool IsPixelConversionISASupported(PixelConversionISA isa);
+
+#endif
@@ -27,10 +27,17 @@
 
 #include <magic_enum/magic_enum.hpp>
 
+#include <bit>
 #include <fstream>
 #include <intrin.h>
 #include <filesystem>
+#include <numeric>
 #include <queue>
+#include <ranges>
+#include <span>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 // Superluminal Includes (If enabled)
 // ---------------------------------------------------------
@@ -59,6 +66,13 @@
 
 #include <dds.hpp>
 
+// KTX2 Loading + Basis Universal Transcoding (If enabled)
+// ---------------------------------------------------------
+
+#ifdef USE_KTX
+#include <ktx.h>
+#endif
+
 // GLM Includes
 // ---------------------------------------------------------
 
@@ -90,12 +104,16 @@ using namespace DirectX::SimpleMath;
 // TBB Includes
 // ---------------------------------------------------------
 
+#include <tbb/concurrent_queue.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
 #include <tbb/task_group.h>
 
 // OpenUSD Includes
 // ---------------------------------------------------------
 
+#include <pxr/base/arch/hash.h>
 #include <pxr/base/gf/camera.h>
 #include <pxr/base/gf/matrix4f.h>
 #include <pxr/base/tf/errorMark.h>
@@ -11,6 +11,9 @@ const uint32_t kMaxFramesInFlight = 3U;
 struct FrameParams;
 struct Buffer;
 struct Image;
+struct MipGeneration;
+
+class StagingRing;
 
 class RenderContext
 {
@@ -31,6 +34,11 @@ public:
     inline VkQueue&          GetCommandQueue() { return m_VKCommandQueue; }
     inline uint32_t&         GetCommandQueueIndex() { return m_VKCommandQueueIndex; }
     inline std::mutex&       GetCommandQueueMutex() { return m_VKCommandQueueMutex; }
+    inline VkQueue&          GetTransferQueue() { return m_VKTransferQueue; }
+    inline uint32_t&         GetTransferQueueIndex() { return m_VKTransferQueueIndex; }
+    inline std::mutex&       GetTransferQueueMutex() { return HasDedicatedTransferQueue() ? m_VKTransferQueueMutex : m_VKCommandQueueMutex; }
+    inline bool              HasDedicatedTransferQueue() const { return m_VKTransferQueueIndex != m_VKCommandQueueIndex; }
+    inline const VkExtent3D& GetTransferGranularity() const { return m_VKTransferGranularity; }
     inline VkCommandPool&    GetCommandPool() { return m_VKCommandPool; }
     inline VkDescriptorPool& GetDescriptorPool() { return m_VKDescriptorPool; }
     inline GLFWwindow*       GetWindow() { return m_Window; }
@@ -40,33 +48,64 @@ public:
 
     // Misc. helpers.
     // --------------------------------------------------
-    void CreateCommandPool(VkCommandPool* pCommandPool);
-    void CreateStagingBuffer(VkDeviceSize size, Buffer* pStagingBUffer);
+    void CreateCommandPool(VkCommandPool* pCommandPool, uint32_t queueFamilyIndex);
+
+    // Queue family ownership acquisitions of uploaded resources, executed on the graphics queue ahead of the next frame
+    // once the timeline semaphore reaches the value (the frame submission waits on it, the host never does).
+    // The mip chains of the acquired images are generated right after.
+    void PushFrameAcquire(VkSemaphore                             timelineSemaphore,
+                          uint64_t                                timelineValue,
+                          std::span<const VkBufferMemoryBarrier2> bufferBarriers,
+                          std::span<const VkImageMemoryBarrier2>  imageBarriers,
+                          std::span<const MipGeneration>          mipGenerations);
+
+    // True until the next frame submission has taken over the uploads pushed with PushFrameAcquire.
+    bool HasPendingFrameAcquires();
 
+    // Number of frames submitted to the graphics queue so far.
+    [[nodiscard]] inline uint64_t GetFrameSubmitCount() const { return m_FrameSubmitCount.load(); }
+
+    // Block until the first frameCount submitted frames have completed on the device (callable from any thread).
+    void WaitForFrames(uint64_t frameCount);
+
+    // Device resource creation, the copies are recorded into the staging ring (and complete once it is flushed).
     struct CreateDeviceBufferWithDataParams
     {
         void*              pData;
         VkDeviceSize       size;
         VkBufferUsageFlags usage;
-        VkCommandPool      commandPool;
-        const Buffer*      pBufferStaging;
+        StagingRing*       pStagingRing;
         Buffer*            pBufferDevice;
     };
 
     void CreateDeviceBufferWithData(CreateDeviceBufferWithDataParams& params);
 
+    // Copy into a range of an existing device buffer (no ownership transfer, the buffer must be shared with the upload queue).
+    void UploadBufferData(StagingRing* pStagingRing, const void* pData, VkDeviceSize size, VkBuffer buffer, VkDeviceSize bufferOffset);
+
+    // The data holds every level of the image packed tightly (each level holding every array layer / cube face one after
+    // another), or only the first one if the rest of the chain is generated (single layer images only).
     struct CreateDeviceImageWithDataParams
     {
         void*             pData;
         VkImageCreateInfo info;
         VkDeviceSize      bytesPerTexel;
-        VkCommandPool     commandPool;
-        const Buffer*     pBufferStaging;
+        StagingRing*      pStagingRing;
         Image*            pImageDevice;
+        bool              generateMips;
+
+        // Swizzle of the image view (identity if zero-initialized).
+        VkComponentMapping components;
     };
 
     void CreateDeviceImageWithData(CreateDeviceImageWithDataParams& params);
 
+    // Whether the mip chain of images of this format can be generated by linear blits.
+    bool SupportsMipGeneration(VkFormat format);
+
+    // Whether images of this format can be sampled with linear filtering.
+    bool SupportsLinearFiltering(VkFormat format);
+
 private:
 
     VkInstance       m_VKInstance        = VK_NULL_HANDLE;
@@ -84,6 +123,19 @@ private:
     // For multi-threaded queue submissions
     std::mutex m_VKCommandQueueMutex;
 
+    // Upload queue (aliases the graphics queue if the device has no separate transfer family).
+    VkQueue    m_VKTransferQueue       = VK_NULL_HANDLE;
+    uint32_t   m_VKTransferQueueIndex  = UINT_MAX;
+    VkExtent3D m_VKTransferGranularity = { 1U, 1U, 1U };
+    std::mutex m_VKTransferQueueMutex;
+
+    // Pending upload acquisitions / waits for the next frame submission.
+    std::vector<VkBufferMemoryBarrier2>       m_FrameAcquireBufferBarriers;
+    std::vector<VkImageMemoryBarrier2>        m_FrameAcquireImageBarriers;
+    std::vector<MipGeneration>                m_FrameMipGenerations;
+    std::unordered_map<VkSemaphore, uint64_t> m_FrameTimelineWaits;
+    std::mutex                                m_FrameAcquireMutex;
+
     // For multi-threaded allocations
     std::mutex m_VKAllocatorMutex;
 
@@ -101,9 +153,14 @@ private:
 
     // Frame Primitives
     std::array<VkCommandBuffer, kMaxFramesInFlight> m_VKCommandBuffers {};
+    std::array<VkCommandBuffer, kMaxFramesInFlight> m_VKAcquireCommandBuffers {};
     std::array<VkSemaphore, kMaxFramesInFlight>     m_VKImageAvailableSemaphores {};
     std::array<VkSemaphore, kMaxFramesInFlight>     m_VKRenderCompleteSemaphores {};
     std::array<VkFence, kMaxFramesInFlight>         m_VKInFlightFences {};
+
+    // Signaled with the frame index + 1 by each frame submission, to retire resources from other threads.
+    VkSemaphore           m_VKFrameTimelineSemaphore = VK_NULL_HANDLE;
+    std::atomic<uint64_t> m_FrameSubmitCount {};
 };
 
 #endif
@@ -35,8 +35,8 @@ public:
 
     HdRenderPassSharedPtr CreateRenderPass(HdRenderIndex* index, const HdRprimCollection& collection) override;
 
-    HdInstancer* CreateInstancer(HdSceneDelegate* delegate, const SdfPath& id) override { return new HdInstancer(delegate, id); };
-    void         DestroyInstancer(HdInstancer* instancer) override {};
+    HdInstancer* CreateInstancer(HdSceneDelegate* delegate, const SdfPath& id) override;
+    void         DestroyInstancer(HdInstancer* instancer) override;
 
     HdRprim* CreateRprim(const TfToken& typeId, const SdfPath& rprimId) override;
     HdSprim* CreateSprim(const TfToken& typeId, const SdfPath& sprimId) override;
@@ -57,13 +57,11 @@ public:
     [[nodiscard]] HdRenderParam* GetRenderParam() const override { return nullptr; };
 
     inline RenderContext* GetRenderContext() { return m_RenderContext; };
-    inline std::mutex&    GetRenderContextMutex() { return m_RenderContextMutex; }
 
 private:
 
     // Reference to the custom Vulkan driver implementation.
     RenderContext* m_RenderContext {};
-    std::mutex     m_RenderContextMutex;
 
     HdResourceRegistrySharedPtr m_ResourceRegistry;
 };
@@ -3,6 +3,7 @@
 
 class RenderDelegate;
 class ResourceRegistry;
+struct DrawItem;
 
 #include <Common.h>
 
@@ -12,19 +13,44 @@ enum ShaderID
     VisibilityFrag,
     DebugVert,
     DebugFrag,
-    GBufferResolveComp
+    GBufferResolveComp,
+    ClusterCullComp,
+    DrawItemScatterComp,
+    MaterialFeedbackComp
 };
 
 struct VisibilityPushConstants
 {
-    GfMatrix4f MatrixMVP;
+    GfMatrix4f MatrixVP;
     uint32_t   MeshID;
     uint32_t   MeshCount;
 };
 
+struct DrawItemScatterPushConstants
+{
+    uint32_t UpdateOffset;
+    uint32_t UpdateCount;
+};
+
+struct ClusterCullPushConstants
+{
+    std::array<GfVec4f, 6> FrustumPlanes;
+    GfVec3f                CameraPosition;
+    uint32_t               MeshletCount;
+    uint32_t               FrameIndex;
+};
+
+struct MaterialFeedbackPushConstants
+{
+    GfMatrix4f MatrixVP;
+    GfVec2f    RenderResolution;
+    uint32_t   FrameIndex;
+};
+
 struct DebugPushConstants
 {
     GfMatrix4f MatrixVP;
+    GfVec2f    RenderResolution;
     uint32_t   DebugModeValue;
     uint32_t   MeshCount;
 };
@@ -82,6 +108,10 @@ private:
     bool m_RebuildAccelerationStructure { true };
 
     void RebuildAccelerationStructure(FrameContext* pFrameContext);
+    void AppendBrixelizerInstances(DrawItem& drawItem, std::vector<FfxBrixelizerInstanceDescription>* pInstanceDescs);
+
+    // Index and position heaps, registered once by the acceleration structure build.
+    std::array<uint32_t, 2> m_FFXBrixelizerBufferIndices {};
     void CreateBrixelizerLatentDeviceResources();
 
     FfxDevice            m_FFXDevice {};
@@ -108,21 +138,55 @@ private:
     // Resource Descriptors
     // ---------------------------------------
 
+    // Draw Item Scatter Pass
+    // ---------------------------------------
+
+    VkDescriptorSetLayout m_DrawItemScatterDescriptorSetLayout;
+    VkPipelineLayout      m_DrawItemScatterPipelineLayout;
+
+    DrawItemScatterPushConstants m_DrawItemScatterPushConstants {};
+
+    void DrawItemScatterPassCreate(RenderContext* pRenderContext);
+    void DrawItemScatterPassExecute(FrameContext* pFrameContext);
+
+    // Cluster Culling Pass
+    // ---------------------------------------
+
+    VkDescriptorSetLayout m_ClusterCullDescriptorSetLayout;
+    VkPipelineLayout      m_ClusterCullPipelineLayout;
+
+    ClusterCullPushConstants m_ClusterCullPushConstants {};
+
+    void ClusterCullPassCreate(RenderContext* pRenderContext);
+    void ClusterCullPassExecute(FrameContext* pFrameContext);
+
     // Visibility Pass
     // ---------------------------------------
 
     Image m_VisibilityBuffer {};
 
-    VkPipelineLayout m_VisibilityPipelineLayout;
+    VkDescriptorSetLayout m_VisibilityDescriptorSetLayout;
+    VkPipelineLayout      m_VisibilityPipelineLayout;
 
     VisibilityPushConstants m_VisibilityPushConstants {};
 
-    std::vector<VkVertexInputBindingDescription2EXT>   m_VertexInputBindings;
-    std::vector<VkVertexInputAttributeDescription2EXT> m_VertexInputAttributes;
-
     void VisibilityPassCreate(RenderContext* pRenderContext);
     void VisibilityPassExecute(FrameContext* pFrameContext);
 
+    // Picks the level of detail of every draw item before the scatter pass uploads its meta-data.
+    void SelectDrawItemLODs(FrameContext* pFrameContext);
+
+    // Material Feedback Pass
+    // ---------------------------------------
+
+    VkDescriptorSetLayout m_MaterialFeedbackDescriptorSetLayout;
+    VkPipelineLayout      m_MaterialFeedbackPipelineLayout;
+
+    MaterialFeedbackPushConstants m_MaterialFeedbackPushConstants {};
+
+    void MaterialFeedbackPassCreate(RenderContext* pRenderContext);
+    void MaterialFeedbackPassExecute(FrameContext* pFrameContext);
+
     // Material Pixel Pass
     // ---------------------------------------
 
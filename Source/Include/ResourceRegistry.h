@@ -6,25 +6,136 @@ class Material;
 class RenderContext;
 
 #include <Common.h>
+#include <GeometryHeap.h>
+#include <HostArena.h>
+#include <ImageLoader.h>
+#include <MeshCache.h>
+#include <TextureCache.h>
+#include <MeshProcessing.h>
+#include <StagingRing.h>
+
+// Device geometry, shared by every draw item with the same content hash.
+struct DrawItemGeometry
+{
+    // Index count of the source level of detail (the simplified levels follow it in the index buffer).
+    uint32_t indexCount;
+
+    // Ranges in the geometry heap streams.
+    GeometryAllocation indices;
+    GeometryAllocation positions;
+    GeometryAllocation texCoords;
+
+    // Clusters in mesh local space (re-resolved for every draw item referencing the geometry).
+    std::vector<Meshlet> meshlets;
+
+    // Levels of detail (at least one, the source mesh).
+    std::vector<MeshLOD> lods;
 
+    // Position quantization reference of the owning prim.
+    FfxBrixelizerAABB aabb;
+};
+
+// Draw item slot, empty (no geometry) until its first request is committed and once it is freed.
 struct DrawItem
 {
     Mesh* pMesh = nullptr;
 
-    uint32_t indexCount;
+    const DrawItemGeometry* pGeometry = nullptr;
+
+    // Reference held on the shared geometry, released with the draw item.
+    uint64_t contentHash {};
+
+    // Ranges of this draw item's clusters and instance transforms in the geometry heap.
+    GeometryAllocation meshletRange;
+    GeometryAllocation instanceRange;
+
+    // Range of this draw item's clusters in the meshlet heap (in meshlets).
+    uint32_t meshletOffset;
+    uint32_t meshletCount;
+
+    // First of this draw item's indirect draw counts (one per level of detail).
+    uint32_t drawCountOffset;
+
+    // Level of detail selected for the current frame before the meta-data scatter (the previous selection drives the hysteresis).
+    uint32_t lodIndex {};
+
+    // Range of this draw item's transforms in the instance heap (in transforms).
+    uint32_t instanceOffset;
+    uint32_t instanceCount;
+
+    // For Brixelizer support (one per instance), and the transform they were created with.
+    std::vector<FfxBrixelizerInstanceID> brixelizerIDs;
+    GfMatrix4f                           brixelizerLocalToWorld;
+};
+
+// Textured inputs of a material, each one sampled from its own image of the material slot.
+enum class MaterialTexture : uint32_t
+{
+    BaseColor,
+    Metalness,
+    Roughness,
+    Normal,
+    Emissive
+};
+
+constexpr uint32_t kMaterialTextureCount = 5U;
+constexpr uint16_t kMaterialTextureNone  = 0xFFFFU;
 
-    Buffer bufferI;
-    Buffer bufferV;
-    Buffer bufferST;
+// Surface parameters of a material slot (matches the layout in MaterialParameters.hlsl), packed into 32 bytes so that
+// shading fetches every parameter of a pixel at once. Factors are half floats, multiplied with the texture if any.
+struct DeviceMaterialParameters
+{
+    std::array<uint16_t, 3> baseColor;
+    uint16_t                opacity;
+    std::array<uint16_t, 3> emissive;
+    uint16_t                metalness;
+    uint16_t                roughness;
+    uint16_t                normalScale;
+
+    // Bindless image index of each textured input (kMaterialTextureNone if the input is constant, or not yet uploaded).
+    std::array<uint16_t, kMaterialTextureCount> textureIndices;
 
-    // For Brixelizer support.
-    FfxBrixelizerInstanceID brixelizerID;
+    uint16_t padding;
 };
 
+static_assert(sizeof(DeviceMaterialParameters) == 32U, "Material parameters must match the shader layout.");
+
 struct DeviceMaterial
 {
     size_t hash {};
-    Image  albedo;
+
+    // Shared textures referenced by the material (zero for constant inputs).
+    std::array<uint64_t, kMaterialTextureCount> textureKeys {};
+
+    DeviceMaterialParameters parameters {};
+};
+
+// Shared material texture, evicted to host memory while the device runs over its memory budget.
+struct DeviceTexture
+{
+    // Empty while the texture is evicted (or failed to load).
+    Image image;
+
+    VkFormat     format {};
+    VkExtent3D   extent {};
+    VkDeviceSize bytesPerTexel {};
+    uint32_t     mipLevels {};
+
+    VkComponentMapping components {};
+
+    // Last frame a draw item sampling the texture had a visible cluster (from the cluster culling feedback).
+    uint64_t lastUsedFrame {};
+
+    // Texels of an evicted texture (its first host mip levels, packed tightly), restored on demand. Streamed textures
+    // keep their whole chain here while resident.
+    std::vector<std::byte> hostTexels;
+    uint32_t               hostMipLevels {};
+
+    // Streamed textures hold the levels from the resident level down on the device, and move it to the level requested
+    // by the material feedback (the finest one any visible material sampling the texture asked for).
+    bool     isStreamed {};
+    uint32_t residentMipLevel {};
+    uint32_t requestedMipLevel {};
 };
 
 struct DrawItemMetaData
@@ -32,7 +143,27 @@ struct DrawItemMetaData
     GfMatrix4f matrix;
     uint32_t   faceCount;
     uint32_t   materialIndex;
-    GfVec2i    unused;
+    uint32_t   flags;
+    uint32_t   instanceOffset;
+
+    // Dequantization of the position stream (identity unless kDrawItemFlagQuantizedVertices is set).
+    GfVec4f positionScale;
+    GfVec4f positionOffset;
+
+    uint32_t instanceCount;
+
+    // Geometry heap ranges (first index, byte offsets of the vertex streams).
+    uint32_t indexOffset;
+    uint32_t positionBufferOffset;
+    uint32_t texCoordBufferOffset;
+};
+
+// Meta-data patch for a single draw item (matches the layout in DrawItemScatter.hlsl).
+struct DrawItemMetaDataUpdate
+{
+    uint32_t         drawItemIndex;
+    GfVec3i          unused;
+    DrawItemMetaData metaData;
 };
 
 struct ImageData
@@ -41,12 +172,24 @@ struct ImageData
     uint32_t stride;
     GfVec2i  dim;
     VkFormat format;
+
+    // Levels packed in the data, a single level gets its mip chain generated on the device.
+    uint32_t mipLevels;
+
+    VkComponentMapping components;
 };
 
 struct DrawItemRequest
 {
     Mesh* pMesh;
 
+    // Slot the draw item is committed to (replacing its previous contents, if any).
+    DrawItemHandle handle;
+
+    // Requests that do not own their geometry carry no data and reference the one uploaded for the same content hash.
+    uint64_t contentHash;
+    bool     ownsGeometry;
+
     void*  pIndexBufferHost;
     size_t indexBufferSize;
 
@@ -55,13 +198,30 @@ struct DrawItemRequest
 
     void*  pTexcoordBufferHost;
     size_t texcoordBufferSize;
+
+    void*  pMeshletBufferHost;
+    size_t meshletBufferSize;
+
+    void*  pLODBufferHost;
+    size_t lodBufferSize;
 };
 
 struct MaterialRequest
 {
-    Material* pMaterial;
+    // Material id hash (the key draw items reference the material by).
+    size_t hash;
 
-    ImageData albedo;
+    // Textures sampled by the material, uploaded by their own requests once decoded.
+    std::array<uint64_t, kMaterialTextureCount> textureKeys;
+
+    // Factors of the material (the texture indices are resolved by the commit).
+    DeviceMaterialParameters parameters;
+};
+
+struct TextureRequest
+{
+    uint64_t  key;
+    ImageData image;
 };
 
 class ResourceRegistry : public HdResourceRegistry
@@ -75,15 +235,67 @@ public:
     void PushDrawItemRequest(DrawItemRequest& request);
     void PushMaterialRequest(MaterialRequest& request);
 
+    // Destroyed prims. The registry takes ownership of the mesh and deletes it once its draw item is freed,
+    // the device resources are only released after every frame using them has completed.
+    void PushDrawItemRelease(Mesh* pMesh);
+    void PushMaterialRelease(size_t hash);
+
+    // Reserve a draw item slot for a mesh (thread-safe), it stays empty until a request for it is committed.
+    DrawItemHandle AcquireDrawItemHandle();
+
+    // Adds a reference to the geometry with this content hash, one per draw item request. Returns true for the first
+    // reference, the caller is then responsible for uploading the geometry.
+    bool ClaimGeometry(uint64_t contentHash);
+
+    // Adds a reference to the texture with this key (see ComputeTextureKey), one per textured input of a material
+    // request. Returns true for the first reference, the caller is then responsible for pushing its decode.
+    bool ClaimTexture(uint64_t textureKey);
+
+    // Key of the texture cache: the resolved asset path, the role it is decoded for, and the file's size and last write
+    // time (zero for no file).
+    static uint64_t ComputeTextureKey(const std::string& resolvedPath, TextureRole role);
+
+    // Read and decode the image of a claimed texture on a worker thread, the commit uploads it once decoded (materials
+    // sample the default image until then). The role selects the block compressed format, if compression is enabled.
+    void PushTextureDecode(uint64_t textureKey, const std::string& resolvedPath, TextureRole role);
+
+    // Non-geometric (transform / material / level of detail) changes of an uploaded draw item, patched in place by the
+    // scatter pass.
+    void PushDrawItemUpdate(DrawItemHandle handle);
+
+    // Write the pending meta-data updates into the upload slice of the frame in flight, returns the number of updates written.
+    uint32_t PrepareDrawItemUpdates(uint64_t frameIndex, uint32_t* pUpdateOffset);
+
+    // Draw item slots up to the highest one in use (freed slots have no geometry).
     inline std::vector<DrawItem>& GetDrawItems() { return m_DrawItems; }
+    inline MeshCache&             GetMeshCache() { return m_MeshCache; }
+    inline const GeometryHeap&    GetGeometryHeap() { return m_GeometryHeap; }
     inline bool                   IsBusy() { return m_CommitTaskBusy.load(); }
 
     inline const VkDescriptorSetLayout& GetDrawItemDataDescriptorLayout() { return m_DrawItemDataDescriptorLayout; }
     inline const VkDescriptorSet&       GetDrawItemDataDescriptorSet() { return m_DrawItemDataDescriptorSet; }
 
+    inline const Buffer&   GetDrawItemMetaDataBuffer() { return m_DrawItemMetaDataBuffer; }
+    inline const Buffer&   GetDrawItemUpdateBuffer() { return m_DrawItemUpdateBuffer; }
+    inline const Buffer&   GetInstanceTransformBuffer() { return m_GeometryHeap.GetBuffer(GeometryStream::Instance); }
+    inline const Buffer&   GetMeshletBuffer() { return m_GeometryHeap.GetBuffer(GeometryStream::Meshlet); }
+    inline const Buffer&   GetDrawCommandBuffer() { return m_DrawCommandBuffer; }
+    inline const Buffer&   GetDrawCountBuffer() { return m_DrawCountBuffer; }
+    inline const Buffer&   GetDrawItemFeedbackBuffer() { return m_DrawItemFeedbackBuffer; }
+    inline const Buffer&   GetMaterialFeedbackBuffer() { return m_MaterialFeedbackBuffer; }
+    inline const uint32_t& GetMeshletCount() { return m_MeshletCount; }
+
     inline const VkDescriptorSetLayout& GetMaterialDataDescriptorLayout() { return m_MaterialDataDescriptorLayout; }
     inline const VkDescriptorSet&       GetMaterialDataDescriptorSet() { return m_MaterialDataDescriptorSet; }
 
+    // Brixelizer instances of the draw items freed since the last call, to be deleted before the next update
+    // (only while the commit task is idle).
+    std::vector<FfxBrixelizerInstanceID> TakeRetiredBrixelizerInstances();
+
+    // Draw items whose transform changed since the last call. Brixelizer instances are immutable, their previous ones are
+    // retired and new ones must be created (returns the indices of the draw items that are still alive).
+    std::vector<uint32_t> TakeRetransformedBrixelizerDrawItems();
+
 protected:
 
     void _Commit() override;
@@ -91,8 +303,50 @@ protected:
 
 private:
 
+    // Allocate the descriptor sets and write the bindings that never change.
+    void CreateDescriptors();
+
+    // Write the descriptors and parameters of the material slots changed by the commit, in a single batch.
     void BuildDescriptors();
 
+    DrawItemMetaData BuildDrawItemMetaData(const DrawItem& drawItem);
+
+    // Build a draw item into its slot from the (resolved) shared geometry.
+    void BuildDrawItem(uint32_t drawItemIndex, Mesh* pMesh, uint64_t contentHash, const DrawItemGeometry* pGeometry);
+
+    // Return the device resources of a draw item slot, leaving it empty (the slot itself stays reserved).
+    void ReleaseDrawItem(DrawItem* pDrawItem);
+
+    // Drop a geometry reference, the geometry is freed with the last one.
+    void ReleaseGeometry(uint64_t contentHash);
+
+    // Drop a texture reference, the image is destroyed with the last one.
+    void ReleaseTexture(uint64_t textureKey);
+
+    // Record the upload of a texture's texels (the first levels of its mip chain from the resident level) into a new
+    // device image, the rest of the chain is generated from the first level.
+    void CreateTextureImage(DeviceTexture* pTexture, void* pTexels, uint32_t texelMipLevels);
+
+    // Replace the image of a streamed texture with one holding the levels from the given level down (uploaded from
+    // its host chain).
+    void StreamTextureImage(DeviceTexture* pTexture, uint32_t mipLevel);
+
+    // Block compressed mip chain of an image file, read from the texture cache or compressed (and cached) from the
+    // decoded image. Returns false for images that are uploaded uncompressed (high dynamic range, or failed to load).
+    bool LoadCompressedTexture(const std::string& resolvedPath, TextureRole role, CompressedTexture* pTexture);
+
+    // Fold the draw item visibility and material feedback into the texture usage, returns true if textures should be
+    // evicted, restored or streamed (main thread, while the commit task is idle).
+    bool UpdateTextureUsage();
+
+    // Evict the least recently visible textures to host memory while over budget, and restore the evicted textures
+    // that are visible again while they fit. Streamed textures are coarsened under pressure, and refined to their
+    // requested level while they fit (commit task, once the retired frames have completed).
+    void UpdateTextureResidency(std::unordered_set<uint64_t>* pChangedTextureKeys);
+
+    // Slot of an uploaded material, if any.
+    uint32_t TryFindDeviceMaterialIndex(size_t hash);
+
     RenderContext* m_RenderContext;
 
     std::atomic<bool> m_CommitTaskBusy;
@@ -100,30 +354,100 @@ private:
 
     Image m_DefaultImage;
 
-    std::queue<DrawItemRequest> m_DrawItemRequests;
-    std::vector<DrawItem>       m_DrawItems;
-
-    std::queue<MaterialRequest> m_MaterialRequests;
-    std::vector<DeviceMaterial> m_DeviceMaterials;
+    // Multi-producer queues filled concurrently by Hydra's parallel rprim / sprim sync.
+    tbb::concurrent_queue<DrawItemRequest> m_DrawItemRequests;
+    tbb::concurrent_queue<Mesh*>           m_DrawItemReleases;
+    std::vector<DrawItem>                  m_DrawItems;
+
+    // Draw item slot allocation (a slot's generation is bumped when it is freed). Generations are sized for every slot
+    // up front, and read by the commit task without the slot lock.
+    std::vector<std::atomic<uint32_t>> m_DrawItemGenerations;
+    std::vector<uint32_t>              m_FreeDrawItemSlots;
+    uint32_t                           m_DrawItemSlotCount {};
+    std::mutex                         m_DrawItemSlotMutex;
+
+    // De-duplicated device geometry, keyed by content hash (and reference counted by draw item).
+    std::unordered_map<uint64_t, uint32_t>         m_GeometryClaims;
+    std::mutex                                     m_GeometryClaimMutex;
+    std::unordered_map<uint64_t, DrawItemGeometry> m_Geometry;
+
+    // Owner requests claimed but not yet uploaded by a commit, per content hash (guarded by the claim mutex).
+    std::unordered_map<uint64_t, uint32_t> m_PendingGeometryOwners;
+
+    // Material slots (the first one is the default material), recycled through the free list.
+    tbb::concurrent_queue<MaterialRequest> m_MaterialRequests;
+    tbb::concurrent_queue<size_t>          m_MaterialReleases;
+    std::vector<DeviceMaterial>            m_DeviceMaterials;
+    std::unordered_map<size_t, uint32_t>   m_DeviceMaterialIndices;
+    std::vector<uint32_t>                  m_FreeMaterialSlots;
+    std::vector<uint32_t>                  m_DirtyMaterialSlots;
+
+    // Parameters of every material slot, written in place (nothing in flight reads them while the commit runs).
+    Buffer                    m_MaterialParameterBuffer;
+    DeviceMaterialParameters* m_pMaterialParametersMapped {};
+
+    // Texture decodes run concurrently to the sync and the commit, each one queues its texels once done.
+    ImageLoadOptions                      m_TextureLoadOptions;
+    tbb::task_group                       m_TextureDecodeTasks;
+    std::atomic<uint32_t>                 m_PendingTextureDecodes;
+    tbb::concurrent_queue<TextureRequest> m_TextureRequests;
+
+    // Block compressed textures (if the device samples every compressed format), cached on disk across sessions.
+    bool         m_CompressTextures {};
+    TextureCache m_TextureCache;
+
+    // Mip level streaming of the textures decoded with a full chain.
+    bool m_StreamTextures {};
+
+    // De-duplicated device textures, keyed by texture key (and reference counted by material).
+    std::unordered_map<uint64_t, uint32_t>      m_TextureClaims;
+    std::mutex                                  m_TextureClaimMutex;
+    std::unordered_map<uint64_t, DeviceTexture> m_Textures;
+
+    // Texture residency, re-evaluated every few frames.
+    Buffer        m_DrawItemFeedbackBuffer;
+    uint32_t*     m_pDrawItemFeedbackMapped {};
+    Buffer        m_MaterialFeedbackBuffer;
+    uint32_t*     m_pMaterialFeedbackMapped {};
+    uint64_t      m_ResidencyUpdateFrame {};
+    VkCommandPool m_ResidencyCommandPool = VK_NULL_HANDLE;
 
     Buffer m_DrawItemMetaDataBuffer;
 
+    // Incremental meta-data updates (persistently mapped, one slice per frame in flight).
+    tbb::concurrent_queue<DrawItemHandle> m_DrawItemUpdates;
+    Buffer                                m_DrawItemUpdateBuffer;
+    DrawItemMetaDataUpdate*               m_pDrawItemUpdatesMapped {};
+
+    // Cluster culling (meshlets live in the geometry heap, up to the highest range in use).
+    Buffer   m_DrawCommandBuffer;
+    Buffer   m_DrawCountBuffer;
+    uint32_t m_MeshletCount {};
+
+    MeshCache m_MeshCache;
+
     VkSampler m_DeviceMaterialImageSampler;
 
     // Using VK_EXT_descriptor_indexing to bind all resource arrays to PSO.
+    VkDescriptorPool m_DescriptorPool = VK_NULL_HANDLE;
+
     VkDescriptorSetLayout m_DrawItemDataDescriptorLayout;
     VkDescriptorSet       m_DrawItemDataDescriptorSet;
 
     VkDescriptorSetLayout m_MaterialDataDescriptorLayout;
     VkDescriptorSet       m_MaterialDataDescriptorSet;
 
-    std::mutex           m_HostBufferPoolMutex;
-    uint64_t             m_HostBufferPoolSize;
-    std::vector<char8_t> m_HostBufferPool;
+    // Host staging memory for the requests, released back to the arena once uploaded.
+    HostArena m_HostBufferArena;
+    HostArena m_HostImageArena;
+
+    // Device upload memory (on the transfer queue), flushed once per commit.
+    StagingRing m_StagingRing;
+
+    GeometryHeap m_GeometryHeap;
 
-    std::mutex           m_HostImagePoolMutex;
-    uint64_t             m_HostImagePoolSize;
-    std::vector<char8_t> m_HostImagePool;
+    std::vector<FfxBrixelizerInstanceID> m_RetiredBrixelizerInstances;
+    std::vector<DrawItemHandle>          m_RetransformedBrixelizerDrawItems;
 };
 
 #endif
@@ -0,0 +1,104 @@
+#ifndef STAGING_RING_H
+#define STAGING_RING_H
+
+class RenderContext;
+
+// Persistently mapped upload memory for host -> device copies.
+// Allocations are carved linearly out of a ring and their copies are recorded into a small set of batched command
+// buffers, each submission (to the transfer queue) signals a timeline semaphore value which retires its slice of the
+// ring. The producer only blocks when the ring (or the batch set) is exhausted, the frame waits on the timeline
+// on the device.
+// Not thread-safe, owned by a single uploading thread at a time.
+// ---------------------------------------------------------
+
+struct StagingAllocation
+{
+    VkBuffer     buffer;
+    VkDeviceSize offset;
+    void*        pMappedData;
+};
+
+class StagingRing
+{
+public:
+
+    explicit StagingRing(RenderContext* pRenderContext);
+
+    StagingRing(const StagingRing&)            = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    // Reserve ring memory for a copy, the size may not exceed GetMaxAllocationSize().
+    StagingAllocation Allocate(VkDeviceSize size, VkDeviceSize alignment = 16U);
+
+    // Command buffer of the batch currently recording (only valid until the next Allocate / Flush).
+    VkCommandBuffer GetCommandBuffer();
+
+    // Hand a resource over to the graphics queue once all of its copies are recorded.
+    // Images are transitioned to the given layout, the frame acquiring them waits for the batch to complete.
+    void Release(VkBuffer buffer);
+    void Release(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels = 1U);
+
+    // Generate the mip chain of a released image on the graphics queue, right after the frame acquires it
+    // (the first level must be released in transfer source layout).
+    void GenerateMips(const MipGeneration& mipGeneration);
+
+    // Submit the recorded batch, if any. Its uploads are visible to every frame submitted afterwards.
+    void Flush();
+
+    // Submit the recorded batch and wait for every submitted batch to complete.
+    void WaitIdle();
+
+    void Destroy();
+
+    [[nodiscard]] inline VkDeviceSize GetMaxAllocationSize() const { return m_Buffer.bufferInfo.size / 4U; }
+
+private:
+
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        // Timeline value signaled by the last submission of the batch.
+        uint64_t signalValue {};
+
+        bool recording {};
+
+        // Graphics queue side of the ownership transfers recorded in the batch.
+        std::vector<VkBufferMemoryBarrier2> acquireBufferBarriers;
+        std::vector<VkImageMemoryBarrier2>  acquireImageBarriers;
+        std::vector<MipGeneration>          mipGenerations;
+    };
+
+    struct InFlightBatch
+    {
+        uint64_t signalValue;
+
+        // Ring position (monotonic) released once the batch completes.
+        uint64_t ringEnd;
+    };
+
+    void BeginBatch();
+
+    // Release completed batches, optionally blocking on the oldest one.
+    void Retire(bool wait);
+
+    RenderContext* m_RenderContext;
+
+    Buffer     m_Buffer;
+    std::byte* m_pMappedData {};
+
+    // Monotonic write / release positions (modulo the ring size).
+    uint64_t m_Head {};
+    uint64_t m_Tail {};
+
+    VkCommandPool                         m_CommandPool = VK_NULL_HANDLE;
+    std::array<Batch, kStagingBatchCount> m_Batches {};
+    uint32_t                              m_BatchIndex {};
+    uint64_t                              m_BatchBegin {};
+    std::deque<InFlightBatch>             m_InFlightBatches;
+
+    VkSemaphore m_TimelineSemaphore = VK_NULL_HANDLE;
+    uint64_t    m_SubmitValue {};
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <TextureCompression.h>
+
+// Persistent on-disk cache of block compressed material images (full mip chain), stored as DDS files.
+// Files are content addressed by a hash of the source image file and the role it is compressed for.
+// ---------------------------------------------------------
+
+class TextureCache
+{
+public:
+
+    // NOTE: Bump whenever the encoders or the mip generation change.
+    constexpr static uint32_t kVersion = 1U;
+
+    constexpr static const char* kDefaultDirectory = "TextureCache";
+
+    explicit TextureCache(std::filesystem::path directory = kDefaultDirectory);
+
+    // Combine the source file contents and the role into a single hash.
+    static uint64_t ComputeContentHash(std::span<const std::byte> fileData, TextureRole role);
+
+    // Returns true and reads the blocks into the texture if a valid cache file exists for the hash.
+    bool TryLoad(uint64_t contentHash, CompressedTexture* pTexture);
+
+    // Serialize a compressed texture (written to a temporary file and then moved into place).
+    void Store(uint64_t contentHash, const CompressedTexture& texture);
+
+    // Accumulate the time spent producing a texture, bucketed by whether the cache was hit.
+    void RecordLoadTime(bool cacheHit, std::chrono::nanoseconds duration);
+
+    // Write the hit-rate / timing report to the log and reset the counters.
+    void ReportStatistics();
+
+private:
+
+    [[nodiscard]] std::filesystem::path GetFilePath(uint64_t contentHash) const;
+
+    std::filesystem::path m_Directory;
+
+    std::atomic<uint32_t> m_HitCount {};
+    std::atomic<uint32_t> m_MissCount {};
+    std::atomic<uint64_t> m_HitTimeNs {};
+    std::atomic<uint64_t> m_MissTimeNs {};
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+// CPU block compression of decoded material images (full mip chain, encoded in parallel over rows of 4x4 blocks).
+// The format follows the role of the texture:
+//   Albedo -> BC1 (opaque) / BC7 (with alpha), sRGB
+//   Mask   -> BC4 (red channel)
+//   Normal -> BC5 (red / green channels)
+// ---------------------------------------------------------
+
+enum class TextureRole : uint32_t
+{
+    Albedo,
+    Mask,
+    Normal
+};
+
+struct CompressedTexture
+{
+    VkFormat   format = VK_FORMAT_UNDEFINED;
+    VkExtent3D extent {};
+    uint32_t   mipLevels {};
+
+    // Bytes per 4x4 block (8 for BC1 / BC4, 16 for BC5 / BC7).
+    uint32_t bytesPerBlock {};
+
+    // Levels packed tightly one after another.
+    std::vector<std::byte> blocks;
+};
+
+// Block compressed formats a device must be able to sample for textures to be compressed (or transcoded) to them.
+constexpr std::array<VkFormat, 4> kCompressedTextureFormats = { VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+                                                                VK_FORMAT_BC4_UNORM_BLOCK,
+                                                                VK_FORMAT_BC5_UNORM_BLOCK,
+                                                                VK_FORMAT_BC7_SRGB_BLOCK };
+
+// Generate the mip chain of an 8-bit RGBA image and compress every level.
+void CompressTexture(const uint8_t* pTexels, VkExtent3D extent, TextureRole role, CompressedTexture* pTexture);
+
+#endif
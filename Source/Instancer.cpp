@@ -0,0 +1,113 @@
+#include <Common.h>
+#include <Instancer.h>
+
+void Instancer::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam, HdDirtyBits* pDirtyBits)
+{
+    _UpdateInstancer(pSceneDelegate, pDirtyBits);
+
+    if (!HdChangeTracker::IsAnyPrimvarDirty(*pDirtyBits, GetId()))
+        return;
+
+    for (const auto& primvar : pSceneDelegate->GetPrimvarDescriptors(GetId(), HdInterpolationInstance))
+    {
+        if (!HdChangeTracker::IsPrimvarDirty(*pDirtyBits, GetId(), primvar.name))
+            continue;
+
+        auto value = pSceneDelegate->Get(GetId(), primvar.name);
+
+        if (!value.IsEmpty())
+            m_Primvars[primvar.name] = value;
+    }
+}
+
+VtMatrix4dArray Instancer::ComputeInstanceTransforms(const SdfPath& prototypeId)
+{
+    auto instancerTransform = GetDelegate()->GetInstancerTransform(GetId());
+    auto instanceIndices    = GetDelegate()->GetInstanceIndices(GetId(), prototypeId);
+
+    VtMatrix4dArray transforms(instanceIndices.size(), instancerTransform);
+
+    auto TryGetPrimvar = [this]<typename T>(const TfToken& token, T* pArray)
+    {
+        auto it = m_Primvars.find(token);
+
+        if (it == m_Primvars.end() || !it->second.IsHolding<T>())
+            return false;
+
+        *pArray = it->second.UncheckedGet<T>();
+        return true;
+    };
+
+    // Row-vector convention: instanceTransform * scale * rotate * translate * instancerTransform.
+
+    VtVec3fArray translations;
+    if (TryGetPrimvar(HdInstancerTokens->instanceTranslations, &translations))
+    {
+        for (size_t instanceIndex = 0U; instanceIndex < instanceIndices.size(); instanceIndex++)
+        {
+            if (static_cast<size_t>(instanceIndices[instanceIndex]) < translations.size())
+                transforms[instanceIndex] = GfMatrix4d(1.0).SetTranslate(GfVec3d(translations[instanceIndices[instanceIndex]])) * transforms[instanceIndex];
+        }
+    }
+
+    VtQuathArray rotationsH;
+    VtQuatfArray rotationsF;
+    if (TryGetPrimvar(HdInstancerTokens->instanceRotations, &rotationsH) || TryGetPrimvar(HdInstancerTokens->instanceRotations, &rotationsF))
+    {
+        for (size_t instanceIndex = 0U; instanceIndex < instanceIndices.size(); instanceIndex++)
+        {
+            auto index = static_cast<size_t>(instanceIndices[instanceIndex]);
+
+            GfQuatd rotation;
+
+            if (index < rotationsH.size())
+                rotation = GfQuatd(rotationsH[index]);
+            else if (index < rotationsF.size())
+                rotation = GfQuatd(rotationsF[index]);
+            else
+                continue;
+
+            transforms[instanceIndex] = GfMatrix4d(1.0).SetRotate(rotation) * transforms[instanceIndex];
+        }
+    }
+
+    VtVec3fArray scales;
+    if (TryGetPrimvar(HdInstancerTokens->instanceScales, &scales))
+    {
+        for (size_t instanceIndex = 0U; instanceIndex < instanceIndices.size(); instanceIndex++)
+        {
+            if (static_cast<size_t>(instanceIndices[instanceIndex]) < scales.size())
+                transforms[instanceIndex] = GfMatrix4d(1.0).SetScale(GfVec3d(scales[instanceIndices[instanceIndex]])) * transforms[instanceIndex];
+        }
+    }
+
+    VtMatrix4dArray instanceTransforms;
+    if (TryGetPrimvar(HdInstancerTokens->instanceTransforms, &instanceTransforms))
+    {
+        for (size_t instanceIndex = 0U; instanceIndex < instanceIndices.size(); instanceIndex++)
+        {
+            if (static_cast<size_t>(instanceIndices[instanceIndex]) < instanceTransforms.size())
+                transforms[instanceIndex] = instanceTransforms[instanceIndices[instanceIndex]] * transforms[instanceIndex];
+        }
+    }
+
+    if (GetParentId().IsEmpty())
+        return transforms;
+
+    // Nested instancing: every instance of this level is instanced again by the parent.
+    auto* pParentInstancer = static_cast<Instancer*>(GetDelegate()->GetRenderIndex().GetInstancer(GetParentId()));
+
+    Check(pParentInstancer != nullptr, "Failed to find the parent instancer.");
+
+    auto parentTransforms = pParentInstancer->ComputeInstanceTransforms(GetId());
+
+    VtMatrix4dArray flattenedTransforms(parentTransforms.size() * transforms.size());
+
+    for (size_t parentIndex = 0U; parentIndex < parentTransforms.size(); parentIndex++)
+    {
+        for (size_t instanceIndex = 0U; instanceIndex < transforms.size(); instanceIndex++)
+            flattenedTransforms[parentIndex * transforms.size() + instanceIndex] = transforms[instanceIndex] * parentTransforms[parentIndex];
+    }
+
+    return flattenedTransforms;
+}
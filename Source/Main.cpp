@@ -234,6 +234,13 @@ int main()
 
                 ImGui::SameLine();
                 ImGui::Text("| VRAM: %f MB", static_cast<float>(memoryStats.total.statistics.allocationBytes) / (1024.0F * 1024.0F));
+
+                uint64_t usageBytes  = 0U;
+                uint64_t budgetBytes = 0U;
+                GetDeviceMemoryBudget(pRenderContext->GetAllocator(), usageBytes, budgetBytes);
+
+                ImGui::SameLine();
+                ImGui::Text("| Budget: %.0f / %.0f MB", static_cast<double>(usageBytes >> 20U), static_cast<double>(budgetBytes >> 20U));
             }
 
             ImGui::End();
@@ -3,6 +3,7 @@
 #include <RenderDelegate.h>
 #include <ResourceRegistry.h>
 #include <RenderContext.h>
+#include <PixelConversion.h>
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXFormat/XmlIo.h>
@@ -11,8 +12,6 @@
 #include <MaterialXGenGlsl/VkShaderGenerator.h>
 #include <MaterialXGenShader/Shader.h>
 
-#include <cstddef>
-
 // #define MATERIAL_DEBUG_PRINT_NETWORK
 
 HdDirtyBits Material::GetInitialDirtyBitsMask() const { return HdChangeTracker::AllSceneDirtyBits; }
@@ -43,30 +42,58 @@ void TraceNodeRecursive(HdMaterialNetwork2* pNetwork, HdMaterialNode2* pNode, ui
     }
 }
 
+// Authored value of an input of a node (the fallback if the input is connected, or not authored).
 template <typename T>
-T TryGetSingleParameterForInput(const char* inputName, HdMaterialNetwork2* pNetwork, HdMaterialNode2* pNode)
+T TryGetInputValue(const char* inputName, const HdMaterialNode2* pNode, T fallback)
 {
-    for (const auto& input : pNode->inputConnections)
+    auto parameter = pNode->parameters.find(TfToken(inputName));
+
+    if (parameter == pNode->parameters.end() || !parameter->second.IsHolding<T>())
+        return fallback;
+
+    return parameter->second.UncheckedGet<T>();
+}
+
+// First image file found upstream of a node (through any node in between, e.g. a normal map).
+SdfAssetPath TryFindUpstreamAsset(HdMaterialNetwork2* pNetwork, HdMaterialNode2* pNode)
+{
+    for (const auto& parameter : pNode->parameters)
     {
-        if (strcmp(input.first.GetText(), inputName) != 0)
-            continue;
+        if (parameter.second.IsHolding<SdfAssetPath>())
+            return parameter.second.UncheckedGet<SdfAssetPath>();
+    }
 
+    for (const auto& input : pNode->inputConnections)
+    {
         for (const auto& connection : input.second)
         {
             auto node = pNetwork->nodes.find(connection.upstreamNode);
 
-            // Follow the connection to the next node.
-            return TryGetSingleParameterForInput<T>(inputName, pNetwork, &node->second);
+            if (node == pNetwork->nodes.end())
+                continue;
+
+            if (auto assetPath = TryFindUpstreamAsset(pNetwork, &node->second); !assetPath.GetResolvedPath().empty())
+                return assetPath;
         }
     }
 
-    for (const auto& parameter : pNode->parameters)
-    {
-        if (parameter.second.IsHolding<T>())
-            return parameter.second.Get<T>();
-    }
+    return {};
+}
+
+// Image file sampled by an input of a node (empty if the input is constant).
+SdfAssetPath TryGetTextureForInput(const char* inputName, HdMaterialNetwork2* pNetwork, HdMaterialNode2* pNode)
+{
+    auto input = pNode->inputConnections.find(TfToken(inputName));
+
+    if (input == pNode->inputConnections.end() || input->second.empty())
+        return {};
+
+    auto node = pNetwork->nodes.find(input->second.front().upstreamNode);
 
-    return T();
+    if (node == pNetwork->nodes.end())
+        return {};
+
+    return TryFindUpstreamAsset(pNetwork, &node->second);
 }
 
 #if 0
@@ -102,72 +129,6 @@ void ReconstructMaterialXDocument(HdMaterialNetwork2* pNetwork, const SdfPath& r
 
 #endif
 
-class ImageLoader
-{
-public:
-
-    explicit ImageLoader(const SdfAssetPath& imagePath) : m_Format(VK_FORMAT_UNDEFINED)
-    {
-        if (std::filesystem::path(imagePath.GetResolvedPath()).extension().string() == ".dds")
-        {
-            Check(dds::readFile(imagePath.GetResolvedPath(), &m_DDSImage) == 0U, "Failed to load DDS image to memory.");
-
-            // Read out the image data.
-            m_Width  = static_cast<int>(m_DDSImage.width);
-            m_Height = static_cast<int>(m_DDSImage.height);
-
-            m_BytesPerPixel = dds::getBitsPerPixel(m_DDSImage.format) >> 3U;
-
-            // Extract pointer to image data.
-            m_Data = m_DDSImage.mipmaps.front().data();
-
-            // Extract the format.
-            m_Format = dds::getVulkanFormat(m_DDSImage.format, m_DDSImage.supportsAlpha);
-
-            // We did not load with STB.
-            m_IsSTB = false;
-        }
-        else
-        {
-            int channels = 0;
-            m_Data       = stbi_load(imagePath.GetResolvedPath().c_str(), &m_Width, &m_Height, &channels, 0U);
-
-            if (channels != 4U)
-                InterleaveImageAlpha(reinterpret_cast<stbi_uc**>(&m_Data), m_Width, m_Height, channels);
-
-            // Hardcode for now...
-            m_Format = VK_FORMAT_R8G8B8A8_SRGB;
-
-            // The hardcoded format is 4-bytes per pixel.
-            m_BytesPerPixel = 4U;
-
-            // Need to make sure we free the memory in case of STB.
-            m_IsSTB = true;
-        }
-    }
-
-    ~ImageLoader()
-    {
-        if (m_Data != nullptr && m_IsSTB)
-            stbi_image_free(m_Data);
-    }
-
-    [[nodiscard]] inline const void*     GetData() const { return m_Data; }
-    [[nodiscard]] inline GfVec2i         GetDim() const { return { m_Width, m_Height }; }
-    [[nodiscard]] inline const VkFormat& GetFormat() const { return m_Format; }
-    [[nodiscard]] inline const uint32_t& GetStride() const { return m_BytesPerPixel; }
-
-private:
-
-    VkFormat   m_Format {};
-    uint32_t   m_BytesPerPixel {};
-    void*      m_Data {};
-    int        m_Width {};
-    int        m_Height {};
-    bool       m_IsSTB {};
-    dds::Image m_DDSImage {};
-};
-
 void Material::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam, HdDirtyBits* pDirtyBits)
 {
     if ((*pDirtyBits & HdChangeTracker::AllSceneDirtyBits) == 0U)
@@ -175,8 +136,6 @@ void Material::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam
 
     PROFILE_START("Sync Material");
 
-    std::lock_guard<std::mutex> renderContextLock(m_Owner->GetRenderContextMutex());
-
     auto id = GetId();
 
     auto materialResource = pSceneDelegate->GetMaterialResource(id);
@@ -206,19 +165,69 @@ void Material::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParam
     // Obtain the resource registry + push the material request.
     auto pResourceRegistry = std::static_pointer_cast<ResourceRegistry>(pSceneDelegate->GetRenderIndex().GetResourceRegistry());
 
-    // Load images.
-    ImageLoader albedo(TryGetSingleParameterForInput<SdfAssetPath>(kMaterialInputBaseColor, &network, &rootNode->second));
+    auto* pSurfaceNode = &rootNode->second;
+
+    // Textured inputs, and the role each image is decoded (and compressed) for.
+    constexpr std::array<std::pair<const char*, TextureRole>, kMaterialTextureCount> kTextureInputs = {
+        { { kMaterialInputBaseColor, TextureRole::Albedo },
+          { kMaterialInputMetallic, TextureRole::Mask },
+          { kMaterialInputRoughness, TextureRole::Mask },
+          { kMaterialInputNormal, TextureRole::Normal },
+          { kMaterialInputEmissionColor, TextureRole::Albedo } }
+    };
 
     // Make a request to the image pool.
-    MaterialRequest request { this };
+    MaterialRequest request { GetId().GetHash() };
+
+    for (uint32_t textureIndex = 0U; textureIndex < kMaterialTextureCount; textureIndex++)
+    {
+        const auto& [inputName, role] = kTextureInputs.at(textureIndex);
+
+        auto texturePath = TryGetTextureForInput(inputName, &network, pSurfaceNode);
+        auto textureKey  = ResourceRegistry::ComputeTextureKey(texturePath.GetResolvedPath(), role);
+
+        request.textureKeys.at(textureIndex) = textureKey;
+
+        // Textures shared by several materials (e.g. atlases) are only decoded by the first one to reference them, off
+        // the sync thread (the material uses the factor alone until the commit uploads it).
+        if (textureKey != 0U && pResourceRegistry->ClaimTexture(textureKey))
+            pResourceRegistry->PushTextureDecode(textureKey, texturePath.GetResolvedPath(), role);
+    }
+
+    // Factors (Standard Surface defaults if not authored), textured inputs are scaled by their weight only.
     {
-        request.albedo = { nullptr, albedo.GetStride(), albedo.GetDim(), albedo.GetFormat() };
+        auto IsTextured = [&](MaterialTexture texture) { return request.textureKeys.at(static_cast<uint32_t>(texture)) != 0U; };
+
+        auto base          = TryGetInputValue<float>(kMaterialInputBase, pSurfaceNode, 0.8F);
+        auto baseColor     = IsTextured(MaterialTexture::BaseColor) ? GfVec3f(1.0F) : TryGetInputValue(kMaterialInputBaseColor, pSurfaceNode, GfVec3f(1.0F));
+        auto opacity       = TryGetInputValue(kMaterialInputOpacity, pSurfaceNode, GfVec3f(1.0F));
+        auto emission      = TryGetInputValue<float>(kMaterialInputEmission, pSurfaceNode, 0.0F);
+        auto emissionColor = IsTextured(MaterialTexture::Emissive) ? GfVec3f(1.0F) : TryGetInputValue(kMaterialInputEmissionColor, pSurfaceNode, GfVec3f(1.0F));
+        auto metalness     = IsTextured(MaterialTexture::Metalness) ? 1.0F : TryGetInputValue<float>(kMaterialInputMetallic, pSurfaceNode, 0.0F);
+        auto roughness     = IsTextured(MaterialTexture::Roughness) ? 1.0F : TryGetInputValue<float>(kMaterialInputRoughness, pSurfaceNode, 0.2F);
+
+        baseColor *= base;
+        emissionColor *= emission;
+
+        std::array<float, 10> factors = { baseColor[0],     baseColor[1],     baseColor[2],     (opacity[0] + opacity[1] + opacity[2]) / 3.0F,
+                                          emissionColor[0], emissionColor[1], emissionColor[2], metalness,
+                                          roughness,        1.0F };
+
+        std::array<uint16_t, 10> halves {};
+        ConvertFloatToHalf(factors.data(), halves.data(), factors.size());
+
+        request.parameters.baseColor   = { halves[0], halves[1], halves[2] };
+        request.parameters.opacity     = halves[3];
+        request.parameters.emissive    = { halves[4], halves[5], halves[6] };
+        request.parameters.metalness   = halves[7];
+        request.parameters.roughness   = halves[8];
+        request.parameters.normalScale = halves[9];
+
+        // Resolved by the commit once the textures are resident.
+        request.parameters.textureIndices.fill(kMaterialTextureNone);
     }
-    pResourceRegistry->PushMaterialRequest(request);
 
-    // Copy into the mapped pointers.
-    if (albedo.GetFormat() != VK_FORMAT_UNDEFINED)
-        memcpy(request.albedo.data, albedo.GetData(), static_cast<size_t>(albedo.GetStride() * albedo.GetDim()[0]) * albedo.GetDim()[1]);
+    pResourceRegistry->PushMaterialRequest(request);
 
     // Clear the dirty bits.
     *pDirtyBits &= ~HdChangeTracker::AllSceneDirtyBits;
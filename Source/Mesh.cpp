@@ -1,11 +1,18 @@
 #include <Common.h>
+#include <Instancer.h>
 #include <Mesh.h>
+#include <MeshProcessing.h>
 #include <RenderContext.h>
 #include <RenderDelegate.h>
 #include <ResourceRegistry.h>
 
 #include <cstddef>
 
+// Anything else (transform, material binding) is patched in place by the draw item scatter pass.
+// Instancing changes are included since the per-instance transform buffer is rebuilt on commit.
+constexpr HdDirtyBits kGeometryDirtyBits = HdChangeTracker::DirtyPoints | HdChangeTracker::DirtyTopology | HdChangeTracker::DirtyPrimvar |
+                                           HdChangeTracker::DirtyExtent | HdChangeTracker::DirtyInstancer | HdChangeTracker::DirtyInstanceIndex;
+
 HdDirtyBits Mesh::GetInitialDirtyBitsMask() const { return HdChangeTracker::AllSceneDirtyBits; }
 
 void Mesh::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParams, HdDirtyBits* pDirtyBits, const TfToken& reprToken)
@@ -13,10 +20,65 @@ void Mesh::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParams, H
     if ((*pDirtyBits & HdChangeTracker::AllSceneDirtyBits) == 0U)
         return;
 
-    std::lock_guard<std::mutex> renderContextLock(m_Owner->GetRenderContextMutex());
-
     PROFILE_START("Sync Mesh");
 
+    auto* pResourceRegistry = std::static_pointer_cast<ResourceRegistry>(m_Owner->GetResourceRegistry()).get();
+
+    // Pull in the instance transforms (if this mesh is a prototype).
+    _UpdateInstancer(pSceneDelegate, pDirtyBits);
+    HdInstancer::_SyncInstancerAndParents(pSceneDelegate->GetRenderIndex(), GetInstancerId());
+
+    if (*pDirtyBits & (HdChangeTracker::DirtyInstancer | HdChangeTracker::DirtyInstanceIndex))
+    {
+        m_InstanceTransforms.clear();
+
+        if (IsInstanced())
+        {
+            auto* pInstancer = static_cast<Instancer*>(pSceneDelegate->GetRenderIndex().GetInstancer(GetInstancerId()));
+
+            for (const auto& instanceTransform : pInstancer->ComputeInstanceTransforms(GetId()))
+                m_InstanceTransforms.emplace_back(instanceTransform);
+        }
+    }
+
+    // Only geometry changes need the mesh to be re-processed and re-uploaded.
+    bool geometryDirty = (*pDirtyBits & kGeometryDirtyBits) != 0U;
+
+    if (geometryDirty && !SyncGeometry(pSceneDelegate, pResourceRegistry))
+    {
+        *pDirtyBits &= ~HdChangeTracker::AllSceneDirtyBits;
+
+        PROFILE_END;
+        return;
+    }
+
+    // Store material binding (if any)
+    if (*pDirtyBits & HdChangeTracker::DirtyMaterialId)
+        m_MaterialHash = pSceneDelegate->GetMaterialId(GetId()).GetHash();
+
+    if (*pDirtyBits & HdChangeTracker::DirtyTransform)
+    {
+        // Get the world matrix.
+        m_LocalToWorld = GfMatrix4f(pSceneDelegate->GetTransform(GetId()));
+
+        auto localToWorldTranspose = m_LocalToWorld.GetTranspose();
+
+        // Copy everything except the final row.
+        memcpy(&m_LocalToWorld3x4, &localToWorldTranspose, sizeof(FfxFloat32x3x4));
+    }
+
+    // Patch the meta-data of the already uploaded draw item in place.
+    if (!geometryDirty && m_DrawItemHandle.IsValid() && (*pDirtyBits & (HdChangeTracker::DirtyTransform | HdChangeTracker::DirtyMaterialId)))
+        pResourceRegistry->PushDrawItemUpdate(m_DrawItemHandle);
+
+    // Clear the dirty bits.
+    *pDirtyBits &= ~HdChangeTracker::AllSceneDirtyBits;
+
+    PROFILE_END;
+}
+
+bool Mesh::SyncGeometry(HdSceneDelegate* pSceneDelegate, ResourceRegistry* pResourceRegistry)
+{
     auto SafeGet = [&]<typename T>(const TfToken& token, T& data)
     {
         VtValue pValue = pSceneDelegate->Get(GetId(), token);
@@ -34,89 +96,192 @@ void Mesh::Sync(HdSceneDelegate* pSceneDelegate, HdRenderParam* pRenderParams, H
     VtVec3fArray pPoints;
     SafeGet(HdTokens->points, pPoints);
 
-    auto extents = pSceneDelegate->Get(GetId(), TfToken("extent")).UncheckedGet<VtVec3fArray>();
+    VtVec3fArray extents;
+    SafeGet(TfToken("extent"), extents);
 
-    // Extract AABB (needed by Brixelizer acceleration structure instances).
-    memcpy(&m_AABB.min[0], extents[0].data(), 3U * sizeof(float));
-    memcpy(&m_AABB.max[0], extents[1].data(), 3U * sizeof(float));
-
-    if (pPoints.empty())
+    // Extract AABB (needed by Brixelizer acceleration structure instances and the position quantization).
+    if (extents.size() == 2U)
     {
-        // Early exit on mesh prims with invalid topology.
-        *pDirtyBits &= ~HdChangeTracker::AllSceneDirtyBits;
+        memcpy(&m_AABB.min[0], extents[0].data(), 3U * sizeof(float));
+        memcpy(&m_AABB.max[0], extents[1].data(), 3U * sizeof(float));
+    }
+    else
+    {
+        std::fill_n(m_AABB.min, 3U, FLT_MAX);
+        std::fill_n(m_AABB.max, 3U, -FLT_MAX);
+    }
 
-        return;
+    // The authored extent is not guaranteed to be up to date with the points, grow it to cover all of them.
+    for (const auto& point : pPoints)
+    {
+        for (uint32_t axis = 0U; axis < 3U; axis++)
+        {
+            m_AABB.min[axis] = std::min(m_AABB.min[axis], point[axis]);
+            m_AABB.max[axis] = std::max(m_AABB.max[axis], point[axis]);
+        }
     }
 
+    // Early exit on mesh prims with invalid topology.
+    if (pPoints.empty())
+        return false;
+
     // Extract topology information (mainly to get face count).
     HdMeshTopology topology = pSceneDelegate->GetMeshTopology(GetId());
 
-    // Initialize the mesh util.
-    HdMeshUtil meshUtil(&topology, GetId());
+    VtVec2fArray pTexCoordsFaceVarying;
+    SafeGet(TfToken("primvars:st"), pTexCoordsFaceVarying);
+
+    auto& meshCache = pResourceRegistry->GetMeshCache();
 
-    // Reconstruct the indices / mesh topology.
-    VtIntArray   trianglePrimitiveParams;
-    VtVec3iArray triangles;
-    meshUtil.ComputeTriangleIndices(&triangles, &trianglePrimitiveParams);
+    auto syncStartTime = std::chrono::high_resolution_clock::now();
 
-    VtVec2fArray texCoords;
-    if (pSceneDelegate->Get(GetId(), TfToken("primvars:st")).IsHolding<VtVec2fArray>())
+    auto contentHash = MeshCache::ComputeContentHash(topology, pPoints, pTexCoordsFaceVarying, m_AABB);
+
+    // Re-synced geometry replaces the draw item in its slot.
+    if (!m_DrawItemHandle.IsValid())
+        m_DrawItemHandle = pResourceRegistry->AcquireDrawItemHandle();
+
+    // Identical geometry (duplicated prims, instance prototypes) is processed and uploaded once, by the first prim to claim it.
+    if (!pResourceRegistry->ClaimGeometry(contentHash))
     {
-        // https://graphics.pixar.com/opensubdiv/docs/subdivision_surfaces.html#face-varying-interpolation-rules
-        HdVtBufferSource pTexcoordSource(TfToken("TextureCoordinateSource"),
-                                         VtValue(pSceneDelegate->Get(GetId(), TfToken("primvars:st")).Get<VtVec2fArray>()));
-
-        // Triangule the texture coordinate prim vars.
-        VtValue pTexcoordTriangulationResult;
-        Check(meshUtil.ComputeTriangulatedFaceVaryingPrimvar(pTexcoordSource.GetData(),
-                                                             static_cast<int>(pTexcoordSource.GetNumElements()),
-                                                             pTexcoordSource.GetTupleType().type,
-                                                             &pTexcoordTriangulationResult),
-              "Failed to triangulate texture coordinate list.");
-
-        // Write back the result.
-        texCoords = pTexcoordTriangulationResult.UncheckedGet<VtVec2fArray>();
+        DrawItemRequest request { this, m_DrawItemHandle };
+        {
+            request.contentHash  = contentHash;
+            request.ownsGeometry = false;
+        }
+        pResourceRegistry->PushDrawItemRequest(request);
+
+        return true;
     }
 
-    auto* pResourceRegistry = std::static_pointer_cast<ResourceRegistry>(m_Owner->GetResourceRegistry()).get();
+    // Skip the post-processing entirely if it was already performed in a previous execution of the application.
+    MeshCacheEntry cacheEntry;
 
-    uint64_t sizeBytesI  = sizeof(GfVec3i) * triangles.size();
-    uint64_t sizeBytesV  = sizeof(GfVec3f) * pPoints.size();
-    uint64_t sizeBytesST = sizeof(GfVec2f) * texCoords.size();
+    bool cacheHit = meshCache.TryLoad(GetId(), contentHash, &cacheEntry);
 
-    // Fetch the allocation needed.
-    DrawItemRequest request { this };
+    if (cacheHit)
     {
-        request.indexBufferSize    = sizeBytesI;
-        request.vertexBufferSize   = sizeBytesV;
-        request.texcoordBufferSize = sizeBytesST;
+        auto streamI  = cacheEntry.GetStream(MeshCacheStream::Index);
+        auto streamV  = cacheEntry.GetStream(MeshCacheStream::Vertex);
+        auto streamST = cacheEntry.GetStream(MeshCacheStream::Texcoord);
+        auto streamML = cacheEntry.GetStream(MeshCacheStream::Meshlet);
+        auto streamLD = cacheEntry.GetStream(MeshCacheStream::LOD);
+
+        // Fetch the allocation needed.
+        DrawItemRequest request { this, m_DrawItemHandle };
+        {
+            request.contentHash        = contentHash;
+            request.ownsGeometry       = true;
+            request.indexBufferSize    = streamI.size();
+            request.vertexBufferSize   = streamV.size();
+            request.texcoordBufferSize = streamST.size();
+            request.meshletBufferSize  = streamML.size();
+            request.lodBufferSize      = streamLD.size();
+        }
+        pResourceRegistry->PushDrawItemRequest(request);
+
+        // Copy straight from the mapped file into the pool.
+        memcpy(request.pIndexBufferHost, streamI.data(), streamI.size());
+        memcpy(request.pVertexBufferHost, streamV.data(), streamV.size());
+        memcpy(request.pTexcoordBufferHost, streamST.data(), streamST.size());
+        memcpy(request.pMeshletBufferHost, streamML.data(), streamML.size());
+        memcpy(request.pLODBufferHost, streamLD.data(), streamLD.size());
+
+        spdlog::info("Loaded Cached Mesh: {}", GetId().GetText());
     }
-    pResourceRegistry->PushDrawItemRequest(request);
+    else
+    {
+        // Initialize the mesh util.
+        HdMeshUtil meshUtil(&topology, GetId());
 
-    // Copy into the pool.
-    memcpy(request.pVertexBufferHost, pPoints.data(), sizeBytesV);
-    memcpy(request.pIndexBufferHost, triangles.data(), sizeBytesI);
-    memcpy(request.pTexcoordBufferHost, texCoords.data(), sizeBytesST);
+        // Reconstruct the indices / mesh topology.
+        VtIntArray   trianglePrimitiveParams;
+        VtVec3iArray triangles;
+        meshUtil.ComputeTriangleIndices(&triangles, &trianglePrimitiveParams);
 
-    spdlog::info("Pre-processed Mesh: {}", GetId().GetText());
+        VtVec2fArray texCoords;
+        if (!pTexCoordsFaceVarying.empty())
+        {
+            // https://graphics.pixar.com/opensubdiv/docs/subdivision_surfaces.html#face-varying-interpolation-rules
+            HdVtBufferSource pTexcoordSource(TfToken("TextureCoordinateSource"), VtValue(pTexCoordsFaceVarying));
+
+            // Triangule the texture coordinate prim vars.
+            VtValue pTexcoordTriangulationResult;
+            Check(meshUtil.ComputeTriangulatedFaceVaryingPrimvar(pTexcoordSource.GetData(),
+                                                                 static_cast<int>(pTexcoordSource.GetNumElements()),
+                                                                 pTexcoordSource.GetTupleType().type,
+                                                                 &pTexcoordTriangulationResult),
+                  "Failed to triangulate texture coordinate list.");
+
+            // Write back the result.
+            texCoords = pTexcoordTriangulationResult.UncheckedGet<VtVec2fArray>();
+        }
 
-    // TODO(parsa): Can serialize the post-processed mesh to disk to speed up future executions of the application.
+        // Share a single index buffer between the position and texture coordinate streams.
+        WeldVertexStreams(&triangles, &pPoints, &texCoords);
+
+#ifdef USE_MESH_OPTIMIZER
+        MeshOptimizeStatistics optimizeStatistics {};
+        OptimizeMesh(&triangles, &pPoints, &texCoords, &optimizeStatistics);
+
+        spdlog::info("Optimized Mesh: {} | ACMR: {:.3f} -> {:.3f} | Vertices: {} -> {}",
+                     GetId().GetText(),
+                     optimizeStatistics.acmrBefore,
+                     optimizeStatistics.acmrAfter,
+                     optimizeStatistics.vertexCountBefore,
+                     optimizeStatistics.vertexCountAfter);
+#endif
+
+        // Simplify into levels of detail and partition each into clusters for GPU culling (re-orders the triangles).
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshLOD> lods;
+        BuildLODChain(&triangles, pPoints, &meshlets, &lods);
+
+#ifdef USE_QUANTIZED_VERTEX_STREAMS
+        QuantizedVertexStreams quantizedStreams;
+        QuantizeVertexStreams(pPoints, texCoords, m_AABB, &quantizedStreams);
+
+        auto streamV  = std::as_bytes(std::span(quantizedStreams.positions));
+        auto streamST = std::as_bytes(std::span(quantizedStreams.texCoords));
+#else
+        auto streamV  = std::as_bytes(std::span(pPoints.cdata(), pPoints.size()));
+        auto streamST = std::as_bytes(std::span(texCoords.cdata(), texCoords.size()));
+#endif
+
+        auto streamI  = std::as_bytes(std::span(triangles.cdata(), triangles.size()));
+        auto streamML = std::as_bytes(std::span(meshlets));
+        auto streamLD = std::as_bytes(std::span(lods));
+
+        // Fetch the allocation needed.
+        DrawItemRequest request { this, m_DrawItemHandle };
+        {
+            request.contentHash        = contentHash;
+            request.ownsGeometry       = true;
+            request.indexBufferSize    = streamI.size();
+            request.vertexBufferSize   = streamV.size();
+            request.texcoordBufferSize = streamST.size();
+            request.meshletBufferSize  = streamML.size();
+            request.lodBufferSize      = streamLD.size();
+        }
+        pResourceRegistry->PushDrawItemRequest(request);
 
-    // Store material binding (if any)
-    m_MaterialHash = pSceneDelegate->GetMaterialId(GetId()).GetHash();
+        // Copy into the pool.
+        memcpy(request.pVertexBufferHost, streamV.data(), streamV.size());
+        memcpy(request.pIndexBufferHost, streamI.data(), streamI.size());
+        memcpy(request.pTexcoordBufferHost, streamST.data(), streamST.size());
+        memcpy(request.pMeshletBufferHost, streamML.data(), streamML.size());
+        memcpy(request.pLODBufferHost, streamLD.data(), streamLD.size());
 
-    // Get the world matrix.
-    m_LocalToWorld = GfMatrix4f(pSceneDelegate->GetTransform(GetId()));
+        // Serialize the post-processed mesh to disk to speed up future executions of the application.
+        meshCache.Store(GetId(), contentHash, { streamI, streamV, streamST, streamML, streamLD });
 
-    auto localToWorldTranspose = m_LocalToWorld.GetTranspose();
+        spdlog::info("Pre-processed Mesh: {}", GetId().GetText());
+    }
 
-    // Copy everything except the final row.
-    memcpy(&m_LocalToWorld3x4, &localToWorldTranspose, sizeof(FfxFloat32x3x4));
+    meshCache.RecordSyncTime(cacheHit, std::chrono::high_resolution_clock::now() - syncStartTime);
 
-    // Clear the dirty bits.
-    *pDirtyBits &= ~HdChangeTracker::AllSceneDirtyBits;
+    return true;
 
-    PROFILE_END;
 }
 
 HdDirtyBits Mesh::_PropagateDirtyBits(HdDirtyBits bits) const { return bits; }
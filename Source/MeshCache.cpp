@@ -0,0 +1,272 @@
+#include <Common.h>
+#include <MeshCache.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File Layout
+// ------------------------------------------------------------
+
+constexpr uint32_t kMeshCacheMagic       = 0x4853454DU; // 'MESH'
+constexpr size_t   kMeshCacheStreamCount = static_cast<size_t>(MeshCacheStream::Count);
+constexpr uint64_t kMeshCacheAlignment   = 16U;
+
+struct MeshCacheStreamRange
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct MeshCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t contentHash;
+
+    std::array<MeshCacheStreamRange, kMeshCacheStreamCount> streams;
+};
+
+// Cache Entry Implementation
+// ------------------------------------------------------------
+
+std::span<const std::byte> MeshCacheEntry::GetStream(MeshCacheStream stream) const
+{
+    const auto* pHeader = reinterpret_cast<const MeshCacheHeader*>(m_View);
+
+    const auto& range = pHeader->streams.at(static_cast<size_t>(stream));
+
+    return { m_View + range.offset, range.size }; // NOLINT
+}
+
+void MeshCacheEntry::Release()
+{
+#ifdef _WIN32
+    if (m_View != nullptr)
+        UnmapViewOfFile(m_View);
+
+    if (m_MappingHandle != nullptr)
+        CloseHandle(m_MappingHandle);
+
+    if (m_FileHandle != nullptr && m_FileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_FileHandle);
+#else
+    if (m_View != nullptr)
+        munmap(const_cast<std::byte*>(m_View), m_ViewSize);
+#endif
+
+    m_View          = nullptr;
+    m_ViewSize      = 0U;
+    m_FileHandle    = nullptr;
+    m_MappingHandle = nullptr;
+}
+
+// Mesh Cache Implementation
+// ------------------------------------------------------------
+
+MeshCache::MeshCache(std::filesystem::path directory) : m_Directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_Directory, error);
+
+    if (error)
+        spdlog::warn("Failed to create mesh cache directory: {}", m_Directory.string());
+}
+
+uint64_t MeshCache::ComputeContentHash(const HdMeshTopology& topology, const VtVec3fArray& points, const VtVec2fArray& texCoords, const FfxBrixelizerAABB& aabb)
+{
+    uint64_t hash = topology.ComputeHash();
+
+    hash = ArchHash64(reinterpret_cast<const char*>(points.cdata()), points.size() * sizeof(GfVec3f), hash);
+    hash = ArchHash64(reinterpret_cast<const char*>(texCoords.cdata()), texCoords.size() * sizeof(GfVec2f), hash);
+
+#ifdef USE_MESH_OPTIMIZER
+    // Optimized and un-optimized streams must not be mixed up.
+    hash = TfHash::Combine(hash, TfToken("MeshOptimizer"));
+#endif
+
+#ifdef USE_QUANTIZED_VERTEX_STREAMS
+    // Same for the compact vertex format, whose positions are relative to the AABB.
+    hash = TfHash::Combine(hash, TfToken("QuantizedVertexStreams"));
+    hash = ArchHash64(reinterpret_cast<const char*>(&aabb), sizeof(FfxBrixelizerAABB), hash);
+#endif
+
+    // Invalidate the cache when the file layout changes.
+    return TfHash::Combine(hash, kVersion);
+}
+
+std::filesystem::path MeshCache::GetFilePath(const SdfPath& primPath) const
+{
+    const auto& primPathString = primPath.GetString();
+
+    return m_Directory / std::format("{:016x}.mesh", ArchHash64(primPathString.data(), primPathString.size()));
+}
+
+bool MeshCache::TryLoad(const SdfPath& primPath, uint64_t contentHash, MeshCacheEntry* pEntry)
+{
+    pEntry->Release();
+
+    auto filePath = GetFilePath(primPath);
+
+    auto Miss = [&]()
+    {
+        pEntry->Release();
+        m_MissCount++;
+        return false;
+    };
+
+    std::error_code error;
+    auto            fileSize = std::filesystem::file_size(filePath, error);
+
+    if (error || fileSize < sizeof(MeshCacheHeader))
+        return Miss();
+
+#ifdef _WIN32
+    pEntry->m_FileHandle =
+        CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (pEntry->m_FileHandle == INVALID_HANDLE_VALUE)
+        return Miss();
+
+    pEntry->m_MappingHandle = CreateFileMappingW(pEntry->m_FileHandle, nullptr, PAGE_READONLY, 0U, 0U, nullptr);
+
+    if (pEntry->m_MappingHandle == nullptr)
+        return Miss();
+
+    pEntry->m_View = static_cast<const std::byte*>(MapViewOfFile(pEntry->m_MappingHandle, FILE_MAP_READ, 0U, 0U, 0U));
+#else
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+    if (fileDescriptor < 0)
+        return Miss();
+
+    void* pView = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    // The mapping keeps its own reference to the file.
+    close(fileDescriptor);
+
+    pEntry->m_View = pView != MAP_FAILED ? static_cast<const std::byte*>(pView) : nullptr;
+#endif
+
+    if (pEntry->m_View == nullptr)
+        return Miss();
+
+    pEntry->m_ViewSize = fileSize;
+
+    // Validate the header.
+    const auto* pHeader = reinterpret_cast<const MeshCacheHeader*>(pEntry->m_View);
+
+    if (pHeader->magic != kMeshCacheMagic || pHeader->version != kVersion || pHeader->contentHash != contentHash)
+        return Miss();
+
+    for (const auto& range : pHeader->streams)
+    {
+        if (range.offset + range.size > fileSize)
+            return Miss();
+    }
+
+    m_HitCount++;
+
+    return true;
+}
+
+void MeshCache::Store(const SdfPath&                                                                             primPath,
+                      uint64_t                                                                                   contentHash,
+                      const std::array<std::span<const std::byte>, static_cast<size_t>(MeshCacheStream::Count)>& streams)
+{
+    MeshCacheHeader header {};
+    {
+        header.magic       = kMeshCacheMagic;
+        header.version     = kVersion;
+        header.contentHash = contentHash;
+    }
+
+    auto AlignUp = [](uint64_t value) { return (value + kMeshCacheAlignment - 1U) & ~(kMeshCacheAlignment - 1U); };
+
+    // Lay out the streams after the header.
+    uint64_t offset = AlignUp(sizeof(MeshCacheHeader));
+
+    for (size_t streamIndex = 0U; streamIndex < kMeshCacheStreamCount; streamIndex++)
+    {
+        // Empty streams point at the start of the file so that their range always validates.
+        if (streams.at(streamIndex).empty())
+            continue;
+
+        header.streams.at(streamIndex) = { offset, streams.at(streamIndex).size() };
+
+        offset = AlignUp(offset + streams.at(streamIndex).size());
+    }
+
+    auto filePath     = GetFilePath(primPath);
+    auto filePathTemp = filePath;
+    filePathTemp += std::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream file(filePathTemp, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            spdlog::warn("Failed to open mesh cache file for writing: {}", filePathTemp.string());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+
+        for (size_t streamIndex = 0U; streamIndex < kMeshCacheStreamCount; streamIndex++)
+        {
+            const auto& range = header.streams.at(streamIndex);
+
+            file.seekp(static_cast<std::streamoff>(range.offset));
+            file.write(reinterpret_cast<const char*>(streams.at(streamIndex).data()), static_cast<std::streamsize>(range.size));
+        }
+
+        if (!file.good())
+        {
+            spdlog::warn("Failed to write mesh cache file: {}", filePathTemp.string());
+            return;
+        }
+    }
+
+    // Move the complete file into place so that readers never observe a partially written file.
+    std::error_code error;
+    std::filesystem::rename(filePathTemp, filePath, error);
+
+    if (error)
+    {
+        std::filesystem::remove(filePathTemp, error);
+        spdlog::warn("Failed to commit mesh cache file: {}", filePath.string());
+    }
+}
+
+void MeshCache::RecordSyncTime(bool cacheHit, std::chrono::nanoseconds duration)
+{
+    (cacheHit ? m_HitTimeNs : m_MissTimeNs) += static_cast<uint64_t>(duration.count());
+}
+
+void MeshCache::ReportStatistics()
+{
+    auto hitCount  = m_HitCount.exchange(0U);
+    auto missCount = m_MissCount.exchange(0U);
+    auto hitTime   = static_cast<double>(m_HitTimeNs.exchange(0U)) * 1e-6;
+    auto missTime  = static_cast<double>(m_MissTimeNs.exchange(0U)) * 1e-6;
+
+    if (hitCount + missCount == 0U)
+        return;
+
+    spdlog::info("Mesh Cache: {} hits / {} misses ({:.1f}% hit rate) | Hit: {:.2f} ms ({:.3f} ms avg) | Miss: {:.2f} ms ({:.3f} ms avg)",
+                 hitCount,
+                 missCount,
+                 100.0 * hitCount / (hitCount + missCount),
+                 hitTime,
+                 hitCount != 0U ? hitTime / hitCount : 0.0,
+                 missTime,
+                 missCount != 0U ? missTime / missCount : 0.0);
+}
@@ -0,0 +1,320 @@
+#include <Common.h>
+#include <MeshProcessing.h>
+
+// Cache size used for the ACMR report (FIFO model, representative of current desktop hardware).
+constexpr uint32_t kVertexCacheSize = 16U;
+
+// Overdraw optimization may degrade vertex cache efficiency by up to this factor.
+constexpr float kOverdrawThreshold = 1.05F;
+
+// Meshlet limits (triangle count must be divisible by four for meshoptimizer).
+constexpr uint32_t kMeshletMaxVertices  = 64U;
+constexpr uint32_t kMeshletMaxTriangles = 124U;
+constexpr float    kMeshletConeWeight   = 0.25F;
+
+// Each level of detail targets this fraction of the previous level's triangles.
+constexpr float    kLODReductionRatio = 0.5F;
+constexpr float    kLODTargetError    = 0.05F;
+constexpr uint32_t kLODMinTriangles   = 128U;
+
+// Stop the chain once a level fails to remove at least this fraction of the previous level's triangles.
+constexpr float kLODMinReduction = 0.15F;
+
+void WeldVertexStreams(VtVec3iArray* pTriangles, VtVec3fArray* pPoints, VtVec2fArray* pTexCoords)
+{
+    auto indexCount = pTriangles->size() * 3U;
+
+    if (indexCount == 0U || pPoints->empty())
+        return;
+
+    bool hasTexCoords = pTexCoords->size() == indexCount;
+
+    // Expand the positions to one entry per triangle corner so that both streams are face-varying.
+    VtVec3fArray cornerPoints(indexCount);
+
+    const auto* pIndices = reinterpret_cast<const uint32_t*>(pTriangles->cdata());
+
+    for (size_t cornerIndex = 0U; cornerIndex < indexCount; cornerIndex++)
+        cornerPoints[cornerIndex] = pPoints->cdata()[pIndices[cornerIndex]];
+
+    std::vector<meshopt_Stream> streams = { { cornerPoints.cdata(), sizeof(GfVec3f), sizeof(GfVec3f) } };
+
+    if (hasTexCoords)
+        streams.push_back({ pTexCoords->cdata(), sizeof(GfVec2f), sizeof(GfVec2f) });
+
+    // Hash the (position, st) tuples of every corner into a list of unique vertices.
+    std::vector<uint32_t> remap(indexCount);
+
+    auto vertexCount = meshopt_generateVertexRemapMulti(remap.data(), nullptr, indexCount, indexCount, streams.data(), streams.size());
+
+    VtVec3fArray points(vertexCount);
+    meshopt_remapVertexBuffer(points.data(), cornerPoints.cdata(), indexCount, sizeof(GfVec3f), remap.data());
+
+    if (hasTexCoords)
+    {
+        VtVec2fArray texCoords(vertexCount);
+        meshopt_remapVertexBuffer(texCoords.data(), pTexCoords->cdata(), indexCount, sizeof(GfVec2f), remap.data());
+
+        *pTexCoords = std::move(texCoords);
+    }
+    else
+        pTexCoords->clear();
+
+    // Write back the results.
+    memcpy(pTriangles->data(), remap.data(), sizeof(uint32_t) * indexCount);
+    *pPoints = std::move(points);
+}
+
+void OptimizeMesh(VtVec3iArray* pTriangles, VtVec3fArray* pPoints, VtVec2fArray* pTexCoords, MeshOptimizeStatistics* pStatistics)
+{
+    auto indexCount  = pTriangles->size() * 3U;
+    auto vertexCount = pPoints->size();
+
+    if (indexCount == 0U || vertexCount == 0U)
+        return;
+
+    bool hasTexCoords = pTexCoords->size() == vertexCount;
+
+    std::vector<uint32_t> indices(indexCount);
+    memcpy(indices.data(), pTriangles->cdata(), sizeof(uint32_t) * indexCount);
+
+    pStatistics->vertexCountBefore = static_cast<uint32_t>(vertexCount);
+    pStatistics->acmrBefore        = meshopt_analyzeVertexCache(indices.data(), indexCount, vertexCount, kVertexCacheSize, 0U, 0U).acmr;
+
+    // 1) Re-order triangles for the post-transform vertex cache, then for overdraw.
+    std::vector<uint32_t> optimizedIndices(indexCount);
+    meshopt_optimizeVertexCache(optimizedIndices.data(), indices.data(), indexCount, vertexCount);
+
+    meshopt_optimizeOverdraw(indices.data(),
+                             optimizedIndices.data(),
+                             indexCount,
+                             pPoints->cdata()->data(),
+                             vertexCount,
+                             sizeof(GfVec3f),
+                             kOverdrawThreshold);
+
+    // 2) Re-order vertices in the order they are first referenced for vertex fetch locality.
+    std::vector<uint32_t> remap(vertexCount);
+
+    auto fetchVertexCount = meshopt_optimizeVertexFetchRemap(remap.data(), indices.data(), indexCount, vertexCount);
+
+    meshopt_remapIndexBuffer(indices.data(), indices.data(), indexCount, remap.data());
+
+    VtVec3fArray fetchPoints(fetchVertexCount);
+    meshopt_remapVertexBuffer(fetchPoints.data(), pPoints->cdata(), vertexCount, sizeof(GfVec3f), remap.data());
+
+    if (hasTexCoords)
+    {
+        VtVec2fArray fetchTexCoords(fetchVertexCount);
+        meshopt_remapVertexBuffer(fetchTexCoords.data(), pTexCoords->cdata(), vertexCount, sizeof(GfVec2f), remap.data());
+
+        *pTexCoords = std::move(fetchTexCoords);
+    }
+
+    pStatistics->vertexCountAfter = static_cast<uint32_t>(fetchVertexCount);
+    pStatistics->acmrAfter        = meshopt_analyzeVertexCache(indices.data(), indexCount, fetchVertexCount, kVertexCacheSize, 0U, 0U).acmr;
+
+    // Write back the results.
+    memcpy(pTriangles->data(), indices.data(), sizeof(uint32_t) * indexCount);
+    *pPoints = std::move(fetchPoints);
+}
+
+void BuildMeshlets(VtVec3iArray* pTriangles, const VtVec3fArray& points, std::vector<Meshlet>* pMeshlets)
+{
+    pMeshlets->clear();
+
+    auto indexCount = pTriangles->size() * 3U;
+
+    if (indexCount == 0U || points.empty())
+        return;
+
+    std::vector<uint32_t> indices(indexCount);
+    memcpy(indices.data(), pTriangles->cdata(), sizeof(uint32_t) * indexCount);
+
+    auto meshletBound = meshopt_buildMeshletsBound(indexCount, kMeshletMaxVertices, kMeshletMaxTriangles);
+
+    std::vector<meshopt_Meshlet> meshlets(meshletBound);
+    std::vector<uint32_t>        meshletVertices(meshletBound * kMeshletMaxVertices);
+    std::vector<uint8_t>         meshletTriangles(meshletBound * kMeshletMaxTriangles * 3U);
+
+    auto meshletCount = meshopt_buildMeshlets(meshlets.data(),
+                                              meshletVertices.data(),
+                                              meshletTriangles.data(),
+                                              indices.data(),
+                                              indexCount,
+                                              points.cdata()->data(),
+                                              points.size(),
+                                              sizeof(GfVec3f),
+                                              kMeshletMaxVertices,
+                                              kMeshletMaxTriangles,
+                                              kMeshletConeWeight);
+
+    // Flatten the meshlet-local triangles back into a regular index buffer.
+    std::vector<uint32_t> meshletIndices;
+    meshletIndices.reserve(indexCount);
+
+    pMeshlets->resize(meshletCount);
+
+    for (size_t meshletIndex = 0U; meshletIndex < meshletCount; meshletIndex++)
+    {
+        const auto& meshlet = meshlets[meshletIndex];
+
+        auto bounds = meshopt_computeMeshletBounds(&meshletVertices[meshlet.vertex_offset],
+                                                   &meshletTriangles[meshlet.triangle_offset],
+                                                   meshlet.triangle_count,
+                                                   points.cdata()->data(),
+                                                   points.size(),
+                                                   sizeof(GfVec3f));
+
+        auto& deviceMeshlet = pMeshlets->at(meshletIndex);
+        {
+            deviceMeshlet.center         = GfVec3f(bounds.center[0], bounds.center[1], bounds.center[2]);
+            deviceMeshlet.radius         = bounds.radius;
+            deviceMeshlet.coneApex       = GfVec3f(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+            deviceMeshlet.coneCutoff     = bounds.cone_cutoff;
+            deviceMeshlet.coneAxis       = GfVec3f(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+            deviceMeshlet.triangleOffset = static_cast<uint32_t>(meshletIndices.size() / 3U);
+            deviceMeshlet.triangleCount  = meshlet.triangle_count;
+        }
+
+        for (uint32_t localIndex = 0U; localIndex < meshlet.triangle_count * 3U; localIndex++)
+            meshletIndices.push_back(meshletVertices[meshlet.vertex_offset + meshletTriangles[meshlet.triangle_offset + localIndex]]);
+    }
+
+    Check(meshletIndices.size() == indexCount, "Meshlet partition does not cover the source triangle list.");
+
+    memcpy(pTriangles->data(), meshletIndices.data(), sizeof(uint32_t) * indexCount);
+}
+
+void BuildLODChain(VtVec3iArray* pTriangles, const VtVec3fArray& points, std::vector<Meshlet>* pMeshlets, std::vector<MeshLOD>* pLODs)
+{
+    pMeshlets->clear();
+    pLODs->clear();
+
+    if (pTriangles->empty() || points.empty())
+        return;
+
+    // Converts the relative simplification error to mesh local space.
+    auto errorScale = meshopt_simplifyScale(points.cdata()->data(), points.size(), sizeof(GfVec3f));
+
+    std::vector<uint32_t> lodIndices(pTriangles->size() * 3U);
+    memcpy(lodIndices.data(), pTriangles->cdata(), sizeof(uint32_t) * lodIndices.size());
+
+    VtVec3iArray         chainTriangles;
+    VtVec3iArray         lodTriangles;
+    std::vector<Meshlet> lodMeshlets;
+
+    float lodError = 0.0F;
+
+    for (uint32_t lodIndex = 0U; lodIndex < kMaxLODCount; lodIndex++)
+    {
+        if (lodIndex > 0U)
+        {
+            if (lodIndices.size() / 3U < kLODMinTriangles)
+                break;
+
+            auto targetIndexCount = static_cast<size_t>(static_cast<float>(lodIndices.size() / 3U) * kLODReductionRatio) * 3U;
+            auto maxIndexCount    = static_cast<size_t>(static_cast<float>(lodIndices.size()) * (1.0F - kLODMinReduction));
+
+            std::vector<uint32_t> simplifiedIndices(lodIndices.size());
+
+            // Simplify from the previous level, so that the chain is cheap to build and the errors accumulate.
+            float resultError = 0.0F;
+
+            auto indexCount = meshopt_simplify(simplifiedIndices.data(),
+                                               lodIndices.data(),
+                                               lodIndices.size(),
+                                               points.cdata()->data(),
+                                               points.size(),
+                                               sizeof(GfVec3f),
+                                               targetIndexCount,
+                                               kLODTargetError,
+                                               0U,
+                                               &resultError);
+
+            // Topology preserving simplification stalls on meshes with many borders, fall back to the sloppy variant.
+            if (indexCount > maxIndexCount)
+            {
+                indexCount = meshopt_simplifySloppy(simplifiedIndices.data(),
+                                                    lodIndices.data(),
+                                                    lodIndices.size(),
+                                                    points.cdata()->data(),
+                                                    points.size(),
+                                                    sizeof(GfVec3f),
+                                                    targetIndexCount,
+                                                    kLODTargetError,
+                                                    &resultError);
+            }
+
+            if (indexCount == 0U || indexCount > maxIndexCount)
+                break;
+
+            simplifiedIndices.resize(indexCount);
+
+            lodIndices = std::move(simplifiedIndices);
+            lodError  += resultError * errorScale;
+        }
+
+        lodTriangles.resize(lodIndices.size() / 3U);
+        memcpy(lodTriangles.data(), lodIndices.data(), sizeof(uint32_t) * lodIndices.size());
+
+        BuildMeshlets(&lodTriangles, points, &lodMeshlets);
+
+        MeshLOD lod;
+        {
+            lod.triangleOffset = static_cast<uint32_t>(chainTriangles.size());
+            lod.triangleCount  = static_cast<uint32_t>(lodTriangles.size());
+            lod.meshletOffset  = static_cast<uint32_t>(pMeshlets->size());
+            lod.meshletCount   = static_cast<uint32_t>(lodMeshlets.size());
+            lod.error          = lodError;
+        }
+        pLODs->push_back(lod);
+
+        // Meshlet triangle ranges are relative to the level, rebase them into the chain.
+        for (auto& meshlet : lodMeshlets)
+        {
+            meshlet.triangleOffset += lod.triangleOffset;
+            pMeshlets->push_back(meshlet);
+        }
+
+        chainTriangles.insert(chainTriangles.end(), lodTriangles.begin(), lodTriangles.end());
+    }
+
+    *pTriangles = std::move(chainTriangles);
+}
+
+void GetPositionDequantization(const FfxBrixelizerAABB& aabb, GfVec3f* pScale, GfVec3f* pOffset)
+{
+    for (uint32_t axis = 0U; axis < 3U; axis++)
+    {
+        (*pOffset)[axis] = aabb.min[axis];
+        (*pScale)[axis]  = std::max(aabb.max[axis] - aabb.min[axis], FLT_MIN);
+    }
+}
+
+void QuantizeVertexStreams(const VtVec3fArray& points, const VtVec2fArray& texCoords, const FfxBrixelizerAABB& aabb, QuantizedVertexStreams* pStreams)
+{
+    GfVec3f scale, offset;
+    GetPositionDequantization(aabb, &scale, &offset);
+
+    pStreams->positions.resize(points.size());
+
+    for (size_t vertexIndex = 0U; vertexIndex < points.size(); vertexIndex++)
+    {
+        auto& position = pStreams->positions[vertexIndex];
+
+        // The AABB covers every point (see Mesh::Sync), the clamp only absorbs rounding.
+        for (uint32_t axis = 0U; axis < 3U; axis++)
+            position[axis] = static_cast<uint16_t>(meshopt_quantizeUnorm((points[vertexIndex][axis] - offset[axis]) / scale[axis], 16));
+
+        position[3] = 0U;
+    }
+
+    pStreams->texCoords.resize(texCoords.size());
+
+    for (size_t texCoordIndex = 0U; texCoordIndex < texCoords.size(); texCoordIndex++)
+    {
+        pStreams->texCoords[texCoordIndex] = { meshopt_quantizeHalf(texCoords[texCoordIndex][0]),
+                                               meshopt_quantizeHalf(texCoords[texCoordIndex][1]) };
+    }
+}
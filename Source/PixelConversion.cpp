@@ -0,0 +1,410 @@
+#include <Common.h>
+#include <PixelConversion.h>
+
+// Instruction sets usable by the conversions, detected once.
+// ---------------------------------------------------------
+
+struct SIMDSupport
+{
+    bool sse41 {};
+    bool avx2 {};
+    bool f16c {};
+};
+
+static SIMDSupport DetectSIMDSupport()
+{
+    SIMDSupport support {};
+
+    std::array<int, 4> cpuInfo {};
+    __cpuid(cpuInfo.data(), 0);
+
+    auto maxLeaf = cpuInfo[0];
+
+    if (maxLeaf < 1)
+        return support;
+
+    __cpuid(cpuInfo.data(), 1);
+
+    auto hasSSSE3  = (cpuInfo[2] & (1 << 9)) != 0;
+    auto hasSSE41  = (cpuInfo[2] & (1 << 19)) != 0;
+    auto hasOSSave = (cpuInfo[2] & (1 << 27)) != 0;
+    auto hasAVX    = (cpuInfo[2] & (1 << 28)) != 0;
+    auto hasF16C   = (cpuInfo[2] & (1 << 29)) != 0;
+
+    // The OS must save the YMM registers on context switches.
+    auto hasYMMState = hasOSSave && hasAVX && (_xgetbv(0) & 0x6U) == 0x6U;
+
+    auto hasAVX2 = false;
+
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(cpuInfo.data(), 7, 0);
+        hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
+    }
+
+    support.sse41 = hasSSSE3 && hasSSE41;
+    support.avx2  = support.sse41 && hasYMMState && hasAVX2;
+    support.f16c  = hasYMMState && hasF16C;
+
+    return support;
+}
+
+static const SIMDSupport& GetCPUSupport()
+{
+    static const SIMDSupport kSupport = DetectSIMDSupport();
+    return kSupport;
+}
+
+static std::atomic<PixelConversionISA> s_MaxISA { PixelConversionISA::AVX2 };
+
+// CPU features, masked by the instruction set limit.
+static SIMDSupport GetSIMDSupport()
+{
+    auto maxISA = s_MaxISA.load(std::memory_order_relaxed);
+
+    SIMDSupport support = GetCPUSupport();
+    {
+        support.sse41 &= maxISA >= PixelConversionISA::SSE41;
+        support.avx2  &= maxISA >= PixelConversionISA::AVX2;
+        support.f16c  &= maxISA >= PixelConversionISA::AVX2;
+    }
+    return support;
+}
+
+// Scalar
+// ---------------------------------------------------------
+
+static void ConvertGrayToRGBAScalar(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    for (size_t i = 0U; i < texelCount; i++)
+    {
+        pDestination[i * 4U + 0U] = pSource[i]; // NOLINT R
+        pDestination[i * 4U + 1U] = pSource[i]; // NOLINT G
+        pDestination[i * 4U + 2U] = pSource[i]; // NOLINT B
+        pDestination[i * 4U + 3U] = 255U;       // NOLINT A (fully opaque)
+    }
+}
+
+static void ConvertGrayAlphaToRGBAScalar(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    for (size_t i = 0U; i < texelCount; i++)
+    {
+        pDestination[i * 4U + 0U] = pSource[i * 2U + 0U]; // NOLINT R
+        pDestination[i * 4U + 1U] = pSource[i * 2U + 0U]; // NOLINT G
+        pDestination[i * 4U + 2U] = pSource[i * 2U + 0U]; // NOLINT B
+        pDestination[i * 4U + 3U] = pSource[i * 2U + 1U]; // NOLINT A
+    }
+}
+
+static void ConvertRGBToRGBAScalar(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    for (size_t i = 0U; i < texelCount; i++)
+    {
+        pDestination[i * 4U + 0U] = pSource[i * 3U + 0U]; // NOLINT R
+        pDestination[i * 4U + 1U] = pSource[i * 3U + 1U]; // NOLINT G
+        pDestination[i * 4U + 2U] = pSource[i * 3U + 2U]; // NOLINT B
+        pDestination[i * 4U + 3U] = 255U;                 // NOLINT A (fully opaque)
+    }
+}
+
+static void ConvertUNorm16ToUNorm8Scalar(const uint16_t* pSource, uint8_t* pDestination, size_t channelCount)
+{
+    for (size_t i = 0U; i < channelCount; i++)
+        pDestination[i] = static_cast<uint8_t>(pSource[i] >> 8U); // NOLINT
+}
+
+// Round to nearest even, with overflow to infinity and NaNs kept quiet.
+static uint16_t ConvertFloatToHalfScalar(float value)
+{
+    constexpr uint32_t kFloatInfinity   = 255U << 23U;
+    constexpr uint32_t kHalfOverflow    = (127U + 16U) << 23U;
+    constexpr uint32_t kHalfNormalMin   = 113U << 23U;
+    constexpr uint32_t kHalfDenormMagic = ((127U - 15U) + (23U - 10U) + 1U) << 23U;
+
+    auto bits = std::bit_cast<uint32_t>(value);
+    auto sign = bits & 0x80000000U;
+
+    bits ^= sign;
+
+    uint16_t half = 0U;
+
+    if (bits >= kHalfOverflow)
+    {
+        half = bits > kFloatInfinity ? 0x7E00U : 0x7C00U;
+    }
+    else if (bits < kHalfNormalMin)
+    {
+        // Align the mantissa at the bottom of the float, the addition rounds it.
+        auto denormal = std::bit_cast<float>(bits) + std::bit_cast<float>(kHalfDenormMagic);
+        half          = static_cast<uint16_t>(std::bit_cast<uint32_t>(denormal) - kHalfDenormMagic);
+    }
+    else
+    {
+        auto mantissaOdd = (bits >> 13U) & 1U;
+
+        // Re-bias the exponent and round.
+        bits += ((15U - 127U) << 23U) + 0xFFFU + mantissaOdd;
+        half = static_cast<uint16_t>(bits >> 13U);
+    }
+
+    return static_cast<uint16_t>(half | (sign >> 16U));
+}
+
+static void ConvertFloatToHalfScalar(const float* pSource, uint16_t* pDestination, size_t channelCount)
+{
+    for (size_t i = 0U; i < channelCount; i++)
+        pDestination[i] = ConvertFloatToHalfScalar(pSource[i]); // NOLINT
+}
+
+// SSE4.1
+// ---------------------------------------------------------
+
+static size_t ConvertGrayToRGBASSE41(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+
+    const std::array<__m128i, 4> shuffles = { _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+                                              _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+                                              _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+                                              _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1) };
+
+    size_t i = 0U;
+
+    for (; i + 16U <= texelCount; i += 16U)
+    {
+        auto gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i)); // NOLINT
+
+        for (size_t j = 0U; j < shuffles.size(); j++)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + (i + j * 4U) * 4U), _mm_or_si128(_mm_shuffle_epi8(gray, shuffles[j]), alpha)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertGrayAlphaToRGBASSE41(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto shuffleLow  = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+    const auto shuffleHigh = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+
+    size_t i = 0U;
+
+    for (; i + 8U <= texelCount; i += 8U)
+    {
+        auto grayAlpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * 2U)); // NOLINT
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4U), _mm_shuffle_epi8(grayAlpha, shuffleLow));         // NOLINT
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4U + 16U), _mm_shuffle_epi8(grayAlpha, shuffleHigh)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertRGBToRGBASSE41(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto alpha   = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+    const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    size_t i = 0U;
+
+    // Four texels per iteration, the 16 byte load reads into the next two texels.
+    for (; i + 6U <= texelCount; i += 4U)
+    {
+        auto rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * 3U)); // NOLINT
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i * 4U), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertUNorm16ToUNorm8SSE41(const uint16_t* pSource, uint8_t* pDestination, size_t channelCount)
+{
+    size_t i = 0U;
+
+    for (; i + 16U <= channelCount; i += 16U)
+    {
+        auto low  = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i)), 8);       // NOLINT
+        auto high = _mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i + 8U)), 8); // NOLINT
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), _mm_packus_epi16(low, high)); // NOLINT
+    }
+
+    return i;
+}
+
+// AVX2 (and F16C)
+// ---------------------------------------------------------
+
+static size_t ConvertGrayToRGBAAVX2(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+
+    // Shuffles are per 128-bit lane, both lanes hold the same 16 texels.
+    const auto shuffleLow  = _mm256_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1, 4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1);
+    const auto shuffleHigh = _mm256_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1, 12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1);
+
+    size_t i = 0U;
+
+    for (; i + 16U <= texelCount; i += 16U)
+    {
+        auto gray = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i))); // NOLINT
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + i * 4U), _mm256_or_si256(_mm256_shuffle_epi8(gray, shuffleLow), alpha));         // NOLINT
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + i * 4U + 32U), _mm256_or_si256(_mm256_shuffle_epi8(gray, shuffleHigh), alpha)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertGrayAlphaToRGBAAVX2(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto shuffle = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7, 8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+
+    size_t i = 0U;
+
+    for (; i + 8U <= texelCount; i += 8U)
+    {
+        auto grayAlpha = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + i * 2U))); // NOLINT
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + i * 4U), _mm256_shuffle_epi8(grayAlpha, shuffle)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertRGBToRGBAAVX2(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+
+    // Move the second four texels (bytes 12 - 23) into the upper lane, then expand both lanes.
+    const auto permute = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const auto shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+    size_t i = 0U;
+
+    // Eight texels per iteration, the 32 byte load reads into the next three texels.
+    for (; i + 11U <= texelCount; i += 8U)
+    {
+        auto rgb = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSource + i * 3U)), permute); // NOLINT
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + i * 4U), _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alpha)); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertUNorm16ToUNorm8AVX2(const uint16_t* pSource, uint8_t* pDestination, size_t channelCount)
+{
+    size_t i = 0U;
+
+    for (; i + 32U <= channelCount; i += 32U)
+    {
+        auto low  = _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSource + i)), 8);        // NOLINT
+        auto high = _mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSource + i + 16U)), 8); // NOLINT
+
+        // The pack interleaves the lanes, restore the order of the quadwords.
+        auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDestination + i), packed); // NOLINT
+    }
+
+    return i;
+}
+
+static size_t ConvertFloatToHalfF16C(const float* pSource, uint16_t* pDestination, size_t channelCount)
+{
+    size_t i = 0U;
+
+    for (; i + 8U <= channelCount; i += 8U)
+    {
+        auto half = _mm256_cvtps_ph(_mm256_loadu_ps(pSource + i), _MM_FROUND_TO_NEAREST_INT); // NOLINT
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDestination + i), half); // NOLINT
+    }
+
+    return i;
+}
+
+// Dispatch (the vector loops return the number of elements converted, the scalar loop finishes the tail).
+// ---------------------------------------------------------
+
+void ConvertGrayToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto support = GetSIMDSupport();
+
+    size_t converted = 0U;
+
+    if (support.avx2)
+        converted = ConvertGrayToRGBAAVX2(pSource, pDestination, texelCount);
+    else if (support.sse41)
+        converted = ConvertGrayToRGBASSE41(pSource, pDestination, texelCount);
+
+    ConvertGrayToRGBAScalar(pSource + converted, pDestination + converted * 4U, texelCount - converted); // NOLINT
+}
+
+void ConvertGrayAlphaToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto support = GetSIMDSupport();
+
+    size_t converted = 0U;
+
+    if (support.avx2)
+        converted = ConvertGrayAlphaToRGBAAVX2(pSource, pDestination, texelCount);
+    else if (support.sse41)
+        converted = ConvertGrayAlphaToRGBASSE41(pSource, pDestination, texelCount);
+
+    ConvertGrayAlphaToRGBAScalar(pSource + converted * 2U, pDestination + converted * 4U, texelCount - converted); // NOLINT
+}
+
+void ConvertRGBToRGBA(const uint8_t* pSource, uint8_t* pDestination, size_t texelCount)
+{
+    const auto support = GetSIMDSupport();
+
+    size_t converted = 0U;
+
+    if (support.avx2)
+        converted = ConvertRGBToRGBAAVX2(pSource, pDestination, texelCount);
+    else if (support.sse41)
+        converted = ConvertRGBToRGBASSE41(pSource, pDestination, texelCount);
+
+    ConvertRGBToRGBAScalar(pSource + converted * 3U, pDestination + converted * 4U, texelCount - converted); // NOLINT
+}
+
+void ConvertUNorm16ToUNorm8(const uint16_t* pSource, uint8_t* pDestination, size_t channelCount)
+{
+    const auto support = GetSIMDSupport();
+
+    size_t converted = 0U;
+
+    if (support.avx2)
+        converted = ConvertUNorm16ToUNorm8AVX2(pSource, pDestination, channelCount);
+    else if (support.sse41)
+        converted = ConvertUNorm16ToUNorm8SSE41(pSource, pDestination, channelCount);
+
+    ConvertUNorm16ToUNorm8Scalar(pSource + converted, pDestination + converted, channelCount - converted); // NOLINT
+}
+
+void ConvertFloatToHalf(const float* pSource, uint16_t* pDestination, size_t channelCount)
+{
+    size_t converted = 0U;
+
+    if (GetSIMDSupport().f16c)
+        converted = ConvertFloatToHalfF16C(pSource, pDestination, channelCount);
+
+    ConvertFloatToHalfScalar(pSource + converted, pDestination + converted, channelCount - converted); // NOLINT
+}
+
+// Instruction set selection
+// ---------------------------------------------------------
+
+void SetPixelConversionMaxISA(PixelConversionISA isa) { s_MaxISA.store(isa); }
+
+bool IsPixelConversionISASupported(PixelConversionISA isa)
+{
+    switch (isa)
+    {
+        case PixelConversionISA::SSE41: return GetCPUSupport().sse41;
+        case PixelConversionISA::AVX2:  return GetCPUSupport().avx2;
+        default:                        return true;
+    }
+}
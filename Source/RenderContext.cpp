@@ -1,5 +1,6 @@
 #include <Common.h>
 #include <RenderContext.h>
+#include <StagingRing.h>
 
 RenderContext::RenderContext(uint32_t width, uint32_t height)
 {
@@ -53,7 +54,7 @@ RenderContext::RenderContext(uint32_t width, uint32_t height)
     std::vector<const char*> requiredDeviceExtensions;
     {
         requiredDeviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
-        // requiredDeviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        requiredDeviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
         requiredDeviceExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
         requiredDeviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
         requiredDeviceExtensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
@@ -70,10 +71,19 @@ RenderContext::RenderContext(uint32_t width, uint32_t height)
     }
 
     Check(SelectVulkanPhysicalDevice(m_VKInstance, requiredDeviceExtensions, m_VKDevicePhysical), "Failed to select a Vulkan Physical Device.");
-    Check(GetVulkanQueueIndices(m_VKInstance, m_VKDevicePhysical, m_VKCommandQueueIndex),
+
+    // Real heap budgets for texture eviction (VMA falls back to an estimate without it).
+    bool memoryBudgetSupported = IsDeviceExtensionSupported(m_VKDevicePhysical, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    if (memoryBudgetSupported)
+        requiredDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    else
+        spdlog::warn("{} is not supported, the device memory budget is estimated.", VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    Check(GetVulkanQueueIndices(m_VKInstance, m_VKDevicePhysical, m_VKCommandQueueIndex, m_VKTransferQueueIndex),
           "Failed to obtain the required Vulkan Queue Indices from the physical "
           "device.");
-    Check(CreateVulkanLogicalDevice(m_VKDevicePhysical, requiredDeviceExtensions, m_VKCommandQueueIndex, m_VKDeviceLogical),
+    Check(CreateVulkanLogicalDevice(m_VKDevicePhysical, requiredDeviceExtensions, m_VKCommandQueueIndex, m_VKTransferQueueIndex, m_VKDeviceLogical),
           "Failed to create a Vulkan Logical Device");
 
     volkLoadDevice(m_VKDeviceLogical);
@@ -171,6 +181,9 @@ RenderContext::RenderContext(uint32_t width, uint32_t height)
         Check(vkAllocateCommandBuffers(m_VKDeviceLogical, &vkCommandBufferInfo, &m_VKCommandBuffers.at(frameIndex)),
               "Failed to allocate Vulkan Command Buffers.");
 
+        Check(vkAllocateCommandBuffers(m_VKDeviceLogical, &vkCommandBufferInfo, &m_VKAcquireCommandBuffers.at(frameIndex)),
+              "Failed to allocate Vulkan Command Buffers.");
+
         VkSemaphoreCreateInfo vkSemaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0x0 };
         VkFenceCreateInfo     vkFenceInfo     = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT };
 
@@ -182,10 +195,37 @@ RenderContext::RenderContext(uint32_t width, uint32_t height)
         Check(vkCreateFence(m_VKDeviceLogical, &vkFenceInfo, nullptr, &m_VKInFlightFences.at(frameIndex)), "Failed to create Vulkan Fence.");
     }
 
-    // Obtain Queues (just Graphics for now).
+    // Frame completion timeline.
+    {
+        VkSemaphoreTypeCreateInfo vkSemaphoreTypeInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+        {
+            vkSemaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+            vkSemaphoreTypeInfo.initialValue  = 0U;
+        }
+
+        VkSemaphoreCreateInfo vkSemaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &vkSemaphoreTypeInfo, 0x0 };
+
+        Check(vkCreateSemaphore(m_VKDeviceLogical, &vkSemaphoreInfo, nullptr, &m_VKFrameTimelineSemaphore), "Failed to create Vulkan Semaphore.");
+    }
+
+    // Obtain Queues.
     // ------------------------------------------------
 
     vkGetDeviceQueue(m_VKDeviceLogical, m_VKCommandQueueIndex, 0U, &m_VKCommandQueue);
+    vkGetDeviceQueue(m_VKDeviceLogical, m_VKTransferQueueIndex, 0U, &m_VKTransferQueue);
+
+    if (HasDedicatedTransferQueue())
+    {
+        uint32_t queueFamilyCount = 0U;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_VKDevicePhysical, &queueFamilyCount, nullptr);
+
+        std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_VKDevicePhysical, &queueFamilyCount, queueFamilyProperties.data());
+
+        m_VKTransferGranularity = queueFamilyProperties[m_VKTransferQueueIndex].minImageTransferGranularity;
+
+        spdlog::info("Using dedicated transfer queue family {} for uploads.", m_VKTransferQueueIndex);
+    }
 
     // Create Memory Allocator
     // ------------------------------------------------
@@ -195,12 +235,16 @@ RenderContext::RenderContext(uint32_t width, uint32_t height)
     vmaVulkanFunctions.vkGetDeviceProcAddr   = vkGetDeviceProcAddr;
 
     VmaAllocatorCreateInfo vmaAllocatorInfo = {};
-    vmaAllocatorInfo.flags                  = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT | VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    vmaAllocatorInfo.flags                  = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
     vmaAllocatorInfo.vulkanApiVersion       = VK_API_VERSION_1_3;
     vmaAllocatorInfo.physicalDevice         = m_VKDevicePhysical;
     vmaAllocatorInfo.device                 = m_VKDeviceLogical;
     vmaAllocatorInfo.instance               = m_VKInstance;
     vmaAllocatorInfo.pVulkanFunctions       = &vmaVulkanFunctions;
+
+    if (memoryBudgetSupported)
+        vmaAllocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+
     Check(vmaCreateAllocator(&vmaAllocatorInfo, &m_VKMemoryAllocator), "Failed to create Vulkan Memory Allocator.");
 
     // Create Descriptor Pool
@@ -259,6 +303,8 @@ RenderContext::~RenderContext()
         vkDestroyFence(m_VKDeviceLogical, m_VKInFlightFences.at(frameIndex), nullptr);
     }
 
+    vkDestroySemaphore(m_VKDeviceLogical, m_VKFrameTimelineSemaphore, nullptr);
+
     for (auto& vkImageView : m_VKSwapchainImageViews)
         vkDestroyImageView(m_VKDeviceLogical, vkImageView, nullptr);
 
@@ -336,23 +382,95 @@ void RenderContext::Dispatch(const std::function<void(FrameParams)>& commandsFun
         // Reset the frame fence to re-signal.
         Check(vkResetFences(m_VKDeviceLogical, 1U, &m_VKInFlightFences.at(frameInFlightIndex)), "Failed to reset the frame fence.");
 
-        VkSubmitInfo vkQueueSubmitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        std::vector<VkSemaphoreSubmitInfo>     vkWaitInfos;
+        std::vector<VkCommandBufferSubmitInfo> vkCommandBufferInfos;
+
+        VkSemaphoreSubmitInfo vkImageAvailableWaitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+        {
+            vkImageAvailableWaitInfo.semaphore = m_VKImageAvailableSemaphores.at(frameInFlightIndex);
+            vkImageAvailableWaitInfo.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        }
+        vkWaitInfos.push_back(vkImageAvailableWaitInfo);
+
+        // Take over the uploads completed (or still in flight) on the transfer queue. Collected at submission time so that
+        // anything published before the frame observed its resources is acquired ahead of the frame commands.
+        {
+            std::lock_guard<std::mutex> frameAcquireLock(m_FrameAcquireMutex);
+
+            if (!m_FrameAcquireBufferBarriers.empty() || !m_FrameAcquireImageBarriers.empty() || !m_FrameMipGenerations.empty())
+            {
+                auto& vkAcquireCommandBuffer = m_VKAcquireCommandBuffers.at(frameInFlightIndex);
+
+                Check(vkResetCommandBuffer(vkAcquireCommandBuffer, 0x0), "Failed to reset frame acquire command buffer");
+                Check(vkBeginCommandBuffer(vkAcquireCommandBuffer, &vkCommandBufferBeginInfo), "Failed to open frame acquire command buffer for recording");
+
+                VkDependencyInfo vkDependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+                {
+                    vkDependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_FrameAcquireBufferBarriers.size());
+                    vkDependencyInfo.pBufferMemoryBarriers    = m_FrameAcquireBufferBarriers.data();
+                    vkDependencyInfo.imageMemoryBarrierCount  = static_cast<uint32_t>(m_FrameAcquireImageBarriers.size());
+                    vkDependencyInfo.pImageMemoryBarriers     = m_FrameAcquireImageBarriers.data();
+                }
+                vkCmdPipelineBarrier2(vkAcquireCommandBuffer, &vkDependencyInfo);
+
+                for (const auto& mipGeneration : m_FrameMipGenerations)
+                    VulkanGenerateMips(vkAcquireCommandBuffer, mipGeneration);
+
+                Check(vkEndCommandBuffer(vkAcquireCommandBuffer), "Failed to close frame acquire command buffer for recording");
+
+                vkCommandBufferInfos.push_back({ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, nullptr, vkAcquireCommandBuffer, 0x0 });
+
+                m_FrameAcquireBufferBarriers.clear();
+                m_FrameAcquireImageBarriers.clear();
+                m_FrameMipGenerations.clear();
+            }
+
+            for (const auto& [vkTimelineSemaphore, timelineValue] : m_FrameTimelineWaits)
+            {
+                VkSemaphoreSubmitInfo vkTimelineWaitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+                {
+                    vkTimelineWaitInfo.semaphore = vkTimelineSemaphore;
+                    vkTimelineWaitInfo.value     = timelineValue;
+                    vkTimelineWaitInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                }
+                vkWaitInfos.push_back(vkTimelineWaitInfo);
+            }
+
+            m_FrameTimelineWaits.clear();
+        }
+
+        vkCommandBufferInfos.push_back({ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, nullptr, vkCurrentCommandBuffer, 0x0 });
+
+        VkSemaphoreSubmitInfo vkRenderCompleteSignalInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+        {
+            vkRenderCompleteSignalInfo.semaphore = m_VKRenderCompleteSemaphores.at(frameInFlightIndex);
+            vkRenderCompleteSignalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
 
-        VkPipelineStageFlags vkWaitStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        std::array<VkSemaphoreSubmitInfo, 2> vkSignalInfos = { vkRenderCompleteSignalInfo, { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO } };
+        {
+            vkSignalInfos[1].semaphore = m_VKFrameTimelineSemaphore;
+            vkSignalInfos[1].value     = frameIndex + 1U;
+            vkSignalInfos[1].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        }
 
-        vkQueueSubmitInfo.commandBufferCount   = 1U;
-        vkQueueSubmitInfo.pCommandBuffers      = &vkCurrentCommandBuffer;
-        vkQueueSubmitInfo.waitSemaphoreCount   = 1U;
-        vkQueueSubmitInfo.pWaitSemaphores      = &m_VKImageAvailableSemaphores.at(frameInFlightIndex);
-        vkQueueSubmitInfo.signalSemaphoreCount = 1U;
-        vkQueueSubmitInfo.pSignalSemaphores    = &m_VKRenderCompleteSemaphores.at(frameInFlightIndex);
-        vkQueueSubmitInfo.pWaitDstStageMask    = &vkWaitStageMask;
+        VkSubmitInfo2 vkQueueSubmitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+        {
+            vkQueueSubmitInfo.waitSemaphoreInfoCount   = static_cast<uint32_t>(vkWaitInfos.size());
+            vkQueueSubmitInfo.pWaitSemaphoreInfos      = vkWaitInfos.data();
+            vkQueueSubmitInfo.commandBufferInfoCount   = static_cast<uint32_t>(vkCommandBufferInfos.size());
+            vkQueueSubmitInfo.pCommandBufferInfos      = vkCommandBufferInfos.data();
+            vkQueueSubmitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(vkSignalInfos.size());
+            vkQueueSubmitInfo.pSignalSemaphoreInfos    = vkSignalInfos.data();
+        }
 
         std::lock_guard<std::mutex> commandQueueLock(GetCommandQueueMutex());
 
-        Check(vkQueueSubmit(m_VKCommandQueue, 1U, &vkQueueSubmitInfo, m_VKInFlightFences.at(frameInFlightIndex)),
+        Check(vkQueueSubmit2(m_VKCommandQueue, 1U, &vkQueueSubmitInfo, m_VKInFlightFences.at(frameInFlightIndex)),
               "Failed to submit commands to the Vulkan Graphics Queue.");
 
+        m_FrameSubmitCount.store(frameIndex + 1U);
+
         VkPresentInfoKHR vkQueuePresentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
         {
             vkQueuePresentInfo.waitSemaphoreCount = 1U;
@@ -379,28 +497,52 @@ void RenderContext::Dispatch(const std::function<void(FrameParams)>& commandsFun
 // Misc. helpers.
 // --------------------------------------------------
 
-void RenderContext::CreateCommandPool(VkCommandPool* pCommandPool)
+void RenderContext::CreateCommandPool(VkCommandPool* pCommandPool, uint32_t queueFamilyIndex)
 {
     VkCommandPoolCreateInfo vkCommandPoolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
     {
-        vkCommandPoolInfo.queueFamilyIndex = m_VKCommandQueueIndex;
+        vkCommandPoolInfo.queueFamilyIndex = queueFamilyIndex;
         vkCommandPoolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
     }
     Check(vkCreateCommandPool(m_VKDeviceLogical, &vkCommandPoolInfo, nullptr, pCommandPool), "Failed to create a thread-local Vulkan Command Pool");
 }
 
-void RenderContext::CreateStagingBuffer(VkDeviceSize size, Buffer* pStagingBuffer)
+bool RenderContext::HasPendingFrameAcquires()
 {
-    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.usage              = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.size               = size;
+    std::lock_guard<std::mutex> frameAcquireLock(m_FrameAcquireMutex);
 
-    VmaAllocationCreateInfo allocInfo = {};
-    allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
-    allocInfo.flags                   = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    return !m_FrameAcquireBufferBarriers.empty() || !m_FrameAcquireImageBarriers.empty() || !m_FrameMipGenerations.empty() ||
+           !m_FrameTimelineWaits.empty();
+}
 
-    Check(vmaCreateBuffer(GetAllocator(), &bufferInfo, &allocInfo, &pStagingBuffer->buffer, &pStagingBuffer->bufferAllocation, nullptr),
-          "Failed to create staging buffer memory.");
+void RenderContext::WaitForFrames(uint64_t frameCount)
+{
+    if (frameCount == 0U)
+        return;
+
+    VkSemaphoreWaitInfo vkWaitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    {
+        vkWaitInfo.semaphoreCount = 1U;
+        vkWaitInfo.pSemaphores    = &m_VKFrameTimelineSemaphore;
+        vkWaitInfo.pValues        = &frameCount;
+    }
+    Check(vkWaitSemaphores(m_VKDeviceLogical, &vkWaitInfo, UINT64_MAX), "Failed to wait for the frame timeline.");
+}
+
+void RenderContext::PushFrameAcquire(VkSemaphore                             timelineSemaphore,
+                                     uint64_t                                timelineValue,
+                                     std::span<const VkBufferMemoryBarrier2> bufferBarriers,
+                                     std::span<const VkImageMemoryBarrier2>  imageBarriers,
+                                     std::span<const MipGeneration>          mipGenerations)
+{
+    std::lock_guard<std::mutex> frameAcquireLock(m_FrameAcquireMutex);
+
+    m_FrameAcquireBufferBarriers.insert(m_FrameAcquireBufferBarriers.end(), bufferBarriers.begin(), bufferBarriers.end());
+    m_FrameAcquireImageBarriers.insert(m_FrameAcquireImageBarriers.end(), imageBarriers.begin(), imageBarriers.end());
+    m_FrameMipGenerations.insert(m_FrameMipGenerations.end(), mipGenerations.begin(), mipGenerations.end());
+
+    auto& waitValue = m_FrameTimelineWaits[timelineSemaphore];
+    waitValue       = std::max(waitValue, timelineValue);
 }
 
 void RenderContext::CreateDeviceBufferWithData(CreateDeviceBufferWithDataParams& params)
@@ -424,36 +566,33 @@ void RenderContext::CreateDeviceBufferWithData(CreateDeviceBufferWithDataParams&
     // Keep information about the buffer.
     params.pBufferDevice->bufferInfo = bufferInfo;
 
-    // Copy Host -> Staging Memory.
+    // Copy Host -> Staging -> Device Memory.
     // -----------------------------------------------------
 
-    void* pMappedData = nullptr;
-    Check(vmaMapMemory(GetAllocator(), params.pBufferStaging->bufferAllocation, &pMappedData), "Failed to map a pointer to staging memory.");
-    {
-        // Copy from Host -> Staging memory.
-        memcpy(pMappedData, params.pData, params.size);
-
-        vmaUnmapMemory(GetAllocator(), params.pBufferStaging->bufferAllocation);
-    }
+    UploadBufferData(params.pStagingRing, params.pData, params.size, params.pBufferDevice->buffer, 0U);
 
-    // Copy Staging -> Device Memory.
-    // -----------------------------------------------------
+    params.pStagingRing->Release(params.pBufferDevice->buffer);
+}
 
-    VkCommandBuffer vkCommand = VK_NULL_HANDLE;
-    SingleShotCommandBegin(this, vkCommand, params.commandPool);
+void RenderContext::UploadBufferData(StagingRing* pStagingRing, const void* pData, VkDeviceSize size, VkBuffer buffer, VkDeviceSize bufferOffset)
+{
+    // Large ranges are streamed through the ring in pieces.
+    for (VkDeviceSize offset = 0U; offset < size; offset += pStagingRing->GetMaxAllocationSize())
     {
-        VmaAllocationInfo allocationInfo;
-        vmaGetAllocationInfo(GetAllocator(), params.pBufferDevice->bufferAllocation, &allocationInfo);
+        auto copySize = std::min(size - offset, pStagingRing->GetMaxAllocationSize());
+
+        auto staging = pStagingRing->Allocate(copySize);
+
+        memcpy(staging.pMappedData, static_cast<const std::byte*>(pData) + offset, copySize);
 
         VkBufferCopy copyInfo;
         {
-            copyInfo.srcOffset = 0U;
-            copyInfo.dstOffset = 0U;
-            copyInfo.size      = params.size;
+            copyInfo.srcOffset = staging.offset;
+            copyInfo.dstOffset = bufferOffset + offset;
+            copyInfo.size      = copySize;
         }
-        vkCmdCopyBuffer(vkCommand, params.pBufferStaging->buffer, params.pBufferDevice->buffer, 1U, &copyInfo);
+        vkCmdCopyBuffer(pStagingRing->GetCommandBuffer(), staging.buffer, buffer, 1U, &copyInfo);
     }
-    SingleShotCommandEnd(this, vkCommand);
 }
 
 void RenderContext::CreateDeviceImageWithData(CreateDeviceImageWithDataParams& params)
@@ -463,7 +602,17 @@ void RenderContext::CreateDeviceImageWithData(CreateDeviceImageWithDataParams& p
         return;
 
     // Patch the sType if it wasn't set.
-    params.info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    params.info.sType       = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    params.info.mipLevels   = std::max(params.info.mipLevels, 1U);
+    params.info.arrayLayers = std::max(params.info.arrayLayers, 1U);
+
+    Check(!params.generateMips || params.info.arrayLayers == 1U, "Mip chains are only generated for single layer images.");
+
+    // Levels copied from the data, the rest of the chain is blitted from the first one on the graphics queue.
+    auto uploadMipLevels = params.generateMips ? 1U : params.info.mipLevels;
+
+    if (params.generateMips)
+        params.info.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
     // Create dedicate device memory for the image
     // -----------------------------------------------------
@@ -474,75 +623,177 @@ void RenderContext::CreateDeviceImageWithData(CreateDeviceImageWithDataParams& p
     Check(vmaCreateImage(GetAllocator(), &params.info, &allocInfo, &params.pImageDevice->image, &params.pImageDevice->imageAllocation, nullptr),
           "Failed to create dedicated image memory.");
 
+    params.pImageDevice->imageInfo = params.info;
+
     // Create Image View.
     // -----------------------------------------------------
 
+    // Cube compatible images are viewed as cube maps, other layered images as arrays.
+    auto viewType = params.info.arrayLayers > 1U ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+
+    if ((params.info.flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT) != 0U)
+        viewType = params.info.arrayLayers > 6U ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+
     VkImageViewCreateInfo imageViewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
     {
-        imageViewInfo.viewType         = VK_IMAGE_VIEW_TYPE_2D;
+        imageViewInfo.viewType         = viewType;
         imageViewInfo.image            = params.pImageDevice->image;
         imageViewInfo.format           = params.info.format;
-        imageViewInfo.components       = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-        imageViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0U, 1U, 0U, 1U };
+        imageViewInfo.components       = params.components;
+        imageViewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0U, params.info.mipLevels, 0U, params.info.arrayLayers };
     }
     Check(vkCreateImageView(GetDevice(), &imageViewInfo, nullptr, &params.pImageDevice->imageView), "Failed to create sampled image view.");
 
-    // Copy Host -> Staging Memory.
+    // Copy Host -> Staging -> Device Memory.
     // -----------------------------------------------------
 
-    void* pMappedStagingMemory = nullptr;
-    Check(vmaMapMemory(GetAllocator(), params.pBufferStaging->bufferAllocation, &pMappedStagingMemory), "Failed to map a pointer to staging memory.");
+    // The transitions bracket every band of rows, even when they end up in different batches (barriers are ordered
+    // against all prior / subsequent submissions to the queue). The image is released to the graphics queue at the end.
+    VulkanColorImageBarrier(params.pStagingRing->GetCommandBuffer(),
+                            params.pImageDevice->image,
+                            VK_IMAGE_LAYOUT_UNDEFINED,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            VK_ACCESS_2_NONE,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            0U,
+                            uploadMipLevels);
+
+    // Texel (block) aligned offsets, that are also a multiple of 4 bytes as required for buffer -> image copies.
+    auto alignment = std::lcm(params.bytesPerTexel, static_cast<VkDeviceSize>(4U));
+
+    auto layerCount = params.info.arrayLayers;
+
+    // Offsets of the levels in the data, and in a single staging allocation holding all of them.
+    std::vector<VkDeviceSize> levelDataOffsets(uploadMipLevels + 1U, 0U);
+    std::vector<VkDeviceSize> levelStagingOffsets(uploadMipLevels + 1U, 0U);
+
+    for (uint32_t mipLevel = 0U; mipLevel < uploadMipLevels; mipLevel++)
+    {
+        auto levelBytes = (GetMipChainSize(params.info.extent, params.info.format, params.bytesPerTexel, mipLevel + 1U) -
+                           GetMipChainSize(params.info.extent, params.info.format, params.bytesPerTexel, mipLevel)) *
+                          layerCount;
 
-    // Copy the host image to staging memory.
-    memcpy(pMappedStagingMemory, params.pData, params.bytesPerTexel * params.info.extent.width * params.info.extent.height); // NOLINT
+        levelDataOffsets[mipLevel + 1U]    = levelDataOffsets[mipLevel] + levelBytes;
+        levelStagingOffsets[mipLevel + 1U] = (levelStagingOffsets[mipLevel] + levelBytes + alignment - 1U) / alignment * alignment;
+    }
 
-    vmaUnmapMemory(GetAllocator(), params.pBufferStaging->bufferAllocation);
+    // Images that fit a single staging allocation are copied with one region per level (covering every layer).
+    if (levelStagingOffsets.back() <= params.pStagingRing->GetMaxAllocationSize())
+    {
+        auto staging = params.pStagingRing->Allocate(levelStagingOffsets.back(), alignment);
 
-    // Copy Staging -> Device Memory.
-    // -----------------------------------------------------
+        std::vector<VkBufferImageCopy> bufferImageCopies(uploadMipLevels);
 
-    VkCommandBuffer vkCommand = VK_NULL_HANDLE;
-    SingleShotCommandBegin(this, vkCommand, params.commandPool);
-    {
-        VmaAllocationInfo allocationInfo;
-        vmaGetAllocationInfo(GetAllocator(), params.pImageDevice->imageAllocation, &allocationInfo);
-
-        VulkanColorImageBarrier(vkCommand,
-                                params.pImageDevice->image,
-                                VK_IMAGE_LAYOUT_UNDEFINED,
-                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                VK_ACCESS_2_NONE,
-                                VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                                VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR,
-                                VK_PIPELINE_STAGE_2_TRANSFER_BIT);
-
-        VkBufferImageCopy bufferImageCopyInfo;
+        for (uint32_t mipLevel = 0U; mipLevel < uploadMipLevels; mipLevel++)
         {
-            bufferImageCopyInfo.bufferOffset      = 0U;
-            bufferImageCopyInfo.bufferImageHeight = 0U;
-            bufferImageCopyInfo.bufferRowLength   = 0U;
-            bufferImageCopyInfo.imageExtent       = { static_cast<uint32_t>(params.info.extent.width),
-                                                      static_cast<uint32_t>(params.info.extent.height),
-                                                      1U };
-            bufferImageCopyInfo.imageOffset       = { 0U, 0U, 0U };
-            bufferImageCopyInfo.imageSubresource  = { VK_IMAGE_ASPECT_COLOR_BIT, 0U, 0U, 1U };
+            memcpy(static_cast<std::byte*>(staging.pMappedData) + levelStagingOffsets[mipLevel],     // NOLINT
+                   static_cast<const std::byte*>(params.pData) + levelDataOffsets[mipLevel],         // NOLINT
+                   levelDataOffsets[mipLevel + 1U] - levelDataOffsets[mipLevel]);
+
+            auto& bufferImageCopyInfo = bufferImageCopies[mipLevel];
+            {
+                bufferImageCopyInfo.bufferOffset      = staging.offset + levelStagingOffsets[mipLevel];
+                bufferImageCopyInfo.bufferImageHeight = 0U;
+                bufferImageCopyInfo.bufferRowLength   = 0U;
+                bufferImageCopyInfo.imageExtent       = { std::max(params.info.extent.width >> mipLevel, 1U), std::max(params.info.extent.height >> mipLevel, 1U), 1U };
+                bufferImageCopyInfo.imageOffset       = { 0, 0, 0 };
+                bufferImageCopyInfo.imageSubresource  = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0U, layerCount };
+            }
         }
 
-        vkCmdCopyBufferToImage(vkCommand,
-                               params.pBufferStaging->buffer,
+        vkCmdCopyBufferToImage(params.pStagingRing->GetCommandBuffer(),
+                               staging.buffer,
                                params.pImageDevice->image,
                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                               1U,
-                               &bufferImageCopyInfo);
-
-        VulkanColorImageBarrier(vkCommand,
-                                params.pImageDevice->image,
-                                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                                VK_ACCESS_2_SHADER_READ_BIT,
-                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
-                                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+                               static_cast<uint32_t>(bufferImageCopies.size()),
+                               bufferImageCopies.data());
     }
-    SingleShotCommandEnd(this, vkCommand);
+    else
+    {
+        // Bands must start on the transfer granularity of the upload queue (in texel blocks for compressed formats).
+        auto rowGranularity = GetTransferGranularity().height;
+
+        // Block compressed formats are copied by rows of 4x4 texel blocks.
+        auto blockDim = GetFormatBlockDim(params.info.format);
+
+        const auto* pLevelData = static_cast<const std::byte*>(params.pData);
+
+        for (uint32_t mipLevel = 0U; mipLevel < uploadMipLevels; mipLevel++)
+        {
+            auto levelWidth  = std::max(params.info.extent.width >> mipLevel, 1U);
+            auto levelHeight = std::max(params.info.extent.height >> mipLevel, 1U);
+
+            auto blockRows = (levelHeight + blockDim - 1U) / blockDim;
+
+            auto rowBytes = params.bytesPerTexel * ((levelWidth + blockDim - 1U) / blockDim);
+            auto rowCount = std::max(static_cast<uint32_t>(params.pStagingRing->GetMaxAllocationSize() / rowBytes), 1U);
+
+            rowCount = std::max(rowCount / rowGranularity * rowGranularity, std::min(rowGranularity, blockRows));
+
+            for (uint32_t layer = 0U; layer < layerCount; layer++)
+            {
+                for (uint32_t row = 0U; row < blockRows; row += rowCount)
+                {
+                    auto bandRows = std::min(rowCount, blockRows - row);
+
+                    auto staging = params.pStagingRing->Allocate(rowBytes * bandRows, alignment);
+
+                    memcpy(staging.pMappedData, pLevelData + rowBytes * row, rowBytes * bandRows); // NOLINT
+
+                    // The last band of a level may end on a partial block.
+                    VkBufferImageCopy bufferImageCopyInfo;
+                    {
+                        bufferImageCopyInfo.bufferOffset      = staging.offset;
+                        bufferImageCopyInfo.bufferImageHeight = 0U;
+                        bufferImageCopyInfo.bufferRowLength   = 0U;
+                        bufferImageCopyInfo.imageExtent       = { levelWidth, std::min(bandRows * blockDim, levelHeight - row * blockDim), 1U };
+                        bufferImageCopyInfo.imageOffset       = { 0, static_cast<int32_t>(row * blockDim), 0 };
+                        bufferImageCopyInfo.imageSubresource  = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, layer, 1U };
+                    }
+
+                    vkCmdCopyBufferToImage(params.pStagingRing->GetCommandBuffer(),
+                                           staging.buffer,
+                                           params.pImageDevice->image,
+                                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                           1U,
+                                           &bufferImageCopyInfo);
+                }
+
+                pLevelData += rowBytes * blockRows; // NOLINT
+            }
+        }
+    }
+
+    if (!params.generateMips || params.info.mipLevels == 1U)
+    {
+        params.pStagingRing->Release(params.pImageDevice->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, uploadMipLevels);
+        return;
+    }
+
+    // Only the first level is handed over, the graphics queue blits the rest of the chain from it.
+    params.pStagingRing->Release(params.pImageDevice->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    params.pStagingRing->GenerateMips({ params.pImageDevice->image, params.info.extent, params.info.mipLevels });
+}
+
+bool RenderContext::SupportsMipGeneration(VkFormat format)
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_VKDevicePhysical, format, &formatProperties);
+
+    constexpr VkFormatFeatureFlags kRequiredFeatures =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    return (formatProperties.optimalTilingFeatures & kRequiredFeatures) == kRequiredFeatures;
+}
+
+bool RenderContext::SupportsLinearFiltering(VkFormat format)
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_VKDevicePhysical, format, &formatProperties);
+
+    constexpr VkFormatFeatureFlags kRequiredFeatures = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    return (formatProperties.optimalTilingFeatures & kRequiredFeatures) == kRequiredFeatures;
 }
@@ -1,4 +1,5 @@
 #include <Common.h>
+#include <Instancer.h>
 #include <Material.h>
 #include <Mesh.h>
 #include <RenderContext.h>
@@ -49,8 +50,23 @@ HdSprim* RenderDelegate::CreateSprim(const TfToken& typeId, const SdfPath& sprim
     return nullptr;
 }
 
-void RenderDelegate::DestroyRprim(HdRprim* rPrim) { spdlog::info("Destroying RPrim."); }
-void RenderDelegate::DestroySprim(HdSprim* sprim) { spdlog::info("Destroying SPrim. {}", sprim->GetId().GetText()); }
+HdInstancer* RenderDelegate::CreateInstancer(HdSceneDelegate* delegate, const SdfPath& id) { return new Instancer(delegate, id); }
+
+void RenderDelegate::DestroyInstancer(HdInstancer* instancer) { delete instancer; }
+
+void RenderDelegate::DestroyRprim(HdRprim* rPrim)
+{
+    // The draw item may still be referenced by the commit in flight, the registry deletes the mesh once it is freed.
+    std::static_pointer_cast<ResourceRegistry>(m_ResourceRegistry)->PushDrawItemRelease(static_cast<Mesh*>(rPrim));
+}
+
+void RenderDelegate::DestroySprim(HdSprim* sprim)
+{
+    if (dynamic_cast<Material*>(sprim) != nullptr)
+        std::static_pointer_cast<ResourceRegistry>(m_ResourceRegistry)->PushMaterialRelease(sprim->GetId().GetHash());
+
+    delete sprim;
+}
 
 void RenderDelegate::CommitResources(HdChangeTracker* pChangeTracker)
 {
@@ -1,4 +1,5 @@
 #include <Mesh.h>
+#include <MeshProcessing.h>
 #include <RenderContext.h>
 #include <RenderDelegate.h>
 #include <RenderPass.h>
@@ -31,8 +32,171 @@ void RenderPass::LoadShader(ShaderID shaderID, const char* filePath, const char*
     m_ShaderMap[shaderID] = vkShader;
 };
 
+void RenderPass::DrawItemScatterPassCreate(RenderContext* pRenderContext)
+{
+    // Descriptor Layout
+    // --------------------------------------
+
+    std::vector<VkDescriptorSetLayoutBinding> descriptorLayoutBindings;
+    {
+        // Binding 0: Draw Item Meta-data Updates
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 1: Draw Item Meta-data
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    {
+        descriptorLayoutInfo.bindingCount = static_cast<uint32_t>(descriptorLayoutBindings.size());
+        descriptorLayoutInfo.pBindings    = descriptorLayoutBindings.data();
+        descriptorLayoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+    Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorLayoutInfo, nullptr, &m_DrawItemScatterDescriptorSetLayout),
+          "Failed to create draw item scatter descriptor layout.");
+
+    // Pipeline Layout
+    // --------------------------------------
+
+    VkPushConstantRange pushConstantRange;
+    {
+        pushConstantRange.offset     = 0U;
+        pushConstantRange.size       = sizeof(DrawItemScatterPushConstants);
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    {
+        pipelineInfo.pushConstantRangeCount = 1U;
+        pipelineInfo.pPushConstantRanges    = &pushConstantRange;
+        pipelineInfo.setLayoutCount         = 1U;
+        pipelineInfo.pSetLayouts            = &m_DrawItemScatterDescriptorSetLayout;
+    }
+    Check(vkCreatePipelineLayout(pRenderContext->GetDevice(), &pipelineInfo, nullptr, &m_DrawItemScatterPipelineLayout),
+          "Failed to create pipeline layout for draw item scatter pipeline.");
+
+    // Shaders
+    // --------------------------------------
+
+    VkShaderCreateInfoEXT computeShaderInfo = { VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT };
+    {
+        computeShaderInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        computeShaderInfo.pushConstantRangeCount = 1U;
+        computeShaderInfo.pPushConstantRanges    = &pushConstantRange;
+        computeShaderInfo.setLayoutCount         = 1U;
+        computeShaderInfo.pSetLayouts            = &m_DrawItemScatterDescriptorSetLayout;
+    }
+    LoadShader(ShaderID::DrawItemScatterComp, "DrawItemScatter.comp.spv", "Main", computeShaderInfo);
+}
+
+void RenderPass::ClusterCullPassCreate(RenderContext* pRenderContext)
+{
+    // Descriptor Layout
+    // --------------------------------------
+
+    std::vector<VkDescriptorSetLayoutBinding> descriptorLayoutBindings;
+    {
+        // Binding 0: Meshlets
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 1: Draw Item Meta-data
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 2: Indirect Draw Commands
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(2U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 3: Indirect Draw Counts
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(3U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 4: Draw Item Visibility Feedback
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(4U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 5: Instance Transforms
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(5U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    {
+        descriptorLayoutInfo.bindingCount = static_cast<uint32_t>(descriptorLayoutBindings.size());
+        descriptorLayoutInfo.pBindings    = descriptorLayoutBindings.data();
+        descriptorLayoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+    Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorLayoutInfo, nullptr, &m_ClusterCullDescriptorSetLayout),
+          "Failed to create cluster cull descriptor layout.");
+
+    // Pipeline Layout
+    // --------------------------------------
+
+    VkPushConstantRange pushConstantRange;
+    {
+        pushConstantRange.offset     = 0U;
+        pushConstantRange.size       = sizeof(ClusterCullPushConstants);
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    {
+        pipelineInfo.pushConstantRangeCount = 1U;
+        pipelineInfo.pPushConstantRanges    = &pushConstantRange;
+        pipelineInfo.setLayoutCount         = 1U;
+        pipelineInfo.pSetLayouts            = &m_ClusterCullDescriptorSetLayout;
+    }
+    Check(vkCreatePipelineLayout(pRenderContext->GetDevice(), &pipelineInfo, nullptr, &m_ClusterCullPipelineLayout),
+          "Failed to create pipeline layout for cluster cull pipeline.");
+
+    // Shaders
+    // --------------------------------------
+
+    VkShaderCreateInfoEXT computeShaderInfo = { VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT };
+    {
+        computeShaderInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        computeShaderInfo.pushConstantRangeCount = 1U;
+        computeShaderInfo.pPushConstantRanges    = &pushConstantRange;
+        computeShaderInfo.setLayoutCount         = 1U;
+        computeShaderInfo.pSetLayouts            = &m_ClusterCullDescriptorSetLayout;
+    }
+    LoadShader(ShaderID::ClusterCullComp, "ClusterCull.comp.spv", "Main", computeShaderInfo);
+}
+
 void RenderPass::VisibilityPassCreate(RenderContext* pRenderContext)
 {
+    // Descriptor Layout
+    // --------------------------------------
+
+    std::vector<VkDescriptorSetLayoutBinding> descriptorLayoutBindings;
+    {
+        // Binding 0: Draw Item Meta-data
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE));
+
+        // Binding 1: Instance Transforms
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE));
+
+        // Binding 2: Position Heap
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(2U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE));
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    {
+        descriptorLayoutInfo.bindingCount = static_cast<uint32_t>(descriptorLayoutBindings.size());
+        descriptorLayoutInfo.pBindings    = descriptorLayoutBindings.data();
+        descriptorLayoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+    Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorLayoutInfo, nullptr, &m_VisibilityDescriptorSetLayout),
+          "Failed to create visibility descriptor layout.");
+
     // Pipeline Layout
     // --------------------------------------
 
@@ -47,6 +211,8 @@ void RenderPass::VisibilityPassCreate(RenderContext* pRenderContext)
     {
         pipelineInfo.pushConstantRangeCount = 1U;
         pipelineInfo.pPushConstantRanges    = &pushConstantRange;
+        pipelineInfo.setLayoutCount         = 1U;
+        pipelineInfo.pSetLayouts            = &m_VisibilityDescriptorSetLayout;
     }
     Check(vkCreatePipelineLayout(pRenderContext->GetDevice(), &pipelineInfo, nullptr, &m_VisibilityPipelineLayout),
           "Failed to create pipeline layout for visibility pipeline.");
@@ -61,6 +227,8 @@ void RenderPass::VisibilityPassCreate(RenderContext* pRenderContext)
 
         vertexShaderInfo.pushConstantRangeCount = 1U;
         vertexShaderInfo.pPushConstantRanges    = &pushConstantRange;
+        vertexShaderInfo.setLayoutCount         = 1U;
+        vertexShaderInfo.pSetLayouts            = &m_VisibilityDescriptorSetLayout;
     }
     LoadShader(ShaderID::VisibilityVert, "Visibility.vert.spv", "Vert", vertexShaderInfo);
 
@@ -70,32 +238,11 @@ void RenderPass::VisibilityPassCreate(RenderContext* pRenderContext)
 
         visShaderInfo.pushConstantRangeCount = 1U;
         visShaderInfo.pPushConstantRanges    = &pushConstantRange;
+        visShaderInfo.setLayoutCount         = 1U;
+        visShaderInfo.pSetLayouts            = &m_VisibilityDescriptorSetLayout;
     }
     LoadShader(ShaderID::VisibilityFrag, "Visibility.frag.spv", "Frag", visShaderInfo);
 
-    // Vertex Input Layout
-    // ------------------------------------------------
-
-    VkVertexInputBindingDescription2EXT binding = { VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT };
-
-    {
-        binding.binding   = 0U;
-        binding.stride    = sizeof(GfVec3f);
-        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        binding.divisor   = 1U;
-    }
-    m_VertexInputBindings.push_back(binding);
-
-    VkVertexInputAttributeDescription2EXT attribute = { VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT };
-
-    {
-        attribute.binding  = 0U;
-        attribute.location = 0U;
-        attribute.offset   = 0U;
-        attribute.format   = VK_FORMAT_R32G32B32_SFLOAT;
-    }
-    m_VertexInputAttributes.push_back(attribute);
-
     // Create Visibility Buffer
     // ------------------------------------------------
 
@@ -103,7 +250,8 @@ void RenderPass::VisibilityPassCreate(RenderContext* pRenderContext)
     {
         visibilityBufferInfo.imageType     = VK_IMAGE_TYPE_2D;
         visibilityBufferInfo.arrayLayers   = 1U;
-        visibilityBufferInfo.format        = VK_FORMAT_R32_UINT;
+        // Mesh / primitive ID and instance ID.
+        visibilityBufferInfo.format        = VK_FORMAT_R32G32_UINT;
         visibilityBufferInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
         visibilityBufferInfo.usage         = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
         visibilityBufferInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -176,13 +324,76 @@ void RenderPass::MaterialPassCreate(RenderContext* pRenderContext)
               "Failed to create dedicated buffer memory.");
     };
 
-    const uint32_t kMaxMaterial = 4096U;
-
-    CreateDeviceBuffer(m_MaterialCountBuffer, sizeof(uint32_t) * kMaxMaterial, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR);
-    CreateDeviceBuffer(m_MaterialOffsetBuffer, sizeof(uint32_t) * kMaxMaterial, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR);
+    CreateDeviceBuffer(m_MaterialCountBuffer, sizeof(uint32_t) * kMaxMaterials, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR);
+    CreateDeviceBuffer(m_MaterialOffsetBuffer, sizeof(uint32_t) * kMaxMaterials, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR);
     CreateDeviceBuffer(m_MaterialPixelBuffer, sizeof(GfVec2f) * kWindowWidth * kWindowHeight, VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR);
 }
 
+void RenderPass::MaterialFeedbackPassCreate(RenderContext* pRenderContext)
+{
+    // Descriptor Layout
+    // --------------------------------------
+
+    std::vector<VkDescriptorSetLayoutBinding> descriptorLayoutBindings;
+    {
+        // Binding 0: Visibility Buffer
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+
+        // Binding 1: Material Feedback
+        descriptorLayoutBindings.push_back(
+            VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE));
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorLayoutInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+    {
+        descriptorLayoutInfo.bindingCount = static_cast<uint32_t>(descriptorLayoutBindings.size());
+        descriptorLayoutInfo.pBindings    = descriptorLayoutBindings.data();
+        descriptorLayoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+    Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorLayoutInfo, nullptr, &m_MaterialFeedbackDescriptorSetLayout),
+          "Failed to create material feedback descriptor layout.");
+
+    // The draw item streams are read through the resource registry's set.
+    auto pResourceRegistry = std::static_pointer_cast<ResourceRegistry>(m_Owner->GetResourceRegistry());
+
+    std::array<VkDescriptorSetLayout, 2> setLayouts = { m_MaterialFeedbackDescriptorSetLayout, pResourceRegistry->GetDrawItemDataDescriptorLayout() };
+
+    // Pipeline Layout
+    // --------------------------------------
+
+    VkPushConstantRange pushConstantRange;
+    {
+        pushConstantRange.offset     = 0U;
+        pushConstantRange.size       = sizeof(MaterialFeedbackPushConstants);
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkPipelineLayoutCreateInfo pipelineInfo = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    {
+        pipelineInfo.pushConstantRangeCount = 1U;
+        pipelineInfo.pPushConstantRanges    = &pushConstantRange;
+        pipelineInfo.setLayoutCount         = static_cast<uint32_t>(setLayouts.size());
+        pipelineInfo.pSetLayouts            = setLayouts.data();
+    }
+    Check(vkCreatePipelineLayout(pRenderContext->GetDevice(), &pipelineInfo, nullptr, &m_MaterialFeedbackPipelineLayout),
+          "Failed to create pipeline layout for material feedback pipeline.");
+
+    // Shaders
+    // --------------------------------------
+
+    VkShaderCreateInfoEXT computeShaderInfo = { VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT };
+    {
+        computeShaderInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        computeShaderInfo.pushConstantRangeCount = 1U;
+        computeShaderInfo.pPushConstantRanges    = &pushConstantRange;
+        computeShaderInfo.setLayoutCount         = static_cast<uint32_t>(setLayouts.size());
+        computeShaderInfo.pSetLayouts            = setLayouts.data();
+    }
+    LoadShader(ShaderID::MaterialFeedbackComp, "MaterialFeedback.comp.spv", "Main", computeShaderInfo);
+}
+
 void RenderPass::DebugPassCreate(RenderContext* pRenderContext)
 {
     // Descriptor Layout
@@ -460,6 +671,14 @@ RenderPass::RenderPass(HdRenderIndex* pRenderIndex, const HdRprimCollection& col
     // Initialize Passes
     // --------------------------------------
 
+    DrawItemScatterPassCreate(pRenderContext);
+
+    // --------------------------------------
+
+    ClusterCullPassCreate(pRenderContext);
+
+    // --------------------------------------
+
     VisibilityPassCreate(pRenderContext);
 
     // --------------------------------------
@@ -468,6 +687,10 @@ RenderPass::RenderPass(HdRenderIndex* pRenderIndex, const HdRprimCollection& col
 
     // --------------------------------------
 
+    MaterialFeedbackPassCreate(pRenderContext);
+
+    // --------------------------------------
+
     DebugPassCreate(pRenderContext);
 
     // Initialize AMD Brixelizer + GI.
@@ -559,8 +782,15 @@ RenderPass::~RenderPass()
     vmaDestroyBuffer(pRenderContext->GetAllocator(), m_MaterialPixelBuffer.buffer, m_MaterialPixelBuffer.bufferAllocation);
 
     vkDestroyDescriptorSetLayout(pRenderContext->GetDevice(), m_DebugDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(pRenderContext->GetDevice(), m_DrawItemScatterDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(pRenderContext->GetDevice(), m_ClusterCullDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(pRenderContext->GetDevice(), m_VisibilityDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(pRenderContext->GetDevice(), m_MaterialFeedbackDescriptorSetLayout, nullptr);
 
+    vkDestroyPipelineLayout(pRenderContext->GetDevice(), m_DrawItemScatterPipelineLayout, nullptr);
+    vkDestroyPipelineLayout(pRenderContext->GetDevice(), m_ClusterCullPipelineLayout, nullptr);
     vkDestroyPipelineLayout(pRenderContext->GetDevice(), m_VisibilityPipelineLayout, nullptr);
+    vkDestroyPipelineLayout(pRenderContext->GetDevice(), m_MaterialFeedbackPipelineLayout, nullptr);
     vkDestroyPipelineLayout(pRenderContext->GetDevice(), m_DebugPipelineLayout, nullptr);
 
     for (auto& shader : m_ShaderMap)
@@ -569,6 +799,226 @@ RenderPass::~RenderPass()
     vkDestroySampler(pRenderContext->GetDevice(), m_DefaultSampler, nullptr);
 }
 
+void RenderPass::DrawItemScatterPassExecute(FrameContext* pFrameContext)
+{
+    auto* pResourceRegistry = pFrameContext->pResourceRegistry;
+
+    m_DrawItemScatterPushConstants.UpdateCount =
+        pResourceRegistry->PrepareDrawItemUpdates(pFrameContext->pFrame->frameIndex, &m_DrawItemScatterPushConstants.UpdateOffset);
+
+    if (m_DrawItemScatterPushConstants.UpdateCount == 0U)
+        return;
+
+    GPUProfileScope profileScope(pFrameContext->pFrame->cmd, "Draw Item Scatter Pass");
+
+    // Wait for the previous frame's readers of the meta-data.
+    VulkanMemoryBarrier(pFrameContext->pFrame->cmd,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+    vkCmdPushConstants(pFrameContext->pFrame->cmd,
+                       m_DrawItemScatterPipelineLayout,
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0U,
+                       sizeof(DrawItemScatterPushConstants),
+                       &m_DrawItemScatterPushConstants);
+
+    std::array<VkDescriptorBufferInfo, 2> bufferInfo {};
+    {
+        bufferInfo[0] = { pResourceRegistry->GetDrawItemUpdateBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[1] = { pResourceRegistry->GetDrawItemMetaDataBuffer().buffer, 0U, VK_WHOLE_SIZE };
+    }
+
+    std::array<VkWriteDescriptorSet, 2> writeDescriptorSets {};
+
+    for (uint32_t bindingIndex = 0U; bindingIndex < writeDescriptorSets.size(); bindingIndex++)
+    {
+        writeDescriptorSets[bindingIndex].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[bindingIndex].dstBinding      = bindingIndex;
+        writeDescriptorSets[bindingIndex].descriptorCount = 1U;
+        writeDescriptorSets[bindingIndex].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[bindingIndex].pBufferInfo     = &bufferInfo[bindingIndex];
+    }
+
+    vkCmdPushDescriptorSetKHR(pFrameContext->pFrame->cmd,
+                              VK_PIPELINE_BIND_POINT_COMPUTE,
+                              m_DrawItemScatterPipelineLayout,
+                              0U,
+                              static_cast<uint32_t>(writeDescriptorSets.size()),
+                              writeDescriptorSets.data());
+
+    VkShaderStageFlagBits computeStage = VK_SHADER_STAGE_COMPUTE_BIT;
+    vkCmdBindShadersEXT(pFrameContext->pFrame->cmd, 1U, &computeStage, &m_ShaderMap[ShaderID::DrawItemScatterComp]);
+
+    // One thread per update (see DrawItemScatter.hlsl).
+    vkCmdDispatch(pFrameContext->pFrame->cmd, (m_DrawItemScatterPushConstants.UpdateCount + 63U) / 64U, 1U, 1U);
+
+    VulkanMemoryBarrier(pFrameContext->pFrame->cmd,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+}
+
+void RenderPass::ClusterCullPassExecute(FrameContext* pFrameContext)
+{
+    GPUProfileScope profileScope(pFrameContext->pFrame->cmd, "Cluster Cull Pass");
+
+    auto* pResourceRegistry = pFrameContext->pResourceRegistry;
+
+    // Reset the command counts of the draw item slots in use.
+    auto drawCountSize = sizeof(uint32_t) * kMaxLODCount * std::max(pResourceRegistry->GetDrawItems().size(), static_cast<size_t>(1U));
+
+    vkCmdFillBuffer(pFrameContext->pFrame->cmd, pResourceRegistry->GetDrawCountBuffer().buffer, 0U, drawCountSize, 0U);
+
+    VulkanMemoryBarrier(pFrameContext->pFrame->cmd,
+                        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+    // Extract the world-space frustum planes (Gribb-Hartmann, row-vector convention).
+    auto matrixVP = GfMatrix4f(pFrameContext->pPassState->GetWorldToViewMatrix()) * GfMatrix4f(pFrameContext->pPassState->GetProjectionMatrix());
+
+    auto GetColumn = [&](uint32_t column) { return GfVec4f(matrixVP[0][column], matrixVP[1][column], matrixVP[2][column], matrixVP[3][column]); };
+
+    for (uint32_t axis = 0U; axis < 3U; axis++)
+    {
+        m_ClusterCullPushConstants.FrustumPlanes.at(2U * axis + 0U) = GetColumn(3) + GetColumn(axis);
+        m_ClusterCullPushConstants.FrustumPlanes.at(2U * axis + 1U) = GetColumn(3) - GetColumn(axis);
+    }
+
+    for (auto& plane : m_ClusterCullPushConstants.FrustumPlanes)
+        plane /= GfVec3f(plane[0], plane[1], plane[2]).GetLength();
+
+    m_ClusterCullPushConstants.CameraPosition = GfVec3f(pFrameContext->pPassState->GetWorldToViewMatrix().GetInverse().ExtractTranslation());
+    m_ClusterCullPushConstants.MeshletCount   = pResourceRegistry->GetMeshletCount();
+    m_ClusterCullPushConstants.FrameIndex     = static_cast<uint32_t>(pFrameContext->pFrame->frameIndex + 1U);
+
+    vkCmdPushConstants(pFrameContext->pFrame->cmd,
+                       m_ClusterCullPipelineLayout,
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0U,
+                       sizeof(ClusterCullPushConstants),
+                       &m_ClusterCullPushConstants);
+
+    std::array<VkDescriptorBufferInfo, 6> bufferInfo {};
+    {
+        bufferInfo[0] = { pResourceRegistry->GetMeshletBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[1] = { pResourceRegistry->GetDrawItemMetaDataBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[2] = { pResourceRegistry->GetDrawCommandBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[3] = { pResourceRegistry->GetDrawCountBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[4] = { pResourceRegistry->GetDrawItemFeedbackBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[5] = { pResourceRegistry->GetInstanceTransformBuffer().buffer, 0U, VK_WHOLE_SIZE };
+    }
+
+    std::array<VkWriteDescriptorSet, 6> writeDescriptorSets {};
+
+    for (uint32_t bindingIndex = 0U; bindingIndex < writeDescriptorSets.size(); bindingIndex++)
+    {
+        writeDescriptorSets[bindingIndex].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[bindingIndex].dstBinding      = bindingIndex;
+        writeDescriptorSets[bindingIndex].descriptorCount = 1U;
+        writeDescriptorSets[bindingIndex].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[bindingIndex].pBufferInfo     = &bufferInfo[bindingIndex];
+    }
+
+    vkCmdPushDescriptorSetKHR(pFrameContext->pFrame->cmd,
+                              VK_PIPELINE_BIND_POINT_COMPUTE,
+                              m_ClusterCullPipelineLayout,
+                              0U,
+                              static_cast<uint32_t>(writeDescriptorSets.size()),
+                              writeDescriptorSets.data());
+
+    VkShaderStageFlagBits computeStage = VK_SHADER_STAGE_COMPUTE_BIT;
+    vkCmdBindShadersEXT(pFrameContext->pFrame->cmd, 1U, &computeStage, &m_ShaderMap[ShaderID::ClusterCullComp]);
+
+    // One thread per cluster (see ClusterCull.hlsl).
+    vkCmdDispatch(pFrameContext->pFrame->cmd, (m_ClusterCullPushConstants.MeshletCount + 63U) / 64U, 1U, 1U);
+
+    // The visibility feedback is read on the host once the frame has completed.
+    VulkanMemoryBarrier(pFrameContext->pFrame->cmd,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_HOST_READ_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_HOST_BIT);
+}
+
+// Screen-space error (in pixels) that a simplified level of detail is allowed to introduce.
+constexpr float kLODErrorThresholdPixels = 1.0F;
+
+// Switching to a coarser level requires the error to fall this fraction below the threshold (avoids popping at the boundary).
+constexpr float kLODHysteresis = 0.25F;
+
+// Pick the coarsest level of detail whose simplification error, projected at the distance of the draw item bounds, stays under the threshold.
+static uint32_t SelectDrawItemLOD(const DrawItem& drawItem, const GfVec3f& cameraPosition, float pixelsPerUnit)
+{
+    const auto& lods = drawItem.pGeometry->lods;
+
+    // Instanced draw items share a single level of detail, keep the source mesh since the bounds are only known per instance.
+    if (lods.size() <= 1U || drawItem.instanceCount > 1U)
+        return 0U;
+
+    const auto& matrixM = drawItem.pMesh->GetLocalToWorld();
+    const auto& aabb    = drawItem.pGeometry->aabb;
+
+    GfVec3f boundsMin(aabb.min[0], aabb.min[1], aabb.min[2]);
+    GfVec3f boundsMax(aabb.max[0], aabb.max[1], aabb.max[2]);
+
+    // Conservatively scale the error and bounds by the largest axis scale of the draw item.
+    auto scale = std::max(matrixM.GetRow3(0).GetLength(), std::max(matrixM.GetRow3(1).GetLength(), matrixM.GetRow3(2).GetLength()));
+
+    auto centerWS = matrixM.Transform(0.5F * (boundsMin + boundsMax));
+    auto radiusWS = 0.5F * (boundsMax - boundsMin).GetLength() * scale;
+
+    // Distance to the nearest point of the bounding sphere (the camera inside the bounds always gets the source mesh).
+    auto distance = (centerWS - cameraPosition).GetLength() - radiusWS;
+
+    if (distance <= 0.0F)
+        return 0U;
+
+    uint32_t lodIndex = 0U;
+
+    while (lodIndex + 1U < lods.size())
+    {
+        auto errorPixels = lods[lodIndex + 1U].error * scale / distance * pixelsPerUnit;
+        auto threshold   = lodIndex + 1U > drawItem.lodIndex ? kLODErrorThresholdPixels * (1.0F - kLODHysteresis) : kLODErrorThresholdPixels;
+
+        if (errorPixels > threshold)
+            break;
+
+        lodIndex++;
+    }
+
+    return lodIndex;
+}
+
+void RenderPass::SelectDrawItemLODs(FrameContext* pFrameContext)
+{
+    auto* pResourceRegistry = pFrameContext->pResourceRegistry;
+
+    auto cameraPosition = GfVec3f(pFrameContext->pPassState->GetWorldToViewMatrix().GetInverse().ExtractTranslation());
+    auto pixelsPerUnit  = 0.5F * static_cast<float>(kWindowHeight) * std::abs(static_cast<float>(pFrameContext->pPassState->GetProjectionMatrix()[1][1]));
+
+    for (auto& drawItem : pResourceRegistry->GetDrawItems())
+    {
+        // Freed slots, and meshes without any level.
+        if (drawItem.pGeometry == nullptr || drawItem.pGeometry->lods.empty())
+            continue;
+
+        auto lodIndex = SelectDrawItemLOD(drawItem, cameraPosition, pixelsPerUnit);
+
+        // The meta-data carries the face count of the selected level, patched by this frame's scatter pass.
+        if (lodIndex != drawItem.lodIndex)
+        {
+            drawItem.lodIndex = lodIndex;
+            pResourceRegistry->PushDrawItemUpdate(drawItem.pMesh->GetDrawItemHandle());
+        }
+    }
+}
+
 void RenderPass::VisibilityPassExecute(FrameContext* pFrameContext)
 {
     GPUProfileScope profileScope(pFrameContext->pFrame->cmd, "Visibility Pass");
@@ -591,9 +1041,9 @@ void RenderPass::VisibilityPassExecute(FrameContext* pFrameContext)
         colorAttachmentInfo.storeOp          = VK_ATTACHMENT_STORE_OP_STORE;
         colorAttachmentInfo.imageLayout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
         colorAttachmentInfo.imageView        = m_VisibilityBuffer.imageView;
-        colorAttachmentInfo.clearValue.color = {
-            { 0U, 0U, 0U, 0U }
-        };
+        // Empty pixels (VISIBILITY_EMPTY), every draw item / instance / primitive index is valid.
+        colorAttachmentInfo.clearValue.color.uint32[0] = UINT32_MAX;
+        colorAttachmentInfo.clearValue.color.uint32[1] = UINT32_MAX;
     }
 
     VkRenderingAttachmentInfo depthAttachmentInfo = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
@@ -623,35 +1073,62 @@ void RenderPass::VisibilityPassExecute(FrameContext* pFrameContext)
 
     BindGraphicsShaders(pFrameContext->pFrame->cmd, m_ShaderMap[ShaderID::VisibilityVert], m_ShaderMap[ShaderID::VisibilityFrag]);
 
-    vkCmdSetVertexInputEXT(pFrameContext->pFrame->cmd,
-                           static_cast<uint32_t>(m_VertexInputBindings.size()),
-                           m_VertexInputBindings.data(),
-                           static_cast<uint32_t>(m_VertexInputAttributes.size()),
-                           m_VertexInputAttributes.data());
+    // Positions are fetched from the geometry heap in the vertex shader.
+    vkCmdSetVertexInputEXT(pFrameContext->pFrame->cmd, 0U, nullptr, 0U, nullptr);
 
     // Update camera matrices.
-    auto matrixVP = GfMatrix4f(pFrameContext->pPassState->GetWorldToViewMatrix()) * GfMatrix4f(pFrameContext->pPassState->GetProjectionMatrix());
+    m_VisibilityPushConstants.MatrixVP = GfMatrix4f(pFrameContext->pPassState->GetWorldToViewMatrix()) * GfMatrix4f(pFrameContext->pPassState->GetProjectionMatrix());
+
+    const auto& geometryHeap = pFrameContext->pResourceRegistry->GetGeometryHeap();
+
+    // Model matrices, position dequantization and instance transforms are resolved in the vertex shader.
+    std::array<VkDescriptorBufferInfo, 3> bufferInfo {};
+    {
+        bufferInfo[0] = { pFrameContext->pResourceRegistry->GetDrawItemMetaDataBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[1] = { pFrameContext->pResourceRegistry->GetInstanceTransformBuffer().buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfo[2] = { geometryHeap.GetBuffer(GeometryStream::Position).buffer, 0U, VK_WHOLE_SIZE };
+    }
+
+    std::array<VkWriteDescriptorSet, 3> writeDescriptorSets {};
+
+    for (uint32_t bindingIndex = 0U; bindingIndex < writeDescriptorSets.size(); bindingIndex++)
+    {
+        writeDescriptorSets[bindingIndex].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[bindingIndex].dstBinding      = bindingIndex;
+        writeDescriptorSets[bindingIndex].descriptorCount = 1U;
+        writeDescriptorSets[bindingIndex].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[bindingIndex].pBufferInfo     = &bufferInfo[bindingIndex];
+    }
+
+    vkCmdPushDescriptorSetKHR(pFrameContext->pFrame->cmd,
+                              VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              m_VisibilityPipelineLayout,
+                              0U,
+                              static_cast<uint32_t>(writeDescriptorSets.size()),
+                              writeDescriptorSets.data());
+
+    // Every draw item indexes into the shared index heap (its range is folded into firstIndex by the cluster culling pass).
+    vkCmdBindIndexBuffer(pFrameContext->pFrame->cmd, geometryHeap.GetBuffer(GeometryStream::Index).buffer, 0U, VK_INDEX_TYPE_UINT32);
 
     PROFILE_START("Record Visibility Buffer Commands");
 
-    const auto& drawItems = pFrameContext->pResourceRegistry->GetDrawItems();
+    auto& drawItems = pFrameContext->pResourceRegistry->GetDrawItems();
 
     m_VisibilityPushConstants.MeshCount = static_cast<uint32_t>(drawItems.size());
 
     // TODO(parsa): Go wide on all cores to record these commands on a secondary command list.
     for (uint32_t drawItemIndex = 0U; drawItemIndex < drawItems.size(); drawItemIndex++)
     {
-        auto drawItem = drawItems[drawItemIndex];
-
-        vkCmdBindIndexBuffer(pFrameContext->pFrame->cmd, drawItem.bufferI.buffer, 0U, VK_INDEX_TYPE_UINT32);
+        auto& drawItem = drawItems[drawItemIndex];
 
-        std::array<VkDeviceSize, 1> vertexBufferOffset = { 0U };
-        std::array<VkBuffer, 1>     vertexBuffers      = { drawItem.bufferV.buffer };
+        // Freed slots, and meshes without any level.
+        if (drawItem.pGeometry == nullptr || drawItem.pGeometry->lods.empty())
+            continue;
 
-        vkCmdBindVertexBuffers(pFrameContext->pFrame->cmd, 0U, 1U, vertexBuffers.data(), vertexBufferOffset.data());
+        // Selected by SelectDrawItemLODs before the scatter pass.
+        const auto& lod = drawItem.pGeometry->lods[drawItem.lodIndex];
 
-        m_VisibilityPushConstants.MatrixMVP = drawItem.pMesh->GetLocalToWorld() * matrixVP;
-        m_VisibilityPushConstants.MeshID    = drawItemIndex;
+        m_VisibilityPushConstants.MeshID = drawItemIndex;
 
         vkCmdPushConstants(pFrameContext->pFrame->cmd,
                            m_VisibilityPipelineLayout,
@@ -660,7 +1137,15 @@ void RenderPass::VisibilityPassExecute(FrameContext* pFrameContext)
                            sizeof(VisibilityPushConstants),
                            &m_VisibilityPushConstants);
 
-        vkCmdDrawIndexed(pFrameContext->pFrame->cmd, drawItem.indexCount, 1U, 0U, 0U, 0U);
+        // Draw the clusters of the selected level that survived culling.
+        // NOTE: firstInstance carries the triangle offset of each cluster in the draw item's index range (valid for every level), instanceCount the USD instances.
+        vkCmdDrawIndexedIndirectCount(pFrameContext->pFrame->cmd,
+                                      pFrameContext->pResourceRegistry->GetDrawCommandBuffer().buffer,
+                                      sizeof(VkDrawIndexedIndirectCommand) * (drawItem.meshletOffset + lod.meshletOffset),
+                                      pFrameContext->pResourceRegistry->GetDrawCountBuffer().buffer,
+                                      sizeof(uint32_t) * (drawItem.drawCountOffset + drawItem.lodIndex),
+                                      lod.meshletCount,
+                                      sizeof(VkDrawIndexedIndirectCommand));
     }
 
     PROFILE_END;
@@ -677,6 +1162,81 @@ void RenderPass::VisibilityPassExecute(FrameContext* pFrameContext)
                             VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT);
 }
 
+void RenderPass::MaterialFeedbackPassExecute(FrameContext* pFrameContext)
+{
+    GPUProfileScope profileScope(pFrameContext->pFrame->cmd, "Material Feedback Pass");
+
+    auto* pResourceRegistry = pFrameContext->pResourceRegistry;
+
+    VulkanColorImageBarrier(pFrameContext->pFrame->cmd,
+                            m_VisibilityBuffer.image,
+                            VK_IMAGE_LAYOUT_GENERAL,
+                            VK_IMAGE_LAYOUT_GENERAL,
+                            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                            VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
+
+    m_MaterialFeedbackPushConstants.MatrixVP =
+        GfMatrix4f(pFrameContext->pPassState->GetWorldToViewMatrix()) * GfMatrix4f(pFrameContext->pPassState->GetProjectionMatrix());
+    m_MaterialFeedbackPushConstants.RenderResolution = GfVec2f(static_cast<float>(kWindowWidth), static_cast<float>(kWindowHeight));
+    m_MaterialFeedbackPushConstants.FrameIndex       = static_cast<uint32_t>(pFrameContext->pFrame->frameIndex + 1U);
+
+    vkCmdPushConstants(pFrameContext->pFrame->cmd,
+                       m_MaterialFeedbackPipelineLayout,
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0U,
+                       sizeof(MaterialFeedbackPushConstants),
+                       &m_MaterialFeedbackPushConstants);
+
+    VkDescriptorImageInfo  imageInfo  = { VK_NULL_HANDLE, m_VisibilityBuffer.imageView, VK_IMAGE_LAYOUT_GENERAL };
+    VkDescriptorBufferInfo bufferInfo = { pResourceRegistry->GetMaterialFeedbackBuffer().buffer, 0U, VK_WHOLE_SIZE };
+
+    std::array<VkWriteDescriptorSet, 2> writeDescriptorSets {};
+    {
+        writeDescriptorSets[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[0].dstBinding      = 0U;
+        writeDescriptorSets[0].descriptorCount = 1U;
+        writeDescriptorSets[0].descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        writeDescriptorSets[0].pImageInfo      = &imageInfo;
+
+        writeDescriptorSets[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[1].dstBinding      = 1U;
+        writeDescriptorSets[1].descriptorCount = 1U;
+        writeDescriptorSets[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[1].pBufferInfo     = &bufferInfo;
+    }
+
+    vkCmdPushDescriptorSetKHR(pFrameContext->pFrame->cmd,
+                              VK_PIPELINE_BIND_POINT_COMPUTE,
+                              m_MaterialFeedbackPipelineLayout,
+                              0U,
+                              static_cast<uint32_t>(writeDescriptorSets.size()),
+                              writeDescriptorSets.data());
+
+    vkCmdBindDescriptorSets(pFrameContext->pFrame->cmd,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            m_MaterialFeedbackPipelineLayout,
+                            1U,
+                            1U,
+                            &pResourceRegistry->GetDrawItemDataDescriptorSet(),
+                            0U,
+                            nullptr);
+
+    VkShaderStageFlagBits computeStage = VK_SHADER_STAGE_COMPUTE_BIT;
+    vkCmdBindShadersEXT(pFrameContext->pFrame->cmd, 1U, &computeStage, &m_ShaderMap[ShaderID::MaterialFeedbackComp]);
+
+    // One thread per 4x4 tile (see MaterialFeedback.hlsl).
+    vkCmdDispatch(pFrameContext->pFrame->cmd, (kWindowWidth + 31U) / 32U, (kWindowHeight + 31U) / 32U, 1U);
+
+    // The material feedback is read on the host once the frame has completed.
+    VulkanMemoryBarrier(pFrameContext->pFrame->cmd,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_ACCESS_2_HOST_READ_BIT,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_PIPELINE_STAGE_2_HOST_BIT);
+}
+
 void RenderPass::DebugPassExecute(FrameContext* pFrameContext)
 {
     GPUProfileScope profileScope(pFrameContext->pFrame->cmd, "Debug Pass");
@@ -687,7 +1247,7 @@ void RenderPass::DebugPassExecute(FrameContext* pFrameContext)
                             VK_IMAGE_LAYOUT_READ_ONLY_OPTIMAL,
                             VK_ACCESS_2_MEMORY_READ_BIT,
                             VK_ACCESS_2_MEMORY_READ_BIT,
-                            VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
                             VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
 
     VkRenderingAttachmentInfo colorAttachmentInfo = { VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
@@ -719,8 +1279,9 @@ void RenderPass::DebugPassExecute(FrameContext* pFrameContext)
 
     m_DebugPushConstants.MatrixVP =
         GfMatrix4f(pFrameContext->pPassState->GetWorldToViewMatrix()) * GfMatrix4f(pFrameContext->pPassState->GetProjectionMatrix());
-    m_DebugPushConstants.DebugModeValue = static_cast<uint32_t>(pFrameContext->debugMode);
-    m_DebugPushConstants.MeshCount      = static_cast<uint32_t>(pFrameContext->pResourceRegistry->GetDrawItems().size());
+    m_DebugPushConstants.RenderResolution = GfVec2f(static_cast<float>(kWindowWidth), static_cast<float>(kWindowHeight));
+    m_DebugPushConstants.DebugModeValue   = static_cast<uint32_t>(pFrameContext->debugMode);
+    m_DebugPushConstants.MeshCount        = static_cast<uint32_t>(pFrameContext->pResourceRegistry->GetDrawItems().size());
 
     vkCmdPushConstants(pFrameContext->pFrame->cmd,
                        m_DebugPipelineLayout,
@@ -805,10 +1366,58 @@ void RenderPass::DebugPassExecute(FrameContext* pFrameContext)
                             VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT);
 }
 
+void RenderPass::AppendBrixelizerInstances(DrawItem& drawItem, std::vector<FfxBrixelizerInstanceDescription>* pInstanceDescs)
+{
+    const auto* pInstanceTransforms = drawItem.pMesh->IsInstanced() ? drawItem.pMesh->GetInstanceTransforms().data() : nullptr;
+
+    drawItem.brixelizerIDs.resize(drawItem.instanceCount);
+    drawItem.brixelizerLocalToWorld = drawItem.pMesh->GetLocalToWorld();
+
+    for (uint32_t instanceIndex = 0U; instanceIndex < drawItem.instanceCount; instanceIndex++)
+    {
+        auto* pDesc = &pInstanceDescs->emplace_back();
+
+        // Configure the acceleration structure instance.
+        pDesc->maxCascade         = 4U;
+        pDesc->aabb               = drawItem.pGeometry->aabb;
+        pDesc->triangleCount      = drawItem.pGeometry->indexCount / 3U;
+        pDesc->indexFormat        = FFX_INDEX_TYPE_UINT32;
+        pDesc->indexBuffer        = m_FFXBrixelizerBufferIndices[0];
+        pDesc->indexBufferOffset  = static_cast<uint32_t>(drawItem.pGeometry->indices.offset);
+        pDesc->vertexBuffer       = m_FFXBrixelizerBufferIndices[1];
+        pDesc->vertexCount        = static_cast<uint32_t>(drawItem.pGeometry->positions.size / sizeof(GfVec3f));
+        pDesc->vertexStride       = sizeof(GfVec3f);
+        pDesc->vertexBufferOffset = static_cast<uint32_t>(drawItem.pGeometry->positions.offset);
+        pDesc->vertexFormat       = FFX_SURFACE_FORMAT_R32G32B32_FLOAT;
+        pDesc->flags              = FFX_BRIXELIZER_INSTANCE_FLAG_NONE;
+
+        // Copy the transform (composed with the USD instance transform, if any).
+        if (pInstanceTransforms != nullptr)
+        {
+            auto localToWorldTranspose = (drawItem.pMesh->GetLocalToWorld() * pInstanceTransforms[instanceIndex]).GetTranspose();
+            memcpy(&pDesc->transform[0], &localToWorldTranspose, sizeof(FfxFloat32x3x4));
+        }
+        else
+            memcpy(&pDesc->transform[0], &drawItem.pMesh->GetLocalToWorld3x4()[0], sizeof(FfxFloat32x3x4));
+
+        // Update the draw item with the instance ID inside brixelizer.
+        pDesc->outInstanceID = &drawItem.brixelizerIDs[instanceIndex];
+    }
+}
+
 void RenderPass::RebuildAccelerationStructure(FrameContext* pFrameContext)
 {
     PROFILE_START("Build Acceleration Structure");
 
+#ifdef USE_QUANTIZED_VERTEX_STREAMS
+    // Brixelizer only consumes floating point vertex formats.
+    spdlog::warn("Quantized vertex streams are enabled, skipping the Brixelizer acceleration structure build.");
+    m_RebuildAccelerationStructure = false;
+
+    PROFILE_END;
+    return;
+#endif
+
     auto& drawItems = pFrameContext->pResourceRegistry->GetDrawItems();
 
     if (drawItems.size() == 0)
@@ -818,32 +1427,29 @@ void RenderPass::RebuildAccelerationStructure(FrameContext* pFrameContext)
     //    Should pre-allocate these to avoid frame-time mallocs
     // ---------------------------------------------
 
+    const auto& geometryHeap = pFrameContext->pResourceRegistry->GetGeometryHeap();
+    const auto& indexHeap    = geometryHeap.GetBuffer(GeometryStream::Index);
+    const auto& positionHeap = geometryHeap.GetBuffer(GeometryStream::Position);
+
     // Combined list of descriptions for vertex and index buffers.
-    std::vector<FfxBrixelizerBufferDescription> instanceBufferDescs(2U * drawItems.size());
+    std::array<FfxBrixelizerBufferDescription, 2> instanceBufferDescs {};
 
     // List of acceleration structure instance data.
-    std::vector<FfxBrixelizerInstanceDescription> instanceDescs(drawItems.size());
+    std::vector<FfxBrixelizerInstanceDescription> instanceDescs;
 
     // 2) Register instance buffer bindings
     // ---------------------------------------------
 
-    for (uint32_t drawItemIndex = 0U; drawItemIndex < drawItems.size(); drawItemIndex++)
     {
-        const auto& drawItem = drawItems.at(drawItemIndex);
-
         // Index
-        instanceBufferDescs[2U * drawItemIndex + 0U].outIndex = &instanceDescs.at(drawItemIndex).indexBuffer;
-        instanceBufferDescs[2U * drawItemIndex + 0U].buffer =
-            ffxGetResourceVK(drawItem.bufferI.buffer,
-                             ffxGetBufferResourceDescriptionVK(drawItem.bufferI.buffer, drawItem.bufferI.bufferInfo),
-                             L"Brixelizer Buffer");
+        auto& indexBufferDesc    = instanceBufferDescs[0];
+        indexBufferDesc.outIndex = &m_FFXBrixelizerBufferIndices[0];
+        indexBufferDesc.buffer   = ffxGetResourceVK(indexHeap.buffer, ffxGetBufferResourceDescriptionVK(indexHeap.buffer, indexHeap.bufferInfo), L"Brixelizer Buffer");
 
         // Vertex
-        instanceBufferDescs[2U * drawItemIndex + 1U].outIndex = &instanceDescs.at(drawItemIndex).vertexBuffer;
-        instanceBufferDescs[2U * drawItemIndex + 1U].buffer =
-            ffxGetResourceVK(drawItem.bufferV.buffer,
-                             ffxGetBufferResourceDescriptionVK(drawItem.bufferV.buffer, drawItem.bufferV.bufferInfo),
-                             L"Brixelizer Buffer");
+        auto& vertexBufferDesc    = instanceBufferDescs[1];
+        vertexBufferDesc.outIndex = &m_FFXBrixelizerBufferIndices[1];
+        vertexBufferDesc.buffer   = ffxGetResourceVK(positionHeap.buffer, ffxGetBufferResourceDescriptionVK(positionHeap.buffer, positionHeap.bufferInfo), L"Brixelizer Buffer");
     }
 
     Check(ffxBrixelizerRegisterBuffers(&m_FFXBrixelizerContext, instanceBufferDescs.data(), static_cast<uint32_t>(instanceBufferDescs.size())),
@@ -852,30 +1458,12 @@ void RenderPass::RebuildAccelerationStructure(FrameContext* pFrameContext)
     // 3) Create instances from draw items.
     // ---------------------------------------------
 
-    for (uint32_t drawItemIndex = 0U; drawItemIndex < drawItems.size(); drawItemIndex++)
+    for (auto& drawItem : drawItems)
     {
-        auto& drawItem = drawItems.at(drawItemIndex);
-
-        auto* pDesc = &instanceDescs.at(drawItemIndex);
+        if (drawItem.pGeometry == nullptr)
+            continue;
 
-        // Configure the acceleration structure instance.
-        // NOTE: Vertex and index buffer indices where set in the prior pass.
-        pDesc->maxCascade         = 4U;
-        pDesc->aabb               = drawItem.pMesh->GetAABB();
-        pDesc->triangleCount      = drawItem.indexCount / 3U;
-        pDesc->indexFormat        = FFX_INDEX_TYPE_UINT32;
-        pDesc->indexBufferOffset  = 0U;
-        pDesc->vertexCount        = static_cast<uint32_t>(drawItem.bufferV.bufferInfo.size) / sizeof(GfVec3f);
-        pDesc->vertexStride       = sizeof(GfVec3f);
-        pDesc->vertexBufferOffset = 0U;
-        pDesc->vertexFormat       = FFX_SURFACE_FORMAT_R32G32B32_FLOAT;
-        pDesc->flags              = FFX_BRIXELIZER_INSTANCE_FLAG_NONE;
-
-        // Copy the transform.
-        memcpy(&pDesc->transform[0], &drawItem.pMesh->GetLocalToWorld3x4()[0], sizeof(FfxFloat32x3x4));
-
-        // Update the draw item with the instance ID inside brixelizer.
-        pDesc->outInstanceID = &drawItem.brixelizerID;
+        AppendBrixelizerInstances(drawItem, &instanceDescs);
     }
 
     Check(ffxBrixelizerCreateInstances(&m_FFXBrixelizerContext, instanceDescs.data(), static_cast<uint32_t>(instanceDescs.size())),
@@ -915,8 +1503,30 @@ void RenderPass::_Execute(const HdRenderPassStateSharedPtr& renderPassState, con
     if (!frameContext.pResourceRegistry->IsBusy() && m_RebuildAccelerationStructure)
         RebuildAccelerationStructure(&frameContext);
 
-    // Dispatch Brixelizer update.
-    if (!m_RebuildAccelerationStructure)
+    // Drop the instances of freed draw items before the next update reads the geometry heap ranges they referenced.
+    if (!frameContext.pResourceRegistry->IsBusy() && !m_RebuildAccelerationStructure)
+    {
+        auto retiredInstances = frameContext.pResourceRegistry->TakeRetiredBrixelizerInstances();
+
+        if (!retiredInstances.empty())
+            Check(ffxBrixelizerDeleteInstances(&m_FFXBrixelizerContext, retiredInstances.data(), static_cast<uint32_t>(retiredInstances.size())),
+                  "Failed to remove draw items from the Brixelizer acceleration structure.");
+
+        // Re-create the instances of moved draw items with their new transform.
+        std::vector<FfxBrixelizerInstanceDescription> instanceDescs;
+
+        auto& drawItems = frameContext.pResourceRegistry->GetDrawItems();
+
+        for (auto drawItemIndex : frameContext.pResourceRegistry->TakeRetransformedBrixelizerDrawItems())
+            AppendBrixelizerInstances(drawItems[drawItemIndex], &instanceDescs);
+
+        if (!instanceDescs.empty())
+            Check(ffxBrixelizerCreateInstances(&m_FFXBrixelizerContext, instanceDescs.data(), static_cast<uint32_t>(instanceDescs.size())),
+                  "Failed to re-create moved draw items in the Brixelizer acceleration structure.");
+    }
+
+    // Dispatch Brixelizer update (the geometry heap is rewritten while the registry commits).
+    if (!frameContext.pResourceRegistry->IsBusy() && !m_RebuildAccelerationStructure)
     {
         size_t requiredDeviceScratchSize = 0;
 
@@ -1014,12 +1624,21 @@ void RenderPass::_Execute(const HdRenderPassStateSharedPtr& renderPassState, con
     //    Ref: https://www.gdcvault.com/play/1023792/4K-Rendering-Breakthrough-The-Filtered
     //    Ref: http://filmicworlds.com/blog/visibility-buffer-rendering-with-material-graphs/
     //
-    //    TODO(parsa): Use https://github.com/zeux/meshoptimizer to produce optimized meshlets
-    //                 that can be culled in a mesh shader.
+    //
+    //    Levels of detail are selected and pending transform / material changes are scattered into the draw item meta-data first.
+    //    Meshlets are then frustum / normal-cone culled on the GPU, and the survivors are drawn indirectly.
 
     if (!frameContext.pResourceRegistry->IsBusy() && frameContext.debugMode != DebugMode::Brixelizer)
+    {
+        SelectDrawItemLODs(&frameContext);
+        DrawItemScatterPassExecute(&frameContext);
+        ClusterCullPassExecute(&frameContext);
         VisibilityPassExecute(&frameContext);
 
+        // Texture streaming requests, independent of the debug view.
+        MaterialFeedbackPassExecute(&frameContext);
+    }
+
     // 3) Material Pass
 
     // 4) Resolve G-Buffer from V-Buffer.
@@ -1028,7 +1647,7 @@ void RenderPass::_Execute(const HdRenderPassStateSharedPtr& renderPassState, con
 
     // 6) Debug (non-Brixelizer)
 
-    if (frameContext.debugMode != DebugMode::None && frameContext.debugMode != DebugMode::Brixelizer)
+    if (!frameContext.pResourceRegistry->IsBusy() && frameContext.debugMode != DebugMode::None && frameContext.debugMode != DebugMode::Brixelizer)
         DebugPassExecute(&frameContext);
 
     // Copy the internal color attachment to back buffer.
@@ -1,44 +1,72 @@
 #include <Common.h>
+#include <ImageLoader.h>
 #include <Mesh.h>
 #include <Material.h>
+#include <MeshProcessing.h>
 #include <RenderContext.h>
 #include <ResourceRegistry.h>
+#include <StagingRing.h>
 
 #include <cstddef>
 
-void CreateDrawItemDescriptorLayout(RenderContext* pRenderContext, VkDescriptorSetLayout& descriptorLayout)
+// Material slot sampling the default image, for draw items whose material is not (or no longer) uploaded.
+static constexpr uint32_t kDefaultMaterialIndex = 0U;
+
+// Size of the single host staging allocation backing all of a request's streams.
+static uint64_t GetHostAllocationSize(const DrawItemRequest& request)
 {
-    std::vector<VkDescriptorBindingFlags> bindingFlags(3U, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT);
+    return request.indexBufferSize + request.vertexBufferSize + request.texcoordBufferSize + request.meshletBufferSize + request.lodBufferSize;
+}
 
-    // The last binding is fully bound / normal.
-    bindingFlags.push_back(0x0);
+static uint64_t GetHostAllocationSize(const TextureRequest& request)
+{
+    VkExtent3D extent = { static_cast<uint32_t>(request.image.dim[0]), static_cast<uint32_t>(request.image.dim[1]), 1U };
 
-    VkDescriptorSetLayoutBindingFlagsCreateInfo descriptorSetFlags { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT };
-    {
-        descriptorSetFlags.bindingCount  = static_cast<uint32_t>(bindingFlags.size());
-        descriptorSetFlags.pBindingFlags = bindingFlags.data();
-    }
+    return GetMipChainSize(extent, request.image.format, request.image.stride, std::max(request.image.mipLevels, 1U));
+}
+
+// Finest level of a texture that is no larger than the resolution (log2, along its longest axis).
+static uint32_t GetMipLevelForResolution(const DeviceTexture& texture, uint32_t resolutionLog2)
+{
+    auto fullMipLevels = GetMipChainLevels(texture.extent);
+
+    return std::min(fullMipLevels - 1U - std::min(resolutionLog2, fullMipLevels - 1U), texture.mipLevels - 1U);
+}
+
+// Device bytes of a streamed texture holding the levels from the given level down.
+static VkDeviceSize GetResidentSize(const DeviceTexture& texture, uint32_t mipLevel)
+{
+    return GetMipChainSize(texture.extent, texture.format, texture.bytesPerTexel, texture.mipLevels) -
+           GetMipChainSize(texture.extent, texture.format, texture.bytesPerTexel, mipLevel);
+}
+
+void CreateDrawItemDescriptorLayout(RenderContext* pRenderContext, VkDescriptorSetLayout& descriptorLayout)
+{
+    // Read by the debug pass and the material feedback pass.
+    constexpr VkShaderStageFlags kStageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
 
     std::vector<VkDescriptorSetLayoutBinding> bindings;
     {
-        // Binding 0: Index Buffers
-        bindings.push_back(VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4096U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+        // Binding 0: Index Heap
+        bindings.push_back(VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, kStageFlags, VK_NULL_HANDLE));
 
-        // Binding 1: Vertex Buffers
-        bindings.push_back(VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4096U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+        // Binding 1: Position Heap
+        bindings.push_back(VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, kStageFlags, VK_NULL_HANDLE));
 
-        // Binding 2: Texture Coordinate Buffers
-        bindings.push_back(VkDescriptorSetLayoutBinding(2U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4096U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+        // Binding 2: Texture Coordinate Heap
+        bindings.push_back(VkDescriptorSetLayoutBinding(2U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, kStageFlags, VK_NULL_HANDLE));
 
         // Binding 3: Meta-data
-        bindings.push_back(VkDescriptorSetLayoutBinding(3U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+        bindings.push_back(VkDescriptorSetLayoutBinding(3U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, kStageFlags, VK_NULL_HANDLE));
+
+        // Binding 4: Instance Transforms
+        bindings.push_back(VkDescriptorSetLayoutBinding(4U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, kStageFlags, VK_NULL_HANDLE));
     }
 
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
     {
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
         descriptorSetLayoutInfo.pBindings    = bindings.data();
-        descriptorSetLayoutInfo.pNext        = &descriptorSetFlags;
     }
     Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorSetLayoutInfo, nullptr, &descriptorLayout),
           "Failed to create descriptor set layout for resource registry.");
@@ -46,9 +74,11 @@ void CreateDrawItemDescriptorLayout(RenderContext* pRenderContext, VkDescriptorS
 
 void CreateMaterialDataDescriptorLayout(RenderContext* pRenderContext, VkDescriptorSetLayout& descriptorLayout)
 {
-    std::vector<VkDescriptorBindingFlags> bindingFlags(1U, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT);
+    // Material images are written into free slots while the set is bound by frames in flight (which only reference live slots).
+    std::vector<VkDescriptorBindingFlags> bindingFlags(1U, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT);
 
-    // The last binding is fully bound / normal.
+    // The other bindings are fully bound / normal.
+    bindingFlags.push_back(0x0);
     bindingFlags.push_back(0x0);
 
     VkDescriptorSetLayoutBindingFlagsCreateInfo descriptorSetFlags { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT };
@@ -59,11 +89,18 @@ void CreateMaterialDataDescriptorLayout(RenderContext* pRenderContext, VkDescrip
 
     std::vector<VkDescriptorSetLayoutBinding> bindings;
     {
-        // Binding 0: Albedo Images
-        bindings.push_back(VkDescriptorSetLayoutBinding(0U, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4096U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+        // Binding 0: Material Images (one per textured input of each material slot)
+        bindings.push_back(VkDescriptorSetLayoutBinding(0U,
+                                                        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                                                        kMaxMaterials * kMaterialTextureCount,
+                                                        VK_SHADER_STAGE_FRAGMENT_BIT,
+                                                        VK_NULL_HANDLE));
 
         // Binding 1: Point Sampler
         bindings.push_back(VkDescriptorSetLayoutBinding(1U, VK_DESCRIPTOR_TYPE_SAMPLER, 1U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
+
+        // Binding 2: Material Parameters
+        bindings.push_back(VkDescriptorSetLayoutBinding(2U, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE));
     }
 
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
@@ -71,6 +108,7 @@ void CreateMaterialDataDescriptorLayout(RenderContext* pRenderContext, VkDescrip
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
         descriptorSetLayoutInfo.pBindings    = bindings.data();
         descriptorSetLayoutInfo.pNext        = &descriptorSetFlags;
+        descriptorSetLayoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
     }
     Check(vkCreateDescriptorSetLayout(pRenderContext->GetDevice(), &descriptorSetLayoutInfo, nullptr, &descriptorLayout),
           "Failed to create descriptor set layout for resource registry.");
@@ -78,33 +116,26 @@ void CreateMaterialDataDescriptorLayout(RenderContext* pRenderContext, VkDescrip
 
 ResourceRegistry::ResourceRegistry(RenderContext* pRenderContext) :
     m_RenderContext(pRenderContext), m_DrawItemDataDescriptorLayout(VK_NULL_HANDLE), m_DrawItemDataDescriptorSet(VK_NULL_HANDLE),
-    m_MaterialDataDescriptorLayout(VK_NULL_HANDLE), m_MaterialDataDescriptorSet(VK_NULL_HANDLE), m_HostBufferPoolSize(0LL), m_HostImagePoolSize(0LL)
+    m_MaterialDataDescriptorLayout(VK_NULL_HANDLE), m_MaterialDataDescriptorSet(VK_NULL_HANDLE), m_HostBufferArena(kHostBufferArenaReserveBytes),
+    m_HostImageArena(kHostImageArenaReserveBytes), m_StagingRing(pRenderContext), m_GeometryHeap(pRenderContext)
 {
     // Create descriptor set layouts.
     CreateDrawItemDescriptorLayout(m_RenderContext, m_DrawItemDataDescriptorLayout);
     CreateMaterialDataDescriptorLayout(m_RenderContext, m_MaterialDataDescriptorLayout);
 
-    // Reserve pool memory.
-    m_HostBufferPool.resize(kHostBufferPoolMaxBytes);
-    m_HostImagePool.resize(kHostImagePoolMaxBytes);
-
     // Create default resources.
     {
         auto defaultResourceBytes = static_cast<VkDeviceSize>(4LL * 4 * sizeof(float));
 
-        Buffer stagingBuffer;
-        m_RenderContext->CreateStagingBuffer(defaultResourceBytes, &stagingBuffer);
-
         // Black texels.
         std::vector<uint8_t> defaultImagePixels(defaultResourceBytes, 0);
 
         RenderContext::CreateDeviceImageWithDataParams imageParams {};
         {
             imageParams.pImageDevice     = &m_DefaultImage;
-            imageParams.pBufferStaging   = &stagingBuffer;
+            imageParams.pStagingRing     = &m_StagingRing;
             imageParams.pData            = defaultImagePixels.data();
-            imageParams.bytesPerTexel    = defaultResourceBytes;
-            imageParams.commandPool      = m_RenderContext->GetCommandPool();
+            imageParams.bytesPerTexel    = 4U;
             imageParams.info.imageType   = VK_IMAGE_TYPE_2D;
             imageParams.info.arrayLayers = 1U;
             imageParams.info.mipLevels   = 1U;
@@ -117,78 +148,255 @@ ResourceRegistry::ResourceRegistry(RenderContext* pRenderContext) :
         }
         m_RenderContext->CreateDeviceImageWithData(imageParams);
 
-        vmaDestroyBuffer(m_RenderContext->GetAllocator(), stagingBuffer.buffer, stagingBuffer.bufferAllocation);
+        // The first frame acquires the image from the upload queue.
+        m_StagingRing.Flush();
     }
 
     // Create default material image sampler.
     VkSamplerCreateInfo deviceMaterialSamplerInfo = { VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
     {
-        deviceMaterialSamplerInfo.magFilter = VK_FILTER_NEAREST;
-        deviceMaterialSamplerInfo.minFilter = VK_FILTER_NEAREST;
+        deviceMaterialSamplerInfo.magFilter  = VK_FILTER_LINEAR;
+        deviceMaterialSamplerInfo.minFilter  = VK_FILTER_LINEAR;
+        deviceMaterialSamplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        deviceMaterialSamplerInfo.maxLod     = VK_LOD_CLAMP_NONE;
 
         deviceMaterialSamplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
         deviceMaterialSamplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
         deviceMaterialSamplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+        // Anisotropic filtering, if the device supports it (the logical device enables every supported feature).
+        VkPhysicalDeviceFeatures physicalDeviceFeatures;
+        vkGetPhysicalDeviceFeatures(m_RenderContext->GetDevicePhysical(), &physicalDeviceFeatures);
+
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(m_RenderContext->GetDevicePhysical(), &physicalDeviceProperties);
+
+        deviceMaterialSamplerInfo.anisotropyEnable = physicalDeviceFeatures.samplerAnisotropy;
+        deviceMaterialSamplerInfo.maxAnisotropy    = std::min(physicalDeviceProperties.limits.maxSamplerAnisotropy, 16.0F);
     }
     Check(vkCreateSampler(m_RenderContext->GetDevice(), &deviceMaterialSamplerInfo, nullptr, &m_DeviceMaterialImageSampler),
           "Failed to create device material image sampler.");
 
-    m_CommitTaskBusy.store(false);
-}
+    // Create the upload buffer for incremental draw item meta-data updates.
+    {
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size               = sizeof(DrawItemMetaDataUpdate) * kMaxDrawItemUpdatesPerFrame * kMaxFramesInFlight;
+        bufferInfo.usage              = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags                   = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo {};
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(),
+                              &bufferInfo,
+                              &allocInfo,
+                              &m_DrawItemUpdateBuffer.buffer,
+                              &m_DrawItemUpdateBuffer.bufferAllocation,
+                              &allocationInfo),
+              "Failed to create draw item update buffer.");
+
+        m_pDrawItemUpdatesMapped = static_cast<DrawItemMetaDataUpdate*>(allocationInfo.pMappedData);
+
+        DebugLabelBufferResource(m_RenderContext, m_DrawItemUpdateBuffer, "DrawItemUpdateBuffer");
+    }
 
-void ResourceRegistry::BuildDescriptors()
-{
-    // Draw Item Buffer Descriptors
-    // ---------------------------------
+    // Create the draw item visibility feedback buffer, stamped by the cluster culling pass and read back for texture residency.
+    {
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size               = sizeof(uint32_t) * kMaxDrawItems;
+        bufferInfo.usage              = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags                   = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo {};
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(),
+                              &bufferInfo,
+                              &allocInfo,
+                              &m_DrawItemFeedbackBuffer.buffer,
+                              &m_DrawItemFeedbackBuffer.bufferAllocation,
+                              &allocationInfo),
+              "Failed to create draw item feedback buffer.");
+
+        m_pDrawItemFeedbackMapped = static_cast<uint32_t*>(allocationInfo.pMappedData);
+
+        // Never visible.
+        memset(m_pDrawItemFeedbackMapped, 0, bufferInfo.size);
+        vmaFlushAllocation(m_RenderContext->GetAllocator(), m_DrawItemFeedbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
+
+        DebugLabelBufferResource(m_RenderContext, m_DrawItemFeedbackBuffer, "DrawItemFeedbackBuffer");
+    }
 
-    VkDescriptorSetAllocateInfo descriptorsAllocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    // Create the material feedback buffer, stamped with the texel resolution each material is sampled at and read back
+    // for texture streaming.
     {
-        descriptorsAllocInfo.descriptorSetCount = 1U;
-        descriptorsAllocInfo.descriptorPool     = m_RenderContext->GetDescriptorPool();
-        descriptorsAllocInfo.pSetLayouts        = &m_DrawItemDataDescriptorLayout;
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size               = sizeof(uint32_t) * kMaxMaterials;
+        bufferInfo.usage              = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags                   = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo {};
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(),
+                              &bufferInfo,
+                              &allocInfo,
+                              &m_MaterialFeedbackBuffer.buffer,
+                              &m_MaterialFeedbackBuffer.bufferAllocation,
+                              &allocationInfo),
+              "Failed to create material feedback buffer.");
+
+        m_pMaterialFeedbackMapped = static_cast<uint32_t*>(allocationInfo.pMappedData);
+
+        // Never sampled.
+        memset(m_pMaterialFeedbackMapped, 0, bufferInfo.size);
+        vmaFlushAllocation(m_RenderContext->GetAllocator(), m_MaterialFeedbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
+
+        DebugLabelBufferResource(m_RenderContext, m_MaterialFeedbackBuffer, "MaterialFeedbackBuffer");
     }
 
-    Check(vkAllocateDescriptorSets(m_RenderContext->GetDevice(), &descriptorsAllocInfo, &m_DrawItemDataDescriptorSet),
-          "Failed to allocate indexed resource descriptor sets.");
+    // Create the material parameter buffer, one entry per material slot.
+    {
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size               = sizeof(DeviceMaterialParameters) * kMaxMaterials;
+        bufferInfo.usage              = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags                   = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocationInfo {};
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(),
+                              &bufferInfo,
+                              &allocInfo,
+                              &m_MaterialParameterBuffer.buffer,
+                              &m_MaterialParameterBuffer.bufferAllocation,
+                              &allocationInfo),
+              "Failed to create material parameter buffer.");
+
+        m_pMaterialParametersMapped = static_cast<DeviceMaterialParameters*>(allocationInfo.pMappedData);
+
+        DebugLabelBufferResource(m_RenderContext, m_MaterialParameterBuffer, "MaterialParameterBuffer");
+    }
+
+    // Evicted textures are read back on the graphics queue (which owns them) from the commit task.
+    m_RenderContext->CreateCommandPool(&m_ResidencyCommandPool, m_RenderContext->GetCommandQueueIndex());
 
-    auto WriteDrawItemBufferDescriptor = [&](uint32_t dstBinding, uint32_t dstIndex, VkBuffer buffer)
+    // Create the draw item buffers, sized for every slot and written in place by the commits.
     {
-        VkDescriptorBufferInfo bufferInfo {};
-        {
-            bufferInfo.buffer = buffer;
-            bufferInfo.range  = VK_WHOLE_SIZE;
-        }
+        std::array<uint32_t, 2> queueFamilyIndices = { m_RenderContext->GetCommandQueueIndex(), m_RenderContext->GetTransferQueueIndex() };
 
-        VkWriteDescriptorSet descriptorWrite { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        auto CreateDrawItemBuffer = [&](Buffer* pBuffer, VkDeviceSize size, VkBufferUsageFlags usage, bool uploaded, const char* name)
         {
-            descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            descriptorWrite.descriptorCount = 1U;
-            descriptorWrite.dstSet          = m_DrawItemDataDescriptorSet;
-            descriptorWrite.dstBinding      = dstBinding;
-            descriptorWrite.dstArrayElement = dstIndex;
-            descriptorWrite.pBufferInfo     = &bufferInfo;
-        }
-        vkUpdateDescriptorSets(m_RenderContext->GetDevice(), 1U, &descriptorWrite, 0U, nullptr);
-    };
+            VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+            {
+                bufferInfo.size  = size;
+                bufferInfo.usage = usage;
 
-    for (uint32_t drawItemIndex = 0U; drawItemIndex < m_DrawItems.size(); drawItemIndex++)
-    {
-        auto& drawItem = m_DrawItems[drawItemIndex];
+                // Uploaded buffers are shared with the upload queue (as the geometry heap).
+                if (uploaded && m_RenderContext->HasDedicatedTransferQueue())
+                {
+                    bufferInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+                    bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+                    bufferInfo.pQueueFamilyIndices   = queueFamilyIndices.data();
+                }
+            }
+
+            VmaAllocationCreateInfo allocInfo = {};
+            {
+                allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            }
 
-        WriteDrawItemBufferDescriptor(0U, drawItemIndex, drawItem.bufferI.buffer);
-        WriteDrawItemBufferDescriptor(1U, drawItemIndex, drawItem.bufferV.buffer);
-        WriteDrawItemBufferDescriptor(2U, drawItemIndex, drawItem.bufferST.buffer);
+            Check(vmaCreateBuffer(m_RenderContext->GetAllocator(), &bufferInfo, &allocInfo, &pBuffer->buffer, &pBuffer->bufferAllocation, nullptr),
+                  "Failed to create draw item buffer.");
+
+            pBuffer->bufferInfo = bufferInfo;
+
+            DebugLabelBufferResource(m_RenderContext, *pBuffer, name);
+        };
+
+        CreateDrawItemBuffer(&m_DrawItemMetaDataBuffer,
+                             sizeof(DrawItemMetaData) * kMaxDrawItems,
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             true,
+                             "DrawItemMetaDataBuffer");
+
+        // One command slot per cluster of the meshlet heap, compacted per draw item.
+        CreateDrawItemBuffer(&m_DrawCommandBuffer,
+                             sizeof(VkDrawIndexedIndirectCommand) * (m_GeometryHeap.GetBuffer(GeometryStream::Meshlet).bufferInfo.size / sizeof(Meshlet)),
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                             false,
+                             "DrawCommandBuffer");
+
+        // One draw count per draw item level of detail (reset by the cull pass).
+        CreateDrawItemBuffer(&m_DrawCountBuffer,
+                             sizeof(uint32_t) * kMaxLODCount * kMaxDrawItems,
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                             false,
+                             "DrawCountBuffer");
     }
 
-    spdlog::info("Created draw item buffer descriptors.");
+    m_DrawItemGenerations = std::vector<std::atomic<uint32_t>>(kMaxDrawItems);
 
-    // Draw Item Meta-data
-    // ---------------------------------
+    // Reserve the default material slot.
+    m_DeviceMaterials.push_back({});
+    m_DirtyMaterialSlots.push_back(kDefaultMaterialIndex);
 
-    WriteDrawItemBufferDescriptor(3U, 0U, m_DrawItemMetaDataBuffer.buffer);
+    CreateDescriptors();
+    BuildDescriptors();
 
-    // Device Material Images
-    // ---------------------------------
+    // Grey images stay in a single channel if the device can filter it in sRGB.
+    m_TextureLoadOptions.preserveChannels = m_RenderContext->SupportsLinearFiltering(VK_FORMAT_R8_SRGB);
+
+    // Block compressed textures are only produced (compressed / transcoded) if the device samples every BC format used.
+    m_TextureLoadOptions.supportsBlockCompression =
+        std::ranges::all_of(kCompressedTextureFormats, [this](VkFormat format) { return m_RenderContext->SupportsLinearFiltering(format); });
+
+    if (!m_TextureLoadOptions.supportsBlockCompression)
+        spdlog::warn("Device does not support sampling block compressed textures, textures are uploaded uncompressed.");
+
+#ifdef USE_TEXTURE_COMPRESSION
+    m_CompressTextures = m_TextureLoadOptions.supportsBlockCompression;
+#endif
+
+#ifdef USE_TEXTURE_STREAMING
+    m_StreamTextures = true;
+#endif
+
+    m_CommitTaskBusy.store(false);
+    m_PendingTextureDecodes.store(0U);
+}
+
+void ResourceRegistry::CreateDescriptors()
+{
+    // Dedicated pool sized for exactly the two persistent sets (the material set requires an update-after-bind pool).
+    std::array<VkDescriptorPoolSize, 3> descriptorPoolSizes = {
+        { { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6U }, { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, kMaxMaterials * kMaterialTextureCount }, { VK_DESCRIPTOR_TYPE_SAMPLER, 1U } }
+    };
+
+    VkDescriptorPoolCreateInfo descriptorPoolInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    {
+        descriptorPoolInfo.poolSizeCount = static_cast<uint32_t>(descriptorPoolSizes.size());
+        descriptorPoolInfo.pPoolSizes    = descriptorPoolSizes.data();
+        descriptorPoolInfo.maxSets       = 2U;
+        descriptorPoolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    }
+    Check(vkCreateDescriptorPool(m_RenderContext->GetDevice(), &descriptorPoolInfo, nullptr, &m_DescriptorPool),
+          "Failed to create descriptor pool for resource registry.");
+
+    // The sets are allocated once, every buffer they reference is persistent.
+    VkDescriptorSetAllocateInfo descriptorsAllocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    {
+        descriptorsAllocInfo.descriptorSetCount = 1U;
+        descriptorsAllocInfo.descriptorPool     = m_DescriptorPool;
+        descriptorsAllocInfo.pSetLayouts        = &m_DrawItemDataDescriptorLayout;
+    }
+
+    Check(vkAllocateDescriptorSets(m_RenderContext->GetDevice(), &descriptorsAllocInfo, &m_DrawItemDataDescriptorSet),
+          "Failed to allocate indexed resource descriptor sets.");
 
     {
         // Re-use prior descriptor set info with the material data layout.
@@ -197,40 +405,38 @@ void ResourceRegistry::BuildDescriptors()
     Check(vkAllocateDescriptorSets(m_RenderContext->GetDevice(), &descriptorsAllocInfo, &m_MaterialDataDescriptorSet),
           "Failed to allocate indexed resource descriptor sets.");
 
-    auto WriteDeviceMaterialImageDescriptor = [&](uint32_t dstBinding, uint32_t dstIndex, VkImageView imageView)
+    // Draw Item Buffer Descriptors
+    // ---------------------------------
+
+    std::array<VkDescriptorBufferInfo, 5> bufferInfos {};
     {
-        if (imageView == VK_NULL_HANDLE)
-        {
-            // Patch in the default image for this descriptor if the provided one is invalid.
-            imageView = m_DefaultImage.imageView;
-        }
+        // Every draw item addresses its streams by offset into the geometry heap.
+        bufferInfos[0] = { m_GeometryHeap.GetBuffer(GeometryStream::Index).buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfos[1] = { m_GeometryHeap.GetBuffer(GeometryStream::Position).buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfos[2] = { m_GeometryHeap.GetBuffer(GeometryStream::TexCoord).buffer, 0U, VK_WHOLE_SIZE };
+
+        // Meta-data and instance transforms.
+        bufferInfos[3] = { m_DrawItemMetaDataBuffer.buffer, 0U, VK_WHOLE_SIZE };
+        bufferInfos[4] = { m_GeometryHeap.GetBuffer(GeometryStream::Instance).buffer, 0U, VK_WHOLE_SIZE };
+    }
 
-        VkDescriptorImageInfo imageInfo {};
-        {
-            imageInfo.imageView   = imageView;
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        }
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
 
+    for (uint32_t bindingIndex = 0U; bindingIndex < bufferInfos.size(); bindingIndex++)
+    {
         VkWriteDescriptorSet descriptorWrite { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
         {
-            descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
             descriptorWrite.descriptorCount = 1U;
-            descriptorWrite.dstSet          = m_MaterialDataDescriptorSet;
-            descriptorWrite.dstBinding      = dstBinding;
-            descriptorWrite.dstArrayElement = dstIndex;
-            descriptorWrite.pImageInfo      = &imageInfo;
+            descriptorWrite.dstSet          = m_DrawItemDataDescriptorSet;
+            descriptorWrite.dstBinding      = bindingIndex;
+            descriptorWrite.pBufferInfo     = &bufferInfos[bindingIndex];
         }
-        vkUpdateDescriptorSets(m_RenderContext->GetDevice(), 1U, &descriptorWrite, 0U, nullptr);
-    };
-
-    for (uint32_t deviceMaterialIndex = 0U; deviceMaterialIndex < m_DeviceMaterials.size(); deviceMaterialIndex++)
-    {
-        auto& deviceMaterial = m_DeviceMaterials[deviceMaterialIndex];
-
-        WriteDeviceMaterialImageDescriptor(0U, deviceMaterialIndex, deviceMaterial.albedo.imageView);
+        descriptorWrites.push_back(descriptorWrite);
     }
 
     // Point Sampler for Material Images.
+    // ---------------------------------
 
     VkDescriptorImageInfo samplerInfo {};
     {
@@ -245,290 +451,1444 @@ void ResourceRegistry::BuildDescriptors()
         samplerDescriptorWrite.dstBinding      = 1U;
         samplerDescriptorWrite.pImageInfo      = &samplerInfo;
     }
-    vkUpdateDescriptorSets(m_RenderContext->GetDevice(), 1U, &samplerDescriptorWrite, 0U, nullptr);
+    descriptorWrites.push_back(samplerDescriptorWrite);
+
+    // Material Parameters
+    // ---------------------------------
+
+    VkDescriptorBufferInfo parameterBufferInfo = { m_MaterialParameterBuffer.buffer, 0U, VK_WHOLE_SIZE };
+
+    VkWriteDescriptorSet parameterDescriptorWrite { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    {
+        parameterDescriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        parameterDescriptorWrite.descriptorCount = 1U;
+        parameterDescriptorWrite.dstSet          = m_MaterialDataDescriptorSet;
+        parameterDescriptorWrite.dstBinding      = 2U;
+        parameterDescriptorWrite.pBufferInfo     = &parameterBufferInfo;
+    }
+    descriptorWrites.push_back(parameterDescriptorWrite);
+
+    vkUpdateDescriptorSets(m_RenderContext->GetDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0U, nullptr);
+
+    spdlog::info("Created draw item buffer descriptors.");
 }
 
-void ResourceRegistry::_Commit()
+void ResourceRegistry::BuildDescriptors()
 {
-    if (m_CommitTaskBusy.load())
+    if (m_DirtyMaterialSlots.empty())
         return;
 
-    if (m_DrawItemRequests.empty())
-        return;
+    // A slot may be released and re-used within the same commit.
+    std::ranges::sort(m_DirtyMaterialSlots);
+    m_DirtyMaterialSlots.erase(std::ranges::unique(m_DirtyMaterialSlots).begin(), m_DirtyMaterialSlots.end());
 
-    m_CommitTask.run(
-        [&]
-        {
-            // Busy.
-            m_CommitTaskBusy.store(true);
+    // Device Material Images / Parameters
+    // ---------------------------------
 
-            // WARNING: Hard-coded scratch memory of 512mb.
-            Buffer stagingBuffer;
-            m_RenderContext->CreateStagingBuffer(512LL * 1024 * 1024, &stagingBuffer);
+    std::vector<VkDescriptorImageInfo> imageInfos(m_DirtyMaterialSlots.size() * kMaterialTextureCount);
+    std::vector<VkWriteDescriptorSet>  descriptorWrites(m_DirtyMaterialSlots.size());
 
-            auto requestCount = static_cast<uint32_t>(m_MaterialRequests.size());
-            auto requestIndex = 0U;
+    for (uint32_t writeIndex = 0U; writeIndex < m_DirtyMaterialSlots.size(); writeIndex++)
+    {
+        auto  deviceMaterialIndex = m_DirtyMaterialSlots[writeIndex];
+        auto& deviceMaterial      = m_DeviceMaterials[deviceMaterialIndex];
 
-            // Initialize the device image upload info.
-            RenderContext::CreateDeviceImageWithDataParams deviceImageCreateParams {};
+        auto parameters = deviceMaterial.parameters;
+
+        for (uint32_t textureIndex = 0U; textureIndex < kMaterialTextureCount; textureIndex++)
+        {
+            // Patch in the default image for this descriptor if the input is constant (or its texture is not resident),
+            // the shader then only uses the factor.
+            auto imageView = m_DefaultImage.imageView;
+
+            parameters.textureIndices.at(textureIndex) = kMaterialTextureNone;
+
+            if (auto texture = m_Textures.find(deviceMaterial.textureKeys.at(textureIndex));
+                texture != m_Textures.end() && texture->second.image.imageView != VK_NULL_HANDLE)
             {
-                deviceImageCreateParams.pBufferStaging = &stagingBuffer;
+                imageView = texture->second.image.imageView;
 
-                // Obtain a thread-local command pool for submission work on this thread.
-                m_RenderContext->CreateCommandPool(&deviceImageCreateParams.commandPool);
+                parameters.textureIndices.at(textureIndex) = static_cast<uint16_t>(deviceMaterialIndex * kMaterialTextureCount + textureIndex);
             }
 
-            // Create a base image description.
-            deviceImageCreateParams.info = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+            auto& imageInfo = imageInfos[writeIndex * kMaterialTextureCount + textureIndex];
             {
-                deviceImageCreateParams.info.imageType   = VK_IMAGE_TYPE_2D;
-                deviceImageCreateParams.info.arrayLayers = 1U;
-                deviceImageCreateParams.info.mipLevels   = 1U;
-                deviceImageCreateParams.info.samples     = VK_SAMPLE_COUNT_1_BIT;
-                deviceImageCreateParams.info.tiling      = VK_IMAGE_TILING_OPTIMAL;
-                deviceImageCreateParams.info.flags       = 0x0;
-                deviceImageCreateParams.info.usage       = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+                imageInfo.imageView   = imageView;
+                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             }
+        }
 
-            // Reset the device material list.
-            m_DeviceMaterials.clear();
+        // The inputs of a slot are adjacent, written with a single descriptor write.
+        auto& descriptorWrite = descriptorWrites[writeIndex];
+        {
+            descriptorWrite                 = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+            descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            descriptorWrite.descriptorCount = kMaterialTextureCount;
+            descriptorWrite.dstSet          = m_MaterialDataDescriptorSet;
+            descriptorWrite.dstBinding      = 0U;
+            descriptorWrite.dstArrayElement = deviceMaterialIndex * kMaterialTextureCount;
+            descriptorWrite.pImageInfo      = &imageInfos[writeIndex * kMaterialTextureCount];
+        }
 
-            // Process material requests.
-            while (!m_MaterialRequests.empty())
-            {
-                auto request = m_MaterialRequests.front();
+        m_pMaterialParametersMapped[deviceMaterialIndex] = parameters;
+    }
 
-                spdlog::info("Upload GPU Material ----> [{} / {}]", ++requestIndex, requestCount);
+    vkUpdateDescriptorSets(m_RenderContext->GetDevice(), static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0U, nullptr);
 
-                DeviceMaterial deviceMaterial;
+    vmaFlushAllocation(m_RenderContext->GetAllocator(), m_MaterialParameterBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
 
-                // Store the material CPU hash.
-                deviceMaterial.hash = request.pMaterial->GetId().GetHash();
+    m_DirtyMaterialSlots.clear();
+}
 
-                // Albedo
-                {
-                    deviceImageCreateParams.pData         = request.albedo.data;
-                    deviceImageCreateParams.pImageDevice  = &deviceMaterial.albedo;
-                    deviceImageCreateParams.bytesPerTexel = static_cast<VkDeviceSize>(request.albedo.stride);
-                    deviceImageCreateParams.info.format   = request.albedo.format;
-                    deviceImageCreateParams.info.extent   = { static_cast<uint32_t>(request.albedo.dim[0]),
-                                                              static_cast<uint32_t>(request.albedo.dim[1]),
-                                                              1U };
-
-                    m_RenderContext->CreateDeviceImageWithData(deviceImageCreateParams);
-                }
+uint32_t ResourceRegistry::TryFindDeviceMaterialIndex(size_t hash)
+{
+    // The default and free slots are not indexed.
+    auto deviceMaterialIndex = m_DeviceMaterialIndices.find(hash);
 
-                m_DeviceMaterials.push_back(deviceMaterial);
+    return deviceMaterialIndex != m_DeviceMaterialIndices.end() ? deviceMaterialIndex->second : UINT_MAX;
+}
 
-                // Request processed, remove.
-                m_MaterialRequests.pop();
-            }
+DrawItemMetaData ResourceRegistry::BuildDrawItemMetaData(const DrawItem& drawItem)
+{
+    DrawItemMetaData metaData {};
+    {
+        metaData.matrix = drawItem.pMesh->GetLocalToWorld();
 
-            // Initialize the device buffer upload info.
-            RenderContext::CreateDeviceBufferWithDataParams deviceBufferCreateParams {};
-            {
-                deviceBufferCreateParams.pBufferStaging = &stagingBuffer;
+        // Triangle count of the selected level of detail (kept up to date by the visibility pass).
+        metaData.faceCount = drawItem.pGeometry->lods.empty() ? 0U : drawItem.pGeometry->lods[drawItem.lodIndex].triangleCount;
 
-                // Obtain a thread-local command pool for submission work on this thread.
-                // (Re-use the one made for image creation).
-                deviceBufferCreateParams.commandPool = deviceImageCreateParams.commandPool;
-            }
+        metaData.instanceOffset = drawItem.instanceOffset;
+        metaData.instanceCount  = drawItem.instanceCount;
 
-            // Reset the draw items list (Warning: will leak VRAM currently).
-            m_DrawItems.clear();
+        metaData.materialIndex = TryFindDeviceMaterialIndex(drawItem.pMesh->GetMaterialHash());
 
-            requestCount = static_cast<uint32_t>(m_DrawItemRequests.size());
-            requestIndex = 0U;
+        // Unresolved materials sample the default image.
+        if (metaData.materialIndex == UINT_MAX)
+            metaData.materialIndex = kDefaultMaterialIndex;
 
-            // Track meta-data.
-            std::vector<DrawItemMetaData> drawItemMetaData;
+        metaData.indexOffset          = static_cast<uint32_t>(drawItem.pGeometry->indices.offset / sizeof(uint32_t));
+        metaData.positionBufferOffset = static_cast<uint32_t>(drawItem.pGeometry->positions.offset);
+        metaData.texCoordBufferOffset = static_cast<uint32_t>(drawItem.pGeometry->texCoords.offset);
 
-            // Utility for finding the material descriptor index for a draw item.
-            auto TryFindDeviceMaterialIndex = [this](const size_t& hash)
-            {
-                for (uint32_t deviceMaterialIndex = 0U; deviceMaterialIndex < m_DeviceMaterials.size(); deviceMaterialIndex++)
-                {
-                    if (m_DeviceMaterials[deviceMaterialIndex].hash == hash)
-                        return deviceMaterialIndex;
-                }
+#ifdef USE_QUANTIZED_VERTEX_STREAMS
+        GfVec3f positionScale, positionOffset;
+        GetPositionDequantization(drawItem.pGeometry->aabb, &positionScale, &positionOffset);
+
+        metaData.flags          = kDrawItemFlagQuantizedVertices;
+        metaData.positionScale  = GfVec4f(positionScale[0], positionScale[1], positionScale[2], 0.0F);
+        metaData.positionOffset = GfVec4f(positionOffset[0], positionOffset[1], positionOffset[2], 0.0F);
+#else
+        metaData.positionScale  = GfVec4f(1.0F, 1.0F, 1.0F, 0.0F);
+        metaData.positionOffset = GfVec4f(0.0F);
+#endif
+    }
 
-                // This need to point to the "default" descriptor.
-                return UINT_MAX;
-            };
+    return metaData;
+}
 
-            // Clear the requests.
-            while (!m_DrawItemRequests.empty())
-            {
-                auto request = m_DrawItemRequests.front();
+uint32_t ResourceRegistry::PrepareDrawItemUpdates(uint64_t frameIndex, uint32_t* pUpdateOffset)
+{
+    // The slice of a frame in flight is safe to overwrite once its fence has been waited on.
+    *pUpdateOffset = static_cast<uint32_t>(frameIndex % kMaxFramesInFlight) * kMaxDrawItemUpdatesPerFrame;
 
-                spdlog::info("Upload GPU Mesh ----> [{} / {}]", ++requestIndex, requestCount);
+    auto* pUpdates = m_pDrawItemUpdatesMapped + *pUpdateOffset;
 
-                DrawItem drawItem;
+    uint32_t updateCount = 0U;
 
-                // Forward the mesh pointer.
-                drawItem.pMesh = request.pMesh;
+    // Anything over the per-frame limit is left in the queue for the next frame.
+    DrawItemHandle handle {};
+    while (updateCount < kMaxDrawItemUpdatesPerFrame && m_DrawItemUpdates.try_pop(handle))
+    {
+        // Not uploaded yet (the meta-data will be built from the latest state once it is), or freed since.
+        if (handle.index >= m_DrawItems.size() || m_DrawItemGenerations[handle.index].load() != handle.generation ||
+            m_DrawItems[handle.index].pGeometry == nullptr)
+            continue;
 
-                // Compute index count.
-                drawItem.indexCount = static_cast<uint32_t>(request.indexBufferSize) / sizeof(uint32_t);
+        auto& drawItem = m_DrawItems[handle.index];
 
-                // Create index buffer.
-                {
-                    deviceBufferCreateParams.pData         = request.pIndexBufferHost;
-                    deviceBufferCreateParams.size          = request.indexBufferSize;
-                    deviceBufferCreateParams.pBufferDevice = &drawItem.bufferI;
-                    deviceBufferCreateParams.usage         = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-                    m_RenderContext->CreateDeviceBufferWithData(deviceBufferCreateParams);
-                }
+        pUpdates[updateCount].drawItemIndex = handle.index;
+        pUpdates[updateCount].metaData      = BuildDrawItemMetaData(drawItem);
 
-                // Create vertex buffer.
-                {
-                    deviceBufferCreateParams.pData         = request.pVertexBufferHost;
-                    deviceBufferCreateParams.size          = request.vertexBufferSize;
-                    deviceBufferCreateParams.pBufferDevice = &drawItem.bufferV;
-                    deviceBufferCreateParams.usage         = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-                    m_RenderContext->CreateDeviceBufferWithData(deviceBufferCreateParams);
-                }
+        // The acceleration structure holds its own copy of the transform.
+        if (!drawItem.brixelizerIDs.empty() && drawItem.brixelizerLocalToWorld != drawItem.pMesh->GetLocalToWorld())
+        {
+            m_RetiredBrixelizerInstances.insert(m_RetiredBrixelizerInstances.end(), drawItem.brixelizerIDs.begin(), drawItem.brixelizerIDs.end());
+            drawItem.brixelizerIDs.clear();
 
-                // Create texture coordinate buffer.
-                {
-                    deviceBufferCreateParams.pData         = request.pTexcoordBufferHost;
-                    deviceBufferCreateParams.size          = request.texcoordBufferSize;
-                    deviceBufferCreateParams.pBufferDevice = &drawItem.bufferST;
-                    deviceBufferCreateParams.usage         = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-                    m_RenderContext->CreateDeviceBufferWithData(deviceBufferCreateParams);
-                }
+            m_RetransformedBrixelizerDrawItems.push_back(handle);
+        }
 
-                // Push the draw item.
-                m_DrawItems.push_back(drawItem);
+        updateCount++;
+    }
 
-                DebugLabelBufferResource(m_RenderContext, drawItem.bufferI, "IndexBuffer");
-                DebugLabelBufferResource(m_RenderContext, drawItem.bufferV, "VertexBuffer");
-                DebugLabelBufferResource(m_RenderContext, drawItem.bufferST, "TexCoordBuffer");
+    if (updateCount > 0U)
+    {
+        Check(vmaFlushAllocation(m_RenderContext->GetAllocator(),
+                                 m_DrawItemUpdateBuffer.bufferAllocation,
+                                 sizeof(DrawItemMetaDataUpdate) * *pUpdateOffset,
+                                 sizeof(DrawItemMetaDataUpdate) * updateCount),
+              "Failed to flush draw item updates.");
+    }
 
-                // Push the gpu meta-data about the draw item.
-                DrawItemMetaData metaData {};
-                {
-                    metaData.matrix    = drawItem.pMesh->GetLocalToWorld();
-                    metaData.faceCount = drawItem.indexCount / 3U;
+    return updateCount;
+}
 
-                    // Search for material binding in the flattened GPU descriptor list, if any.
-                    metaData.materialIndex = TryFindDeviceMaterialIndex(drawItem.pMesh->GetMaterialHash());
-                }
-                drawItemMetaData.push_back(metaData);
+void ResourceRegistry::BuildDrawItem(uint32_t drawItemIndex, Mesh* pMesh, uint64_t contentHash, const DrawItemGeometry* pGeometry)
+{
+    auto& drawItem = m_DrawItems[drawItemIndex];
 
-                // Request processed, remove.
-                m_DrawItemRequests.pop();
-            }
+    // Forward the mesh and geometry pointers.
+    drawItem.pMesh       = pMesh;
+    drawItem.pGeometry   = pGeometry;
+    drawItem.contentHash = contentHash;
+    drawItem.lodIndex    = 0U;
+
+    // Copy the clusters into the meshlet heap, resolving the draw item they belong to and where their draw commands are written.
+    // Every level of detail is culled and compacted into its own command range / draw count.
+    {
+        std::vector<Meshlet> meshlets = pGeometry->meshlets;
+
+        drawItem.meshletRange    = m_GeometryHeap.Allocate(GeometryStream::Meshlet, sizeof(Meshlet) * meshlets.size());
+        drawItem.meshletOffset   = static_cast<uint32_t>(drawItem.meshletRange.offset / sizeof(Meshlet));
+        drawItem.meshletCount    = static_cast<uint32_t>(meshlets.size());
+        drawItem.drawCountOffset = drawItemIndex * kMaxLODCount;
 
-            // Upload the meta-data.
+        for (uint32_t lodIndex = 0U; lodIndex < pGeometry->lods.size(); lodIndex++)
+        {
+            const auto& lod = pGeometry->lods[lodIndex];
+
+            for (uint32_t meshletIndex = lod.meshletOffset; meshletIndex < lod.meshletOffset + lod.meshletCount; meshletIndex++)
             {
-                deviceBufferCreateParams.pData         = drawItemMetaData.data();
-                deviceBufferCreateParams.size          = sizeof(DrawItemMetaData) * drawItemMetaData.size();
-                deviceBufferCreateParams.pBufferDevice = &m_DrawItemMetaDataBuffer;
-                deviceBufferCreateParams.usage         = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-                m_RenderContext->CreateDeviceBufferWithData(deviceBufferCreateParams);
-                DebugLabelBufferResource(m_RenderContext, m_DrawItemMetaDataBuffer, "DrawItemMetaDataBuffer");
+                auto& meshlet = meshlets[meshletIndex];
+
+                meshlet.drawItemIndex     = drawItemIndex;
+                meshlet.drawCommandOffset = drawItem.meshletOffset + lod.meshletOffset;
+                meshlet.drawCountIndex    = drawItem.drawCountOffset + lodIndex;
             }
+        }
 
-            // Free the scratch memory.
-            vmaDestroyBuffer(m_RenderContext->GetAllocator(), stagingBuffer.buffer, stagingBuffer.bufferAllocation);
+        if (drawItem.meshletRange.size > 0U)
+            m_RenderContext->UploadBufferData(&m_StagingRing,
+                                              meshlets.data(),
+                                              drawItem.meshletRange.size,
+                                              m_GeometryHeap.GetBuffer(GeometryStream::Meshlet).buffer,
+                                              drawItem.meshletRange.offset);
+    }
 
-            // Create descriptors for the uploaded buffers.
-            BuildDescriptors();
+    // Copy the instance transforms (identity for non-instanced draw items).
+    {
+        std::vector<GfMatrix4f> instanceTransforms;
+
+        if (pMesh->IsInstanced())
+            instanceTransforms = pMesh->GetInstanceTransforms();
+        else
+            instanceTransforms.emplace_back(1.0F);
+
+        // The visibility buffer encodes the instance index in 16 bits.
+        Check(instanceTransforms.size() <= kMaxDrawItemInstances, "Exceeded the maximum number of instances per draw item.");
+
+        drawItem.instanceRange  = m_GeometryHeap.Allocate(GeometryStream::Instance, sizeof(GfMatrix4f) * instanceTransforms.size());
+        drawItem.instanceOffset = static_cast<uint32_t>(drawItem.instanceRange.offset / sizeof(GfMatrix4f));
+        drawItem.instanceCount  = static_cast<uint32_t>(instanceTransforms.size());
+
+        if (drawItem.instanceRange.size > 0U)
+            m_RenderContext->UploadBufferData(&m_StagingRing,
+                                              instanceTransforms.data(),
+                                              drawItem.instanceRange.size,
+                                              m_GeometryHeap.GetBuffer(GeometryStream::Instance).buffer,
+                                              drawItem.instanceRange.offset);
+    }
+}
 
-            // Free the thread local command pool.
-            vkDestroyCommandPool(m_RenderContext->GetDevice(), deviceBufferCreateParams.commandPool, nullptr);
+void ResourceRegistry::ReleaseDrawItem(DrawItem* pDrawItem)
+{
+    if (pDrawItem->pGeometry == nullptr)
+        return;
 
-            // Free host memory for buffer and image pools.
-            {
-                m_HostBufferPool.clear();
-                m_HostBufferPool.shrink_to_fit();
+    // The cull pass walks the meshlet heap up to the highest range in use, invalidate the freed clusters.
+    if (pDrawItem->meshletRange.size > 0U)
+    {
+        auto commandBuffer = m_StagingRing.GetCommandBuffer();
+
+        // Ordered after the copies already recorded into the range, and before the ones re-using it.
+        VulkanMemoryBarrier(commandBuffer,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+
+        vkCmdFillBuffer(commandBuffer,
+                        m_GeometryHeap.GetBuffer(GeometryStream::Meshlet).buffer,
+                        pDrawItem->meshletRange.offset,
+                        pDrawItem->meshletRange.size,
+                        UINT32_MAX);
+
+        VulkanMemoryBarrier(commandBuffer,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+    }
 
-                m_HostImagePool.clear();
-                m_HostImagePool.shrink_to_fit();
+    m_GeometryHeap.Free(GeometryStream::Meshlet, &pDrawItem->meshletRange);
+    m_GeometryHeap.Free(GeometryStream::Instance, &pDrawItem->instanceRange);
 
-                m_HostBufferPoolSize = 0LL;
-                m_HostImagePoolSize  = 0LL;
-            }
+    ReleaseGeometry(pDrawItem->contentHash);
 
-            spdlog::info("Graphics resource upload complete.");
+    m_RetiredBrixelizerInstances.insert(m_RetiredBrixelizerInstances.end(), pDrawItem->brixelizerIDs.begin(), pDrawItem->brixelizerIDs.end());
 
-            // Idle.
-            m_CommitTaskBusy.store(false);
-        });
+    *pDrawItem = {};
 }
 
-void ResourceRegistry::_GarbageCollect()
+void ResourceRegistry::ReleaseGeometry(uint64_t contentHash)
 {
-    vkDeviceWaitIdle(m_RenderContext->GetDevice());
+    std::lock_guard<std::mutex> claimLock(m_GeometryClaimMutex);
 
-    vkDestroyDescriptorSetLayout(m_RenderContext->GetDevice(), m_DrawItemDataDescriptorLayout, nullptr);
-    vkDestroyDescriptorSetLayout(m_RenderContext->GetDevice(), m_MaterialDataDescriptorLayout, nullptr);
+    auto claim = m_GeometryClaims.find(contentHash);
 
-    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawItemMetaDataBuffer.buffer, m_DrawItemMetaDataBuffer.bufferAllocation);
+    if (claim == m_GeometryClaims.end() || --claim->second > 0U)
+        return;
+
+    m_GeometryClaims.erase(claim);
 
+    // Last reference, return the streams to the heap.
+    if (auto geometry = m_Geometry.find(contentHash); geometry != m_Geometry.end())
     {
-        // Default image.
-        vkDestroyImageView(m_RenderContext->GetDevice(), m_DefaultImage.imageView, nullptr);
-        vmaDestroyImage(m_RenderContext->GetAllocator(), m_DefaultImage.image, m_DefaultImage.imageAllocation);
+        m_GeometryHeap.Free(GeometryStream::Index, &geometry->second.indices);
+        m_GeometryHeap.Free(GeometryStream::Position, &geometry->second.positions);
+        m_GeometryHeap.Free(GeometryStream::TexCoord, &geometry->second.texCoords);
+
+        m_Geometry.erase(geometry);
     }
+}
 
-    vkDestroySampler(m_RenderContext->GetDevice(), m_DeviceMaterialImageSampler, nullptr);
+void ResourceRegistry::ReleaseTexture(uint64_t textureKey)
+{
+    std::lock_guard<std::mutex> claimLock(m_TextureClaimMutex);
+
+    auto claim = m_TextureClaims.find(textureKey);
+
+    if (claim == m_TextureClaims.end() || --claim->second > 0U)
+        return;
 
-    for (auto& drawItem : m_DrawItems)
+    m_TextureClaims.erase(claim);
+
+    // Last reference, destroy the image (the slots sampling it are re-written by the same commit).
+    if (auto texture = m_Textures.find(textureKey); texture != m_Textures.end())
     {
-        vmaDestroyBuffer(m_RenderContext->GetAllocator(), drawItem.bufferI.buffer, drawItem.bufferI.bufferAllocation);
-        vmaDestroyBuffer(m_RenderContext->GetAllocator(), drawItem.bufferV.buffer, drawItem.bufferV.bufferAllocation);
-        vmaDestroyBuffer(m_RenderContext->GetAllocator(), drawItem.bufferST.buffer, drawItem.bufferST.bufferAllocation);
+        auto& image = texture->second.image;
+
+        if (image.imageView != VK_NULL_HANDLE)
+            vkDestroyImageView(m_RenderContext->GetDevice(), image.imageView, nullptr);
+
+        vmaDestroyImage(m_RenderContext->GetAllocator(), image.image, image.imageAllocation);
+
+        m_Textures.erase(texture);
     }
+}
 
-    auto ReleaseDeviceMaterialImage = [this](Image* pImage)
-    {
-        if (pImage->imageView != VK_NULL_HANDLE)
-            vkDestroyImageView(m_RenderContext->GetDevice(), pImage->imageView, nullptr);
+void ResourceRegistry::CreateTextureImage(DeviceTexture* pTexture, void* pTexels, uint32_t texelMipLevels)
+{
+    // Streamed textures start at their resident level (the first one for every other texture).
+    auto mipLevels = pTexture->mipLevels - pTexture->residentMipLevel;
 
-        vmaDestroyImage(m_RenderContext->GetAllocator(), pImage->image, pImage->imageAllocation);
-    };
+    VkExtent3D extent = { std::max(pTexture->extent.width >> pTexture->residentMipLevel, 1U),
+                          std::max(pTexture->extent.height >> pTexture->residentMipLevel, 1U),
+                          1U };
 
-    for (auto& deviceMaterial : m_DeviceMaterials)
+    RenderContext::CreateDeviceImageWithDataParams deviceImageCreateParams {};
     {
-        ReleaseDeviceMaterialImage(&deviceMaterial.albedo);
+        deviceImageCreateParams.pData         = pTexels;
+        deviceImageCreateParams.pImageDevice  = &pTexture->image;
+        deviceImageCreateParams.pStagingRing  = &m_StagingRing;
+        deviceImageCreateParams.bytesPerTexel = pTexture->bytesPerTexel;
+        deviceImageCreateParams.generateMips  = texelMipLevels < mipLevels;
+        deviceImageCreateParams.components    = pTexture->components;
     }
-}
 
-// ------------------------------------------------
+    deviceImageCreateParams.info = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+    {
+        deviceImageCreateParams.info.imageType   = VK_IMAGE_TYPE_2D;
+        deviceImageCreateParams.info.format      = pTexture->format;
+        deviceImageCreateParams.info.extent      = extent;
+        deviceImageCreateParams.info.arrayLayers = 1U;
+        deviceImageCreateParams.info.mipLevels   = mipLevels;
+        deviceImageCreateParams.info.samples     = VK_SAMPLE_COUNT_1_BIT;
+        deviceImageCreateParams.info.tiling      = VK_IMAGE_TILING_OPTIMAL;
+        deviceImageCreateParams.info.flags       = 0x0;
+        deviceImageCreateParams.info.usage       = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
 
-void ResourceRegistry::PushDrawItemRequest(DrawItemRequest& request)
-{
-    std::lock_guard<std::mutex> lock(m_HostBufferPoolMutex);
+    m_RenderContext->CreateDeviceImageWithData(deviceImageCreateParams);
+}
 
-    auto bufferSizeIPrev = m_HostBufferPoolSize;
-    m_HostBufferPoolSize += request.indexBufferSize;
+void ResourceRegistry::StreamTextureImage(DeviceTexture* pTexture, uint32_t mipLevel)
+{
+    // Nothing in flight samples the previous image (frames skip the registry while the commit task runs).
+    if (pTexture->image.image != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(m_RenderContext->GetDevice(), pTexture->image.imageView, nullptr);
+        vmaDestroyImage(m_RenderContext->GetAllocator(), pTexture->image.image, pTexture->image.imageAllocation);
 
-    auto bufferSizeVPrev = m_HostBufferPoolSize;
-    m_HostBufferPoolSize += request.vertexBufferSize;
+        pTexture->image = {};
+    }
 
-    auto bufferSizeSTPrev = m_HostBufferPoolSize;
-    m_HostBufferPoolSize += request.texcoordBufferSize;
+    pTexture->residentMipLevel = mipLevel;
 
-    // Map a pointer back in the pool that the client can fill with data.
-    request.pIndexBufferHost    = reinterpret_cast<void*>(&m_HostBufferPool.at(bufferSizeIPrev));
-    request.pVertexBufferHost   = reinterpret_cast<void*>(&m_HostBufferPool.at(bufferSizeVPrev));
-    request.pTexcoordBufferHost = reinterpret_cast<void*>(&m_HostBufferPool.at(bufferSizeSTPrev));
+    auto texelOffset = GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerTexel, mipLevel);
 
-    // Push the request.
-    m_DrawItemRequests.push(request);
+    CreateTextureImage(pTexture, pTexture->hostTexels.data() + texelOffset, pTexture->mipLevels - mipLevel);
 }
 
-void ResourceRegistry::PushMaterialRequest(MaterialRequest& request)
+bool ResourceRegistry::UpdateTextureUsage()
 {
-    std::lock_guard<std::mutex> lock(m_HostImagePoolMutex);
+    if (m_Textures.empty())
+        return false;
 
-    auto imageSizeAlbedoPrev = m_HostImagePoolSize;
-    m_HostImagePoolSize += static_cast<uint64_t>(request.albedo.stride * request.albedo.dim[0]) * request.albedo.dim[1];
+    vmaInvalidateAllocation(m_RenderContext->GetAllocator(), m_DrawItemFeedbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
 
-    // Map a pointer back in the pool that the client can fill with data.
-    request.albedo.data = reinterpret_cast<void*>(&m_HostImagePool.at(imageSizeAlbedoPrev));
+    // A texture is in use as long as any draw item sampling it is visible.
+    for (uint32_t drawItemIndex = 0U; drawItemIndex < m_DrawItems.size(); drawItemIndex++)
+    {
+        const auto& drawItem = m_DrawItems[drawItemIndex];
 
-    m_MaterialRequests.push(request);
+        if (drawItem.pGeometry == nullptr)
+            continue;
+
+        auto deviceMaterialIndex = TryFindDeviceMaterialIndex(drawItem.pMesh->GetMaterialHash());
+
+        if (deviceMaterialIndex == UINT_MAX)
+            continue;
+
+        for (auto textureKey : m_DeviceMaterials[deviceMaterialIndex].textureKeys)
+        {
+            if (auto texture = m_Textures.find(textureKey); texture != m_Textures.end())
+                texture->second.lastUsedFrame = std::max(texture->second.lastUsedFrame, static_cast<uint64_t>(m_pDrawItemFeedbackMapped[drawItemIndex]));
+        }
+    }
+
+    auto frameCount = m_RenderContext->GetFrameSubmitCount();
+
+    // Streamed textures request their initial level unless a material sampling them was recently visible.
+    for (auto& texture : m_Textures | std::views::values)
+    {
+        if (texture.isStreamed)
+            texture.requestedMipLevel = GetMipLevelForResolution(texture, kStreamingInitialResolutionLog2);
+    }
+
+    vmaInvalidateAllocation(m_RenderContext->GetAllocator(), m_MaterialFeedbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
+
+    // Each material slot holds the frame it was last sampled in (upper 28 bits), and the largest texel resolution
+    // (log2) a visible pixel asked for in that frame.
+    for (uint32_t deviceMaterialIndex = 0U; deviceMaterialIndex < m_DeviceMaterials.size(); deviceMaterialIndex++)
+    {
+        auto feedback = m_pMaterialFeedbackMapped[deviceMaterialIndex];
+
+        if (feedback == 0U || (feedback >> 4U) + kResidencyIdleFrames < (frameCount & 0x0FFFFFFFU))
+            continue;
+
+        // Every input of a material is sampled with the same texture coordinates.
+        for (auto textureKey : m_DeviceMaterials[deviceMaterialIndex].textureKeys)
+        {
+            if (auto texture = m_Textures.find(textureKey); texture != m_Textures.end() && texture->second.isStreamed)
+            {
+                auto mipLevel = GetMipLevelForResolution(texture->second, feedback & 0xFU);
+
+                texture->second.requestedMipLevel = std::min(texture->second.requestedMipLevel, mipLevel);
+            }
+        }
+    }
+
+    uint64_t usageBytes  = 0U;
+    uint64_t budgetBytes = 0U;
+    GetDeviceMemoryBudget(m_RenderContext->GetAllocator(), usageBytes, budgetBytes);
+
+    auto targetBytes = static_cast<uint64_t>(static_cast<double>(budgetBytes) * kDeviceMemoryBudgetUsage);
+
+    for (const auto& texture : m_Textures | std::views::values)
+    {
+        auto isIdle = texture.lastUsedFrame + kResidencyIdleFrames < frameCount;
+
+        if (texture.image.image != VK_NULL_HANDLE && isIdle && usageBytes > targetBytes)
+            return true;
+
+        if (texture.image.image == VK_NULL_HANDLE && !texture.hostTexels.empty() && !isIdle)
+        {
+            auto restoreBytes = texture.isStreamed ? GetResidentSize(texture, texture.requestedMipLevel) : texture.hostTexels.size();
+
+            if (usageBytes + restoreBytes <= targetBytes)
+                return true;
+        }
+
+        if (texture.isStreamed && texture.image.image != VK_NULL_HANDLE && !isIdle)
+        {
+            auto residentBytes  = GetResidentSize(texture, texture.residentMipLevel);
+            auto requestedBytes = GetResidentSize(texture, texture.requestedMipLevel);
+
+            if (texture.requestedMipLevel < texture.residentMipLevel && usageBytes + requestedBytes - residentBytes <= targetBytes)
+                return true;
+
+            if (texture.requestedMipLevel > texture.residentMipLevel && usageBytes > targetBytes)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+void ResourceRegistry::UpdateTextureResidency(std::unordered_set<uint64_t>* pChangedTextureKeys)
+{
+    uint64_t usageBytes  = 0U;
+    uint64_t budgetBytes = 0U;
+    GetDeviceMemoryBudget(m_RenderContext->GetAllocator(), usageBytes, budgetBytes);
+
+    auto targetBytes = static_cast<uint64_t>(static_cast<double>(budgetBytes) * kDeviceMemoryBudgetUsage);
+    auto frameCount  = m_RenderContext->GetFrameSubmitCount();
+
+    // Resident (or evicted) textures, least recently visible first. Textures uploaded by this commit are left alone.
+    std::vector<std::pair<uint64_t, DeviceTexture*>> textures;
+
+    for (auto& [textureKey, texture] : m_Textures)
+    {
+        if (!pChangedTextureKeys->contains(textureKey) && (texture.image.image != VK_NULL_HANDLE || !texture.hostTexels.empty()))
+            textures.emplace_back(textureKey, &texture);
+    }
+
+    std::ranges::sort(textures, [](const auto& a, const auto& b) { return a.second->lastUsedFrame < b.second->lastUsedFrame; });
+
+    // Eviction
+    // ---------------------------------
+
+    std::vector<std::pair<uint64_t, DeviceTexture*>> evictions;
+    VkDeviceSize                                     readbackSize          = 0U;
+    uint32_t                                         streamedEvictionCount = 0U;
+
+    for (const auto& texture : textures)
+    {
+        if (usageBytes <= targetBytes || texture.second->lastUsedFrame + kResidencyIdleFrames >= frameCount)
+            break;
+
+        if (texture.second->image.image == VK_NULL_HANDLE)
+            continue;
+
+        VmaAllocationInfo allocationInfo {};
+        vmaGetAllocationInfo(m_RenderContext->GetAllocator(), texture.second->image.imageAllocation, &allocationInfo);
+
+        usageBytes -= std::min(usageBytes, static_cast<uint64_t>(allocationInfo.size));
+
+        // Streamed textures still hold their chain on the host, no readback needed.
+        if (texture.second->isStreamed)
+        {
+            vkDestroyImageView(m_RenderContext->GetDevice(), texture.second->image.imageView, nullptr);
+            vmaDestroyImage(m_RenderContext->GetAllocator(), texture.second->image.image, texture.second->image.imageAllocation);
+
+            texture.second->image = {};
+
+            pChangedTextureKeys->insert(texture.first);
+            streamedEvictionCount++;
+
+            continue;
+        }
+
+        // Texel aligned offsets (and at least 4 bytes, as required for image -> buffer copies).
+        auto alignment = std::lcm(texture.second->bytesPerTexel, static_cast<VkDeviceSize>(4U));
+
+        readbackSize = (readbackSize + alignment - 1U) / alignment * alignment;
+        readbackSize += GetMipChainSize(texture.second->extent, texture.second->format, texture.second->bytesPerTexel, texture.second->mipLevels);
+
+        evictions.push_back(texture);
+    }
+
+    if (!evictions.empty())
+    {
+        Buffer readbackBuffer;
+
+        VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        {
+            bufferInfo.size  = readbackSize;
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        }
+
+        VmaAllocationCreateInfo allocInfo = {};
+        {
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        }
+
+        VmaAllocationInfo allocationInfo {};
+        Check(vmaCreateBuffer(m_RenderContext->GetAllocator(), &bufferInfo, &allocInfo, &readbackBuffer.buffer, &readbackBuffer.bufferAllocation, &allocationInfo),
+              "Failed to create texture readback buffer.");
+
+        // Copy every evicted texture back in one submission (blocks the graphics queue until it completes).
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        SingleShotCommandBegin(m_RenderContext, cmd, m_ResidencyCommandPool);
+
+        std::vector<VkDeviceSize> readbackOffsets;
+        VkDeviceSize              readbackOffset = 0U;
+
+        for (const auto& eviction : evictions)
+        {
+            const auto* pTexture = eviction.second;
+
+            auto alignment = std::lcm(pTexture->bytesPerTexel, static_cast<VkDeviceSize>(4U));
+
+            readbackOffset = (readbackOffset + alignment - 1U) / alignment * alignment;
+            readbackOffsets.push_back(readbackOffset);
+
+            VulkanColorImageBarrier(cmd,
+                                    pTexture->image.image,
+                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                    VK_ACCESS_2_SHADER_READ_BIT,
+                                    VK_ACCESS_2_TRANSFER_READ_BIT,
+                                    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                    0U,
+                                    pTexture->mipLevels);
+
+            // Read back the whole mip chain, so it does not have to be generated again on restore.
+            std::vector<VkBufferImageCopy> bufferImageCopyInfos(pTexture->mipLevels);
+
+            for (uint32_t mipLevel = 0U; mipLevel < pTexture->mipLevels; mipLevel++)
+            {
+                auto& bufferImageCopyInfo = bufferImageCopyInfos[mipLevel];
+                {
+                    bufferImageCopyInfo.bufferOffset     = readbackOffset + GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerTexel, mipLevel);
+                    bufferImageCopyInfo.imageExtent      = { std::max(pTexture->extent.width >> mipLevel, 1U), std::max(pTexture->extent.height >> mipLevel, 1U), 1U };
+                    bufferImageCopyInfo.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0U, 1U };
+                }
+            }
+
+            vkCmdCopyImageToBuffer(cmd,
+                                   pTexture->image.image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   readbackBuffer.buffer,
+                                   static_cast<uint32_t>(bufferImageCopyInfos.size()),
+                                   bufferImageCopyInfos.data());
+
+            readbackOffset += GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerTexel, pTexture->mipLevels);
+        }
+
+        VulkanMemoryBarrier(cmd, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_ACCESS_2_HOST_READ_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_HOST_BIT);
+
+        SingleShotCommandEnd(m_RenderContext, cmd, m_ResidencyCommandPool);
+
+        vmaInvalidateAllocation(m_RenderContext->GetAllocator(), readbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
+
+        for (uint32_t evictionIndex = 0U; evictionIndex < evictions.size(); evictionIndex++)
+        {
+            auto* pTexture = evictions[evictionIndex].second;
+
+            const auto* pTexels = static_cast<const std::byte*>(allocationInfo.pMappedData) + readbackOffsets[evictionIndex];
+
+            pTexture->hostTexels.assign(pTexels, pTexels + GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerTexel, pTexture->mipLevels));
+            pTexture->hostMipLevels = pTexture->mipLevels;
+
+            vkDestroyImageView(m_RenderContext->GetDevice(), pTexture->image.imageView, nullptr);
+            vmaDestroyImage(m_RenderContext->GetAllocator(), pTexture->image.image, pTexture->image.imageAllocation);
+
+            pTexture->image = {};
+
+            pChangedTextureKeys->insert(evictions[evictionIndex].first);
+        }
+
+        vmaDestroyBuffer(m_RenderContext->GetAllocator(), readbackBuffer.buffer, readbackBuffer.bufferAllocation);
+
+        spdlog::info("Texture Residency | Evicted {} textures ({} MB)", evictions.size(), readbackSize >> 20U);
+    }
+
+    if (streamedEvictionCount > 0U)
+        spdlog::info("Texture Residency | Evicted {} streamed textures", streamedEvictionCount);
+
+    // Coarsening (visible streamed textures drop the levels finer than requested while still over budget)
+    // ---------------------------------
+
+    uint32_t coarsenCount = 0U;
+
+    for (const auto& texture : textures)
+    {
+        if (usageBytes <= targetBytes)
+            break;
+
+        auto* pTexture = texture.second;
+
+        if (!pTexture->isStreamed || pTexture->image.image == VK_NULL_HANDLE || pTexture->requestedMipLevel <= pTexture->residentMipLevel)
+            continue;
+
+        usageBytes -= std::min(usageBytes, GetResidentSize(*pTexture, pTexture->residentMipLevel) - GetResidentSize(*pTexture, pTexture->requestedMipLevel));
+
+        StreamTextureImage(pTexture, pTexture->requestedMipLevel);
+
+        pChangedTextureKeys->insert(texture.first);
+        coarsenCount++;
+    }
+
+    // Restoration / Refinement (most recently visible first)
+    // ---------------------------------
+
+    uint32_t     restoreCount = 0U;
+    uint32_t     refineCount  = 0U;
+    VkDeviceSize streamBytes  = 0U;
+
+    for (const auto& texture : std::ranges::reverse_view(textures))
+    {
+        if (texture.second->lastUsedFrame + kResidencyIdleFrames < frameCount)
+            break;
+
+        auto* pTexture = texture.second;
+
+        if (pTexture->isStreamed)
+        {
+            auto isResident = pTexture->image.image != VK_NULL_HANDLE;
+
+            if (isResident && pTexture->requestedMipLevel >= pTexture->residentMipLevel)
+                continue;
+
+            // Evicted textures are restored at their requested level directly.
+            auto residentBytes  = isResident ? GetResidentSize(*pTexture, pTexture->residentMipLevel) : 0U;
+            auto requestedBytes = GetResidentSize(*pTexture, pTexture->requestedMipLevel);
+
+            if (usageBytes + requestedBytes - residentBytes > targetBytes || streamBytes + requestedBytes > kStreamingUploadBytes)
+                continue;
+
+            StreamTextureImage(pTexture, pTexture->requestedMipLevel);
+
+            (isResident ? refineCount : restoreCount)++;
+
+            usageBytes += requestedBytes - residentBytes;
+            streamBytes += requestedBytes;
+
+            pChangedTextureKeys->insert(texture.first);
+            continue;
+        }
+
+        if (pTexture->hostTexels.empty() || usageBytes + pTexture->hostTexels.size() > targetBytes)
+            continue;
+
+        CreateTextureImage(pTexture, pTexture->hostTexels.data(), pTexture->hostMipLevels);
+
+        usageBytes += pTexture->hostTexels.size();
+
+        // The texels have been copied into the staging ring.
+        std::vector<std::byte>().swap(pTexture->hostTexels);
+
+        pChangedTextureKeys->insert(texture.first);
+        restoreCount++;
+    }
+
+    if (restoreCount > 0U)
+        spdlog::info("Texture Residency | Restored {} textures", restoreCount);
+
+    if (coarsenCount + refineCount > 0U)
+        spdlog::info("Texture Streaming | Refined {} textures | Coarsened {} textures | Uploaded {} MB", refineCount, coarsenCount, streamBytes >> 20U);
+}
+
+void ResourceRegistry::_Commit()
+{
+    if (m_CommitTaskBusy.load())
+        return;
+
+    // Nothing is in flight (and Hydra does not sync concurrently to the commit), rewind the idle staging arenas. Every
+    // request releases its staging copy when it is processed, the arenas check that none is left alive.
+    // Decodes push their request before retiring, so none can be missed once the pending count drops to zero.
+    if (m_PendingTextureDecodes.load() == 0U && m_TextureRequests.empty())
+        m_HostImageArena.Reset();
+
+    if (m_DrawItemRequests.empty())
+        m_HostBufferArena.Reset();
+
+    // Texture residency is re-evaluated every few frames, and only commits if textures must be evicted or restored.
+    auto updateResidency = false;
+
+    if (m_RenderContext->GetFrameSubmitCount() >= m_ResidencyUpdateFrame + kResidencyUpdateFrames)
+    {
+        m_ResidencyUpdateFrame = m_RenderContext->GetFrameSubmitCount();
+
+        updateResidency = UpdateTextureUsage();
+    }
+
+    if (m_DrawItemRequests.empty() && m_MaterialRequests.empty() && m_TextureRequests.empty() && m_DrawItemReleases.empty() &&
+        m_MaterialReleases.empty() && !updateResidency)
+        return;
+
+    // Resources are only replaced or freed once the next frame has taken over the previous commit's uploads.
+    if (m_RenderContext->HasPendingFrameAcquires())
+        return;
+
+    // Every frame submitted so far may reference the resources replaced or freed by this commit, later frames skip the
+    // registry until it is idle.
+    auto retireFrameCount = m_RenderContext->GetFrameSubmitCount();
+
+    // Busy.
+    m_CommitTaskBusy.store(true);
+
+    m_CommitTask.run(
+        [&, retireFrameCount, updateResidency]
+        {
+            m_RenderContext->WaitForFrames(retireFrameCount);
+
+            // Destroyed prims, popped ahead of the requests so that no request outlives the release of its mesh.
+            std::vector<Mesh*>              releasedMeshes;
+            std::unordered_set<const Mesh*> releasedMeshSet;
+            {
+                Mesh* pMesh = nullptr;
+                while (m_DrawItemReleases.try_pop(pMesh))
+                {
+                    releasedMeshes.push_back(pMesh);
+                    releasedMeshSet.insert(pMesh);
+                }
+            }
+
+            // Materials added or removed by this commit, the draw items bound to them re-resolve their slot.
+            std::unordered_set<size_t> changedMaterialHashes;
+
+            // Process material releases, the slot is recycled once its descriptor reverts to the default image.
+            size_t materialHash = 0U;
+            while (m_MaterialReleases.try_pop(materialHash))
+            {
+                auto deviceMaterialIndex = TryFindDeviceMaterialIndex(materialHash);
+
+                if (deviceMaterialIndex == UINT_MAX)
+                    continue;
+
+                for (auto textureKey : m_DeviceMaterials[deviceMaterialIndex].textureKeys)
+                    ReleaseTexture(textureKey);
+
+                // The next material in the slot starts out unsampled.
+                m_pMaterialFeedbackMapped[deviceMaterialIndex] = 0U;
+
+                m_DeviceMaterials[deviceMaterialIndex] = {};
+                m_DeviceMaterialIndices.erase(materialHash);
+                m_FreeMaterialSlots.push_back(deviceMaterialIndex);
+                m_DirtyMaterialSlots.push_back(deviceMaterialIndex);
+
+                changedMaterialHashes.insert(materialHash);
+            }
+
+            vmaFlushAllocation(m_RenderContext->GetAllocator(), m_MaterialFeedbackBuffer.bufferAllocation, 0U, VK_WHOLE_SIZE);
+
+            auto requestCount = static_cast<uint32_t>(m_MaterialRequests.unsafe_size());
+            auto requestIndex = 0U;
+
+            // Textures uploaded, evicted or restored by this commit, the slots of every material sampling them are re-written.
+            std::unordered_set<uint64_t> changedTextureKeys;
+
+            // New textures that do not fit in the device memory budget start out evicted.
+            uint64_t usageBytes  = 0U;
+            uint64_t budgetBytes = 0U;
+            GetDeviceMemoryBudget(m_RenderContext->GetAllocator(), usageBytes, budgetBytes);
+
+            auto targetBytes = static_cast<uint64_t>(static_cast<double>(budgetBytes) * kDeviceMemoryBudgetUsage);
+
+            // Process material requests, replacing the slot of a material already uploaded.
+            MaterialRequest materialRequest {};
+            while (m_MaterialRequests.try_pop(materialRequest))
+            {
+                spdlog::info("Upload GPU Material ----> [{} / {}]", ++requestIndex, requestCount);
+
+                auto deviceMaterialIndex = TryFindDeviceMaterialIndex(materialRequest.hash);
+
+                if (deviceMaterialIndex == UINT_MAX)
+                {
+                    if (!m_FreeMaterialSlots.empty())
+                    {
+                        deviceMaterialIndex = m_FreeMaterialSlots.back();
+                        m_FreeMaterialSlots.pop_back();
+                    }
+                    else
+                    {
+                        Check(m_DeviceMaterials.size() < kMaxMaterials, "Exceeded the maximum number of materials.");
+
+                        deviceMaterialIndex = static_cast<uint32_t>(m_DeviceMaterials.size());
+                        m_DeviceMaterials.emplace_back();
+                    }
+
+                    m_DeviceMaterials[deviceMaterialIndex].hash   = materialRequest.hash;
+                    m_DeviceMaterialIndices[materialRequest.hash] = deviceMaterialIndex;
+
+                    changedMaterialHashes.insert(materialRequest.hash);
+                }
+                else
+                {
+                    // Drop the references of the request this one replaces.
+                    for (auto textureKey : m_DeviceMaterials[deviceMaterialIndex].textureKeys)
+                        ReleaseTexture(textureKey);
+                }
+
+                // A texture still decoding is sampled once it is uploaded (the slot is re-written then).
+                m_DeviceMaterials[deviceMaterialIndex].textureKeys = materialRequest.textureKeys;
+                m_DeviceMaterials[deviceMaterialIndex].parameters  = materialRequest.parameters;
+
+                m_DirtyMaterialSlots.push_back(deviceMaterialIndex);
+            }
+
+            // Process the textures decoded so far (after the material requests, so that no texture recorded for upload
+            // is destroyed by a release in the same commit). The rest is picked up by later commits.
+            TextureRequest textureRequest {};
+            while (m_TextureRequests.try_pop(textureRequest))
+            {
+                auto textureBytes = GetHostAllocationSize(textureRequest);
+
+                // Skip textures released while decoding, or already uploaded by an earlier decode of the same key.
+                auto isClaimed = false;
+                {
+                    std::lock_guard<std::mutex> claimLock(m_TextureClaimMutex);
+                    isClaimed = m_TextureClaims.contains(textureRequest.key);
+                }
+
+                if (isClaimed && !m_Textures.contains(textureRequest.key))
+                {
+                    auto& texture = m_Textures[textureRequest.key];
+                    {
+                        texture.format        = textureRequest.image.format;
+                        texture.bytesPerTexel = static_cast<VkDeviceSize>(textureRequest.image.stride);
+                        texture.extent        = { static_cast<uint32_t>(textureRequest.image.dim[0]), static_cast<uint32_t>(textureRequest.image.dim[1]), 1U };
+                        texture.mipLevels     = std::max(textureRequest.image.mipLevels, 1U);
+                        texture.components    = textureRequest.image.components;
+
+                        // Images without pre-computed levels get their full chain blitted on the device.
+                        if (texture.mipLevels == 1U && m_RenderContext->SupportsMipGeneration(texture.format))
+                            texture.mipLevels = GetMipChainLevels(texture.extent);
+
+                        // Not evicted before it had a chance to be visible.
+                        texture.lastUsedFrame = retireFrameCount;
+                    }
+
+                    auto texelLevels = std::max(textureRequest.image.mipLevels, 1U);
+                    auto deviceBytes = GetMipChainSize(texture.extent, texture.format, texture.bytesPerTexel, texture.mipLevels);
+
+                    // Textures decoded with their full chain are streamed, starting from a low resolution level.
+                    texture.isStreamed = m_StreamTextures && textureRequest.image.data != nullptr && texture.mipLevels > 1U && texelLevels == texture.mipLevels;
+
+                    if (texture.isStreamed)
+                    {
+                        const auto* pTexels = static_cast<const std::byte*>(textureRequest.image.data);
+                        texture.hostTexels.assign(pTexels, pTexels + textureBytes);
+                        texture.hostMipLevels = texelLevels;
+
+                        texture.requestedMipLevel = GetMipLevelForResolution(texture, kStreamingInitialResolutionLog2);
+
+                        // Starts out evicted (restored at the requested level) if even the initial level does not fit.
+                        if (usageBytes + GetResidentSize(texture, texture.requestedMipLevel) <= targetBytes)
+                        {
+                            StreamTextureImage(&texture, texture.requestedMipLevel);
+
+                            usageBytes += GetResidentSize(texture, texture.requestedMipLevel);
+                        }
+                    }
+                    else if (usageBytes + deviceBytes <= targetBytes)
+                    {
+                        CreateTextureImage(&texture, textureRequest.image.data, texelLevels);
+
+                        usageBytes += deviceBytes;
+                    }
+                    else if (textureRequest.image.data != nullptr)
+                    {
+                        const auto* pTexels = static_cast<const std::byte*>(textureRequest.image.data);
+                        texture.hostTexels.assign(pTexels, pTexels + textureBytes);
+                        texture.hostMipLevels = texelLevels;
+                    }
+
+                    changedTextureKeys.insert(textureRequest.key);
+                }
+
+                // The staging copy has been consumed.
+                m_HostImageArena.Release(textureRequest.image.data, textureBytes);
+            }
+
+            if (updateResidency)
+                UpdateTextureResidency(&changedTextureKeys);
+
+            if (!changedTextureKeys.empty())
+            {
+                for (uint32_t deviceMaterialIndex = 0U; deviceMaterialIndex < m_DeviceMaterials.size(); deviceMaterialIndex++)
+                {
+                    if (std::ranges::any_of(m_DeviceMaterials[deviceMaterialIndex].textureKeys,
+                                            [&](uint64_t textureKey) { return changedTextureKeys.contains(textureKey); }))
+                        m_DirtyMaterialSlots.push_back(deviceMaterialIndex);
+                }
+
+                spdlog::info("Texture Cache | Materials: {} | Textures: {}", m_DeviceMaterialIndices.size(), m_Textures.size());
+            }
+
+            // Upload the geometry owners first, so that every other request can resolve its shared geometry.
+            std::vector<DrawItemRequest> drawItemRequests;
+            {
+                DrawItemRequest drawItemRequest {};
+                while (m_DrawItemRequests.try_pop(drawItemRequest))
+                    drawItemRequests.push_back(drawItemRequest);
+
+                std::stable_partition(drawItemRequests.begin(), drawItemRequests.end(), [](const DrawItemRequest& request) { return request.ownsGeometry; });
+            }
+
+            requestCount = static_cast<uint32_t>(drawItemRequests.size());
+            requestIndex = 0U;
+
+            // Slots whose meta-data is re-uploaded.
+            std::vector<uint32_t> dirtyDrawItems;
+
+            uint32_t builtDrawItemCount    = 0U;
+            uint32_t releasedDrawItemCount = 0U;
+
+            for (const auto& drawItemRequest : drawItemRequests)
+            {
+                if (drawItemRequest.ownsGeometry)
+                {
+                    spdlog::info("Upload GPU Mesh ----> [{} / {}]", ++requestIndex, requestCount);
+
+                    DrawItemGeometry geometry;
+
+                    geometry.aabb = drawItemRequest.pMesh->GetAABB();
+
+                    geometry.meshlets.resize(drawItemRequest.meshletBufferSize / sizeof(Meshlet));
+                    memcpy(geometry.meshlets.data(), drawItemRequest.pMeshletBufferHost, drawItemRequest.meshletBufferSize);
+
+                    geometry.lods.resize(drawItemRequest.lodBufferSize / sizeof(MeshLOD));
+                    memcpy(geometry.lods.data(), drawItemRequest.pLODBufferHost, drawItemRequest.lodBufferSize);
+
+                    // Compute index count (of the source level of detail, empty meshes have no levels).
+                    geometry.indexCount = geometry.lods.empty() ? 0U : 3U * geometry.lods.front().triangleCount;
+
+                    // Suballocate the streams from the geometry heap and copy them in place.
+                    auto UploadGeometryStream = [&](GeometryStream stream, const void* pData, VkDeviceSize size)
+                    {
+                        auto range = m_GeometryHeap.Allocate(stream, size);
+
+                        if (size > 0U)
+                            m_RenderContext->UploadBufferData(&m_StagingRing, pData, size, m_GeometryHeap.GetBuffer(stream).buffer, range.offset);
+
+                        return range;
+                    };
+
+                    geometry.indices   = UploadGeometryStream(GeometryStream::Index, drawItemRequest.pIndexBufferHost, drawItemRequest.indexBufferSize);
+                    geometry.positions = UploadGeometryStream(GeometryStream::Position, drawItemRequest.pVertexBufferHost, drawItemRequest.vertexBufferSize);
+                    geometry.texCoords = UploadGeometryStream(GeometryStream::TexCoord, drawItemRequest.pTexcoordBufferHost, drawItemRequest.texcoordBufferSize);
+
+                    // Owners only claim unreferenced hashes, so nothing should be left behind for this one.
+                    if (auto previous = m_Geometry.find(drawItemRequest.contentHash); previous != m_Geometry.end())
+                    {
+                        m_GeometryHeap.Free(GeometryStream::Index, &previous->second.indices);
+                        m_GeometryHeap.Free(GeometryStream::Position, &previous->second.positions);
+                        m_GeometryHeap.Free(GeometryStream::TexCoord, &previous->second.texCoords);
+                    }
+
+                    m_Geometry[drawItemRequest.contentHash] = std::move(geometry);
+
+                    // The staging copy has been consumed.
+                    m_HostBufferArena.Release(drawItemRequest.pIndexBufferHost, GetHostAllocationSize(drawItemRequest));
+
+                    std::lock_guard<std::mutex> claimLock(m_GeometryClaimMutex);
+
+                    if (--m_PendingGeometryOwners[drawItemRequest.contentHash] == 0U)
+                        m_PendingGeometryOwners.erase(drawItemRequest.contentHash);
+                }
+
+                auto drawItemIndex = drawItemRequest.handle.index;
+
+                // Stale request of a slot freed in the meantime.
+                if (m_DrawItemGenerations[drawItemIndex].load() != drawItemRequest.handle.generation)
+                {
+                    ReleaseGeometry(drawItemRequest.contentHash);
+                    continue;
+                }
+
+                auto geometry = m_Geometry.find(drawItemRequest.contentHash);
+
+                // The owning request is still being synced, retry with the next commit. Without any owner left to upload the
+                // geometry the request would be retried forever, drop it (the prim is re-synced with its next change).
+                if (geometry == m_Geometry.end() && !releasedMeshSet.contains(drawItemRequest.pMesh))
+                {
+                    auto isOwnerPending = false;
+                    {
+                        std::lock_guard<std::mutex> claimLock(m_GeometryClaimMutex);
+                        isOwnerPending = m_PendingGeometryOwners.contains(drawItemRequest.contentHash);
+                    }
+
+                    if (isOwnerPending)
+                        m_DrawItemRequests.push(drawItemRequest);
+                    else
+                    {
+                        spdlog::warn("Dropped draw item request of {}, its geometry was never uploaded.", drawItemRequest.pMesh->GetId().GetText());
+                        ReleaseGeometry(drawItemRequest.contentHash);
+                    }
+
+                    continue;
+                }
+
+                if (drawItemIndex >= m_DrawItems.size())
+                    m_DrawItems.resize(drawItemIndex + 1U);
+
+                // Replace the previous contents of the slot in place.
+                if (m_DrawItems[drawItemIndex].pGeometry != nullptr)
+                    ReleaseDrawItem(&m_DrawItems[drawItemIndex]);
+
+                // The prim was destroyed since, its slot is freed below.
+                if (releasedMeshSet.contains(drawItemRequest.pMesh))
+                {
+                    ReleaseGeometry(drawItemRequest.contentHash);
+                    continue;
+                }
+
+                BuildDrawItem(drawItemIndex, drawItemRequest.pMesh, drawItemRequest.contentHash, &geometry->second);
+
+                dirtyDrawItems.push_back(drawItemIndex);
+
+                builtDrawItemCount++;
+            }
+
+            // Free the slots of the destroyed prims.
+            for (auto* pMesh : releasedMeshes)
+            {
+                auto handle = pMesh->GetDrawItemHandle();
+
+                if (handle.IsValid() && m_DrawItemGenerations[handle.index].load() == handle.generation)
+                {
+                    if (handle.index < m_DrawItems.size())
+                        ReleaseDrawItem(&m_DrawItems[handle.index]);
+
+                    std::lock_guard<std::mutex> slotLock(m_DrawItemSlotMutex);
+
+                    m_DrawItemGenerations[handle.index].fetch_add(1U);
+                    m_FreeDrawItemSlots.push_back(handle.index);
+
+                    releasedDrawItemCount++;
+                }
+
+                delete pMesh;
+            }
+
+            // Draw items bound to a material uploaded for the first time, or released.
+            if (!changedMaterialHashes.empty())
+            {
+                for (uint32_t drawItemIndex = 0U; drawItemIndex < m_DrawItems.size(); drawItemIndex++)
+                {
+                    const auto& drawItem = m_DrawItems[drawItemIndex];
+
+                    if (drawItem.pGeometry != nullptr && changedMaterialHashes.contains(drawItem.pMesh->GetMaterialHash()))
+                        dirtyDrawItems.push_back(drawItemIndex);
+                }
+            }
+
+            // Upload the meta-data of the changed slots, coalescing adjacent slots into a single copy.
+            {
+                std::ranges::sort(dirtyDrawItems);
+                dirtyDrawItems.erase(std::ranges::unique(dirtyDrawItems).begin(), dirtyDrawItems.end());
+
+                std::erase_if(dirtyDrawItems, [&](uint32_t drawItemIndex) { return m_DrawItems[drawItemIndex].pGeometry == nullptr; });
+
+                std::vector<DrawItemMetaData> drawItemMetaData;
+
+                for (size_t runBegin = 0U, runEnd = 0U; runBegin < dirtyDrawItems.size(); runBegin = runEnd)
+                {
+                    drawItemMetaData.clear();
+
+                    for (runEnd = runBegin; runEnd < dirtyDrawItems.size() && dirtyDrawItems[runEnd] == dirtyDrawItems[runBegin] + (runEnd - runBegin); runEnd++)
+                        drawItemMetaData.push_back(BuildDrawItemMetaData(m_DrawItems[dirtyDrawItems[runEnd]]));
+
+                    m_RenderContext->UploadBufferData(&m_StagingRing,
+                                                      drawItemMetaData.data(),
+                                                      sizeof(DrawItemMetaData) * drawItemMetaData.size(),
+                                                      m_DrawItemMetaDataBuffer.buffer,
+                                                      sizeof(DrawItemMetaData) * dirtyDrawItems[runBegin]);
+                }
+            }
+
+            // Trim the draw item list and the culled meshlet range to the highest slot / range in use.
+            {
+                while (!m_DrawItems.empty() && m_DrawItems.back().pGeometry == nullptr)
+                    m_DrawItems.pop_back();
+
+                m_MeshletCount = 0U;
+
+                for (const auto& drawItem : m_DrawItems)
+                {
+                    if (drawItem.pGeometry != nullptr)
+                        m_MeshletCount = std::max(m_MeshletCount, drawItem.meshletOffset + drawItem.meshletCount);
+                }
+            }
+
+            spdlog::info("Draw Items: {} (+{} / -{}) | Unique Geometry: {}", m_DrawItems.size(), builtDrawItemCount, releasedDrawItemCount, m_Geometry.size());
+
+            m_MeshCache.ReportStatistics();
+            m_TextureCache.ReportStatistics();
+            m_GeometryHeap.ReportStatistics();
+
+            // Submit the remaining uploads, the first frame using them waits for the transfer queue on the device.
+            m_StagingRing.Flush();
+
+            // Update the descriptors of the changed materials.
+            BuildDescriptors();
+
+            spdlog::info("Host Staging | Peak Committed: {} MB (Buffers) / {} MB (Images)",
+                         m_HostBufferArena.GetPeakCommittedBytes() >> 20U,
+                         m_HostImageArena.GetPeakCommittedBytes() >> 20U);
+
+            spdlog::info("Graphics resource upload complete.");
+
+            // Idle.
+            m_CommitTaskBusy.store(false);
+        });
+}
+
+void ResourceRegistry::_GarbageCollect()
+{
+    // Decodes still running write into the staging arena.
+    m_TextureDecodeTasks.wait();
+
+    vkDeviceWaitIdle(m_RenderContext->GetDevice());
+
+    vkDestroyDescriptorSetLayout(m_RenderContext->GetDevice(), m_DrawItemDataDescriptorLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_RenderContext->GetDevice(), m_MaterialDataDescriptorLayout, nullptr);
+    vkDestroyDescriptorPool(m_RenderContext->GetDevice(), m_DescriptorPool, nullptr);
+
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawItemMetaDataBuffer.buffer, m_DrawItemMetaDataBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawItemUpdateBuffer.buffer, m_DrawItemUpdateBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawCommandBuffer.buffer, m_DrawCommandBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawCountBuffer.buffer, m_DrawCountBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_DrawItemFeedbackBuffer.buffer, m_DrawItemFeedbackBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_MaterialFeedbackBuffer.buffer, m_MaterialFeedbackBuffer.bufferAllocation);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_MaterialParameterBuffer.buffer, m_MaterialParameterBuffer.bufferAllocation);
+
+    vkDestroyCommandPool(m_RenderContext->GetDevice(), m_ResidencyCommandPool, nullptr);
+
+    {
+        // Default image.
+        vkDestroyImageView(m_RenderContext->GetDevice(), m_DefaultImage.imageView, nullptr);
+        vmaDestroyImage(m_RenderContext->GetAllocator(), m_DefaultImage.image, m_DefaultImage.imageAllocation);
+    }
+
+    vkDestroySampler(m_RenderContext->GetDevice(), m_DeviceMaterialImageSampler, nullptr);
+
+    m_StagingRing.Destroy();
+    m_GeometryHeap.Destroy();
+
+    for (auto& texture : m_Textures | std::views::values)
+    {
+        if (texture.image.imageView != VK_NULL_HANDLE)
+            vkDestroyImageView(m_RenderContext->GetDevice(), texture.image.imageView, nullptr);
+
+        vmaDestroyImage(m_RenderContext->GetAllocator(), texture.image.image, texture.image.imageAllocation);
+    }
+
+    // Meshes destroyed after the last commit.
+    Mesh* pMesh = nullptr;
+    while (m_DrawItemReleases.try_pop(pMesh))
+        delete pMesh;
+}
+
+// ------------------------------------------------
+
+void ResourceRegistry::PushDrawItemRequest(DrawItemRequest& request)
+{
+    // Reserve the whole range for this request in one go.
+    auto* pHostBuffer = static_cast<std::byte*>(m_HostBufferArena.Allocate(GetHostAllocationSize(request)));
+
+    // Map a pointer back in the arena that the client can fill with data.
+    request.pIndexBufferHost    = pHostBuffer;
+    request.pVertexBufferHost   = static_cast<std::byte*>(request.pIndexBufferHost) + request.indexBufferSize;
+    request.pTexcoordBufferHost = static_cast<std::byte*>(request.pVertexBufferHost) + request.vertexBufferSize;
+    request.pMeshletBufferHost  = static_cast<std::byte*>(request.pTexcoordBufferHost) + request.texcoordBufferSize;
+    request.pLODBufferHost      = static_cast<std::byte*>(request.pMeshletBufferHost) + request.meshletBufferSize;
+
+    // Push the request.
+    m_DrawItemRequests.push(request);
+}
+
+void ResourceRegistry::PushMaterialRequest(MaterialRequest& request)
+{
+    m_MaterialRequests.push(request);
+}
+
+void ResourceRegistry::PushTextureDecode(uint64_t textureKey, const std::string& resolvedPath, TextureRole role)
+{
+    m_PendingTextureDecodes.fetch_add(1U);
+
+    m_TextureDecodeTasks.run(
+        [this, textureKey, resolvedPath, role]
+        {
+            TextureRequest request { textureKey };
+
+            CompressedTexture compressedTexture;
+
+            // Compressed blocks are uploaded as-is with their full mip chain (DDS / KTX2 files keep their own format).
+            auto extension = std::filesystem::path(resolvedPath).extension().string();
+
+            if (m_CompressTextures && extension != ".dds" && extension != ".ktx2" && LoadCompressedTexture(resolvedPath, role, &compressedTexture))
+            {
+                auto dim = GfVec2i(static_cast<int>(compressedTexture.extent.width), static_cast<int>(compressedTexture.extent.height));
+
+                request.image      = { nullptr, compressedTexture.bytesPerBlock, dim, compressedTexture.format, compressedTexture.mipLevels, {} };
+                request.image.data = m_HostImageArena.Allocate(compressedTexture.blocks.size());
+
+                memcpy(request.image.data, compressedTexture.blocks.data(), compressedTexture.blocks.size());
+
+                m_TextureRequests.push(request);
+
+                m_PendingTextureDecodes.fetch_sub(1U);
+                return;
+            }
+
+            // Only color inputs are sampled in sRGB.
+            auto loadOptions    = m_TextureLoadOptions;
+            loadOptions.isColor = role == TextureRole::Albedo;
+
+            ImageLoader image(resolvedPath, loadOptions);
+
+            request.image = { nullptr, image.GetStride(), image.GetDim(), image.GetFormat(), image.GetMipLevels(), image.GetComponents() };
+
+            // Copy into the staging arena, the decoded image is freed with the loader. Materials sample 2D images, only
+            // the first layer / face of array and cube map images is uploaded.
+            if (image.GetFormat() != VK_FORMAT_UNDEFINED && image.GetData() != nullptr)
+            {
+                request.image.data = m_HostImageArena.Allocate(GetHostAllocationSize(request));
+                image.CopyMipLevels(request.image.data);
+            }
+            else
+            {
+                request.image.dim = { 0, 0 };
+            }
+
+            m_TextureRequests.push(request);
+
+            m_PendingTextureDecodes.fetch_sub(1U);
+        });
+}
+
+bool ResourceRegistry::LoadCompressedTexture(const std::string& resolvedPath, TextureRole role, CompressedTexture* pTexture)
+{
+    auto loadStartTime = std::chrono::high_resolution_clock::now();
+
+    std::ifstream file(resolvedPath, std::ios::binary | std::ios::ate);
+
+    if (!file.is_open())
+        return false;
+
+    std::vector<std::byte> fileData(static_cast<size_t>(file.tellg()));
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+    // There is no high dynamic range block format (BC6H) encoder, these stay half floats.
+    if (fileData.empty() || stbi_is_hdr_from_memory(reinterpret_cast<const stbi_uc*>(fileData.data()), static_cast<int>(fileData.size())) != 0)
+        return false;
+
+    auto contentHash = TextureCache::ComputeContentHash(fileData, role);
+
+    bool cacheHit = m_TextureCache.TryLoad(contentHash, pTexture);
+
+    if (!cacheHit)
+    {
+        // Decoded to 8-bit RGBA, the encoders pick the channels of the role.
+        ImageLoadOptions loadOptions {};
+        {
+            loadOptions.isColor          = role == TextureRole::Albedo;
+            loadOptions.preserveChannels = false;
+        }
+
+        ImageLoader image(fileData, loadOptions);
+
+        if (image.GetData() == nullptr || image.GetStride() != 4U)
+            return false;
+
+        VkExtent3D extent = { static_cast<uint32_t>(image.GetDim()[0]), static_cast<uint32_t>(image.GetDim()[1]), 1U };
+
+        CompressTexture(static_cast<const uint8_t*>(image.GetData()), extent, role, pTexture);
+
+        m_TextureCache.Store(contentHash, *pTexture);
+    }
+
+    m_TextureCache.RecordLoadTime(cacheHit, std::chrono::high_resolution_clock::now() - loadStartTime);
+
+    return true;
+}
+
+void ResourceRegistry::PushDrawItemRelease(Mesh* pMesh) { m_DrawItemReleases.push(pMesh); }
+
+void ResourceRegistry::PushMaterialRelease(size_t hash) { m_MaterialReleases.push(hash); }
+
+void ResourceRegistry::PushDrawItemUpdate(DrawItemHandle handle) { m_DrawItemUpdates.push(handle); }
+
+DrawItemHandle ResourceRegistry::AcquireDrawItemHandle()
+{
+    std::lock_guard<std::mutex> slotLock(m_DrawItemSlotMutex);
+
+    DrawItemHandle handle {};
+
+    if (!m_FreeDrawItemSlots.empty())
+    {
+        handle.index = m_FreeDrawItemSlots.back();
+        m_FreeDrawItemSlots.pop_back();
+    }
+    else
+    {
+        Check(m_DrawItemSlotCount < kMaxDrawItems, "Exceeded the maximum number of draw items.");
+        handle.index = m_DrawItemSlotCount++;
+    }
+
+    handle.generation = m_DrawItemGenerations[handle.index].load();
+
+    return handle;
+}
+
+bool ResourceRegistry::ClaimGeometry(uint64_t contentHash)
+{
+    std::lock_guard<std::mutex> claimLock(m_GeometryClaimMutex);
+
+    if (m_GeometryClaims[contentHash]++ != 0U)
+        return false;
+
+    // The other claims resolve the geometry once the commit has uploaded the owner's request.
+    m_PendingGeometryOwners[contentHash]++;
+
+    return true;
+}
+
+bool ResourceRegistry::ClaimTexture(uint64_t textureKey)
+{
+    std::lock_guard<std::mutex> claimLock(m_TextureClaimMutex);
+
+    return m_TextureClaims[textureKey]++ == 0U;
+}
+
+uint64_t ResourceRegistry::ComputeTextureKey(const std::string& resolvedPath, TextureRole role)
+{
+    if (resolvedPath.empty())
+        return 0U;
+
+    // Re-written files get a new key (and are re-decoded), the stale image is dropped with its last material.
+    std::error_code sizeError;
+    std::error_code timeError;
+
+    auto fileSize  = std::filesystem::file_size(resolvedPath, sizeError);
+    auto writeTime = std::filesystem::last_write_time(resolvedPath, timeError).time_since_epoch().count();
+
+    if (sizeError || timeError)
+        return 0U;
+
+    auto key = ArchHash64(resolvedPath.data(), resolvedPath.size());
+
+    key = TfHash::Combine(key, fileSize);
+    key = TfHash::Combine(key, writeTime);
+
+    // The same image used as color and as data is decoded (and compressed) differently.
+    key = TfHash::Combine(key, static_cast<uint32_t>(role));
+
+    return key;
+}
+
+std::vector<FfxBrixelizerInstanceID> ResourceRegistry::TakeRetiredBrixelizerInstances() { return std::exchange(m_RetiredBrixelizerInstances, {}); }
+
+std::vector<uint32_t> ResourceRegistry::TakeRetransformedBrixelizerDrawItems()
+{
+    std::vector<uint32_t> drawItemIndices;
+
+    // Skip the draw items freed (or replaced) by a commit since the update.
+    for (const auto& handle : std::exchange(m_RetransformedBrixelizerDrawItems, {}))
+    {
+        if (handle.index < m_DrawItems.size() && m_DrawItemGenerations[handle.index].load() == handle.generation &&
+            m_DrawItems[handle.index].pGeometry != nullptr)
+            drawItemIndices.push_back(handle.index);
+    }
+
+    return drawItemIndices;
 }
@@ -0,0 +1,351 @@
+#include <Common.h>
+#include <RenderContext.h>
+#include <StagingRing.h>
+
+StagingRing::StagingRing(RenderContext* pRenderContext) : m_RenderContext(pRenderContext)
+{
+    // Persistently mapped staging memory.
+    // ------------------------------------------------
+
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    {
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.size  = kStagingRingBytes;
+    }
+
+    VmaAllocationCreateInfo allocInfo = {};
+    {
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    }
+
+    VmaAllocationInfo allocationInfo = {};
+    Check(vmaCreateBuffer(m_RenderContext->GetAllocator(), &bufferInfo, &allocInfo, &m_Buffer.buffer, &m_Buffer.bufferAllocation, &allocationInfo),
+          "Failed to create staging ring memory.");
+
+    m_Buffer.bufferInfo = bufferInfo;
+    m_pMappedData       = static_cast<std::byte*>(allocationInfo.pMappedData);
+
+    DebugLabelBufferResource(m_RenderContext, m_Buffer, "StagingRing");
+
+    // Batch command buffers.
+    // ------------------------------------------------
+
+    m_RenderContext->CreateCommandPool(&m_CommandPool, m_RenderContext->GetTransferQueueIndex());
+
+    for (auto& batch : m_Batches)
+    {
+        VkCommandBufferAllocateInfo commandBufferInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        {
+            commandBufferInfo.commandPool        = m_CommandPool;
+            commandBufferInfo.commandBufferCount = 1U;
+            commandBufferInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        }
+        Check(vkAllocateCommandBuffers(m_RenderContext->GetDevice(), &commandBufferInfo, &batch.commandBuffer),
+              "Failed to allocate staging ring command buffers.");
+    }
+
+    // Timeline semaphore tracking the batch submissions.
+    // ------------------------------------------------
+
+    VkSemaphoreTypeCreateInfo semaphoreTypeInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    {
+        semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreTypeInfo.initialValue  = 0U;
+    }
+
+    VkSemaphoreCreateInfo semaphoreInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    {
+        semaphoreInfo.pNext = &semaphoreTypeInfo;
+    }
+    Check(vkCreateSemaphore(m_RenderContext->GetDevice(), &semaphoreInfo, nullptr, &m_TimelineSemaphore),
+          "Failed to create the staging ring timeline semaphore.");
+}
+
+StagingAllocation StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    Check(size <= GetMaxAllocationSize(), "Staging ring allocation exceeds the maximum allocation size.");
+
+    auto ringSize = m_Buffer.bufferInfo.size;
+
+    // Keep batches small enough for the copies to overlap with the recording of the next one.
+    if (m_Batches[m_BatchIndex].recording && m_Head - m_BatchBegin >= kStagingBatchBytes)
+        Flush();
+
+    // Cheaply reclaim whatever the device has already consumed.
+    Retire(false);
+
+    // Align the physical offset, skipping the end of the ring if the allocation does not fit in it.
+    auto offset        = m_Head % ringSize;
+    auto offsetAligned = (offset + alignment - 1U) / alignment * alignment;
+
+    if (offsetAligned + size > ringSize)
+        offsetAligned = ringSize;
+
+    auto begin = m_Head + (offsetAligned - offset);
+    auto end   = begin + size;
+
+    // Backpressure: wait for the oldest batches until the allocation no longer overlaps memory in flight.
+    while (end - m_Tail > ringSize)
+    {
+        if (m_InFlightBatches.empty())
+        {
+            // Only the recording batch holds on to the ring, submit it so that it can be waited on.
+            Check(m_Batches[m_BatchIndex].recording, "Staging ring exhausted with nothing in flight.");
+            Flush();
+        }
+
+        Retire(true);
+    }
+
+    if (!m_Batches[m_BatchIndex].recording)
+        BeginBatch();
+
+    m_Head = end;
+
+    return { m_Buffer.buffer, begin % ringSize, m_pMappedData + (begin % ringSize) };
+}
+
+VkCommandBuffer StagingRing::GetCommandBuffer()
+{
+    if (!m_Batches[m_BatchIndex].recording)
+        BeginBatch();
+
+    return m_Batches[m_BatchIndex].commandBuffer;
+}
+
+void StagingRing::BeginBatch()
+{
+    auto& batch = m_Batches[m_BatchIndex];
+
+    // The command buffer may still be executing its previous submission.
+    if (batch.signalValue != 0U)
+    {
+        VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+        {
+            waitInfo.semaphoreCount = 1U;
+            waitInfo.pSemaphores    = &m_TimelineSemaphore;
+            waitInfo.pValues        = &batch.signalValue;
+        }
+        Check(vkWaitSemaphores(m_RenderContext->GetDevice(), &waitInfo, UINT64_MAX), "Failed to wait for a staging ring batch.");
+    }
+
+    Check(vkResetCommandBuffer(batch.commandBuffer, 0x0), "Failed to reset a staging ring command buffer.");
+
+    VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    {
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    }
+    Check(vkBeginCommandBuffer(batch.commandBuffer, &beginInfo), "Failed to begin a staging ring command buffer.");
+
+    batch.recording = true;
+
+    m_BatchBegin = m_Head;
+}
+
+void StagingRing::Release(VkBuffer buffer)
+{
+    // Same queue: the batch ends in a global memory barrier instead.
+    if (!m_RenderContext->HasDedicatedTransferQueue())
+        return;
+
+    VkBufferMemoryBarrier2 bufferBarrier = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+    {
+        bufferBarrier.srcStageMask        = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        bufferBarrier.srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        bufferBarrier.srcQueueFamilyIndex = m_RenderContext->GetTransferQueueIndex();
+        bufferBarrier.dstQueueFamilyIndex = m_RenderContext->GetCommandQueueIndex();
+        bufferBarrier.buffer              = buffer;
+        bufferBarrier.offset              = 0U;
+        bufferBarrier.size                = VK_WHOLE_SIZE;
+    }
+
+    VkDependencyInfo dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    {
+        dependencyInfo.bufferMemoryBarrierCount = 1U;
+        dependencyInfo.pBufferMemoryBarriers    = &bufferBarrier;
+    }
+    vkCmdPipelineBarrier2(GetCommandBuffer(), &dependencyInfo);
+
+    // The acquire half mirrors the release with the destination scopes filled in.
+    bufferBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+    bufferBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+    bufferBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    bufferBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+
+    m_Batches[m_BatchIndex].acquireBufferBarriers.push_back(bufferBarrier);
+}
+
+void StagingRing::Release(VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
+{
+    // Images released as a transfer source are read by the mip generation blits.
+    auto isTransferSource = newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    if (!m_RenderContext->HasDedicatedTransferQueue())
+    {
+        VulkanColorImageBarrier(GetCommandBuffer(),
+                                image,
+                                oldLayout,
+                                newLayout,
+                                VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                isTransferSource ? VK_ACCESS_2_TRANSFER_READ_BIT : VK_ACCESS_2_SHADER_READ_BIT,
+                                VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                                isTransferSource ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                                0U,
+                                mipLevels);
+        return;
+    }
+
+    VkImageMemoryBarrier2 imageBarrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    {
+        imageBarrier.srcStageMask        = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        imageBarrier.srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        imageBarrier.oldLayout           = oldLayout;
+        imageBarrier.newLayout           = newLayout;
+        imageBarrier.srcQueueFamilyIndex = m_RenderContext->GetTransferQueueIndex();
+        imageBarrier.dstQueueFamilyIndex = m_RenderContext->GetCommandQueueIndex();
+        imageBarrier.image               = image;
+        imageBarrier.subresourceRange    = { VK_IMAGE_ASPECT_COLOR_BIT, 0U, mipLevels, 0U, VK_REMAINING_ARRAY_LAYERS };
+    }
+
+    VkDependencyInfo dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    {
+        dependencyInfo.imageMemoryBarrierCount = 1U;
+        dependencyInfo.pImageMemoryBarriers    = &imageBarrier;
+    }
+    vkCmdPipelineBarrier2(GetCommandBuffer(), &dependencyInfo);
+
+    imageBarrier.srcStageMask  = VK_PIPELINE_STAGE_2_NONE;
+    imageBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+    imageBarrier.dstStageMask  = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    imageBarrier.dstAccessMask = isTransferSource ? VK_ACCESS_2_TRANSFER_READ_BIT : VK_ACCESS_2_SHADER_READ_BIT;
+
+    m_Batches[m_BatchIndex].acquireImageBarriers.push_back(imageBarrier);
+}
+
+void StagingRing::GenerateMips(const MipGeneration& mipGeneration) { m_Batches[m_BatchIndex].mipGenerations.push_back(mipGeneration); }
+
+void StagingRing::Flush()
+{
+    auto& batch = m_Batches[m_BatchIndex];
+
+    if (!batch.recording)
+        return;
+
+    // Same queue: make the copies visible to the frames that follow in submission order.
+    if (!m_RenderContext->HasDedicatedTransferQueue())
+    {
+        VulkanMemoryBarrier(batch.commandBuffer,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_ACCESS_2_MEMORY_READ_BIT,
+                            VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    }
+
+    // Make the host writes of the batch available (no-op for coherent memory).
+    if (m_Head != m_BatchBegin)
+    {
+        auto ringSize = m_Buffer.bufferInfo.size;
+        auto begin    = m_BatchBegin % ringSize;
+        auto size     = m_Head - m_BatchBegin;
+
+        if (begin + size <= ringSize)
+            Check(vmaFlushAllocation(m_RenderContext->GetAllocator(), m_Buffer.bufferAllocation, begin, size), "Failed to flush staging ring memory.");
+        else
+        {
+            Check(vmaFlushAllocation(m_RenderContext->GetAllocator(), m_Buffer.bufferAllocation, begin, ringSize - begin),
+                  "Failed to flush staging ring memory.");
+            Check(vmaFlushAllocation(m_RenderContext->GetAllocator(), m_Buffer.bufferAllocation, 0U, size - (ringSize - begin)),
+                  "Failed to flush staging ring memory.");
+        }
+    }
+
+    Check(vkEndCommandBuffer(batch.commandBuffer), "Failed to end a staging ring command buffer.");
+
+    batch.signalValue = ++m_SubmitValue;
+    batch.recording   = false;
+
+    VkCommandBufferSubmitInfo commandBufferInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
+    {
+        commandBufferInfo.commandBuffer = batch.commandBuffer;
+    }
+
+    VkSemaphoreSubmitInfo signalInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+    {
+        signalInfo.semaphore = m_TimelineSemaphore;
+        signalInfo.value     = batch.signalValue;
+        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
+    VkSubmitInfo2 submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+    {
+        submitInfo.commandBufferInfoCount   = 1U;
+        submitInfo.pCommandBufferInfos      = &commandBufferInfo;
+        submitInfo.signalSemaphoreInfoCount = 1U;
+        submitInfo.pSignalSemaphoreInfos    = &signalInfo;
+    }
+
+    {
+        std::lock_guard<std::mutex> transferQueueLock(m_RenderContext->GetTransferQueueMutex());
+
+        Check(vkQueueSubmit2(m_RenderContext->GetTransferQueue(), 1U, &submitInfo, VK_NULL_HANDLE),
+              "Failed to submit a staging ring batch to the transfer queue.");
+    }
+
+    // The next frame waits for the batch on the device (and takes ownership of its resources).
+    m_RenderContext->PushFrameAcquire(m_TimelineSemaphore, batch.signalValue, batch.acquireBufferBarriers, batch.acquireImageBarriers, batch.mipGenerations);
+
+    batch.acquireBufferBarriers.clear();
+    batch.acquireImageBarriers.clear();
+    batch.mipGenerations.clear();
+
+    m_InFlightBatches.push_back({ batch.signalValue, m_Head });
+
+    m_BatchIndex = (m_BatchIndex + 1U) % kStagingBatchCount;
+}
+
+void StagingRing::Retire(bool wait)
+{
+    if (m_InFlightBatches.empty())
+        return;
+
+    uint64_t completedValue = 0U;
+
+    if (wait)
+    {
+        completedValue = m_InFlightBatches.front().signalValue;
+
+        VkSemaphoreWaitInfo waitInfo = { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+        {
+            waitInfo.semaphoreCount = 1U;
+            waitInfo.pSemaphores    = &m_TimelineSemaphore;
+            waitInfo.pValues        = &completedValue;
+        }
+        Check(vkWaitSemaphores(m_RenderContext->GetDevice(), &waitInfo, UINT64_MAX), "Failed to wait for a staging ring batch.");
+    }
+
+    Check(vkGetSemaphoreCounterValue(m_RenderContext->GetDevice(), m_TimelineSemaphore, &completedValue), "Failed to query the staging ring timeline.");
+
+    while (!m_InFlightBatches.empty() && m_InFlightBatches.front().signalValue <= completedValue)
+    {
+        m_Tail = m_InFlightBatches.front().ringEnd;
+        m_InFlightBatches.pop_front();
+    }
+}
+
+void StagingRing::WaitIdle()
+{
+    Flush();
+
+    while (!m_InFlightBatches.empty())
+        Retire(true);
+}
+
+void StagingRing::Destroy()
+{
+    WaitIdle();
+
+    vkDestroySemaphore(m_RenderContext->GetDevice(), m_TimelineSemaphore, nullptr);
+    vkDestroyCommandPool(m_RenderContext->GetDevice(), m_CommandPool, nullptr);
+    vmaDestroyBuffer(m_RenderContext->GetAllocator(), m_Buffer.buffer, m_Buffer.bufferAllocation);
+}
@@ -0,0 +1,230 @@
+#include <Common.h>
+#include <TextureCache.h>
+
+// File Layout (DDS with the DX10 extension header, the cache header lives in the reserved words)
+// ------------------------------------------------------------
+
+constexpr uint32_t kDDSMagic          = 0x20534444U; // 'DDS '
+constexpr uint32_t kDDSFourCCDX10     = 0x30315844U; // 'DX10'
+constexpr uint32_t kTextureCacheMagic = 0x48435854U; // 'TXCH'
+
+constexpr uint32_t kDDSFlagsTexture = 0x1U | 0x2U | 0x4U | 0x1000U | 0x20000U | 0x80000U; // Caps, size, pixel format, mip count, linear size.
+constexpr uint32_t kDDSCapsTexture  = 0x8U | 0x1000U | 0x400000U;                          // Complex, texture, mip map.
+constexpr uint32_t kDDSPixelFourCC  = 0x4U;
+constexpr uint32_t kDDSDimension2D  = 3U;
+
+struct DDSPixelFormat
+{
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t bitCount;
+    uint32_t maskR;
+    uint32_t maskG;
+    uint32_t maskB;
+    uint32_t maskA;
+};
+
+struct TextureCacheHeader
+{
+    uint32_t ddsMagic;
+
+    // DDS_HEADER
+    uint32_t       size;
+    uint32_t       flags;
+    uint32_t       height;
+    uint32_t       width;
+    uint32_t       linearSize;
+    uint32_t       depth;
+    uint32_t       mipLevels;
+    uint32_t       magic;
+    uint32_t       version;
+    uint32_t       contentHashLow;
+    uint32_t       contentHashHigh;
+    uint32_t       reserved[7];
+    DDSPixelFormat pixelFormat;
+    uint32_t       caps[4];
+    uint32_t       reserved2;
+
+    // DDS_HEADER_DXT10
+    uint32_t dxgiFormat;
+    uint32_t dimension;
+    uint32_t miscFlags;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+static_assert(sizeof(TextureCacheHeader) == 4U + 124U + 20U, "Texture cache header must match the DDS layout.");
+
+// DXGI format of each compressed texture format.
+constexpr std::array<std::pair<VkFormat, uint32_t>, 4> kDXGIFormats = {
+    { { VK_FORMAT_BC1_RGB_SRGB_BLOCK, 72U }, { VK_FORMAT_BC4_UNORM_BLOCK, 80U }, { VK_FORMAT_BC5_UNORM_BLOCK, 83U }, { VK_FORMAT_BC7_SRGB_BLOCK, 99U } }
+};
+
+// Texture Cache Implementation
+// ------------------------------------------------------------
+
+TextureCache::TextureCache(std::filesystem::path directory) : m_Directory(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_Directory, error);
+
+    if (error)
+        spdlog::warn("Failed to create texture cache directory: {}", m_Directory.string());
+}
+
+uint64_t TextureCache::ComputeContentHash(std::span<const std::byte> fileData, TextureRole role)
+{
+    uint64_t hash = ArchHash64(reinterpret_cast<const char*>(fileData.data()), fileData.size());
+
+    hash = TfHash::Combine(hash, static_cast<uint32_t>(role));
+
+    // Invalidate the cache when the encoded blocks change.
+    return TfHash::Combine(hash, kVersion);
+}
+
+std::filesystem::path TextureCache::GetFilePath(uint64_t contentHash) const { return m_Directory / std::format("{:016x}.dds", contentHash); }
+
+bool TextureCache::TryLoad(uint64_t contentHash, CompressedTexture* pTexture)
+{
+    auto Miss = [&]()
+    {
+        m_MissCount++;
+        return false;
+    };
+
+    std::ifstream file(GetFilePath(contentHash), std::ios::binary | std::ios::ate);
+
+    if (!file.is_open())
+        return Miss();
+
+    auto fileSize = static_cast<uint64_t>(file.tellg());
+
+    if (fileSize < sizeof(TextureCacheHeader))
+        return Miss();
+
+    TextureCacheHeader header {};
+
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(TextureCacheHeader));
+
+    // Validate the header.
+    if (header.ddsMagic != kDDSMagic || header.magic != kTextureCacheMagic || header.version != kVersion ||
+        (static_cast<uint64_t>(header.contentHashHigh) << 32U | header.contentHashLow) != contentHash)
+        return Miss();
+
+    auto formatIterator = std::ranges::find(kDXGIFormats, header.dxgiFormat, &std::pair<VkFormat, uint32_t>::second);
+
+    if (formatIterator == kDXGIFormats.end() || header.mipLevels == 0U)
+        return Miss();
+
+    pTexture->format        = formatIterator->first;
+    pTexture->extent        = { header.width, header.height, 1U };
+    pTexture->mipLevels     = header.mipLevels;
+    pTexture->bytesPerBlock = pTexture->format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || pTexture->format == VK_FORMAT_BC4_UNORM_BLOCK ? 8U : 16U;
+
+    auto blockBytes = GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerBlock, pTexture->mipLevels);
+
+    if (sizeof(TextureCacheHeader) + blockBytes > fileSize)
+        return Miss();
+
+    pTexture->blocks.resize(blockBytes);
+    file.read(reinterpret_cast<char*>(pTexture->blocks.data()), static_cast<std::streamsize>(blockBytes));
+
+    if (!file.good())
+        return Miss();
+
+    m_HitCount++;
+
+    return true;
+}
+
+void TextureCache::Store(uint64_t contentHash, const CompressedTexture& texture)
+{
+    auto formatIterator = std::ranges::find(kDXGIFormats, texture.format, &std::pair<VkFormat, uint32_t>::first);
+
+    if (formatIterator == kDXGIFormats.end())
+        return;
+
+    TextureCacheHeader header {};
+    {
+        header.ddsMagic        = kDDSMagic;
+        header.size            = 124U;
+        header.flags           = kDDSFlagsTexture;
+        header.height          = texture.extent.height;
+        header.width           = texture.extent.width;
+        header.linearSize      = static_cast<uint32_t>(GetMipChainSize(texture.extent, texture.format, texture.bytesPerBlock, 1U));
+        header.depth           = 1U;
+        header.mipLevels       = texture.mipLevels;
+        header.magic           = kTextureCacheMagic;
+        header.version         = kVersion;
+        header.contentHashLow  = static_cast<uint32_t>(contentHash);
+        header.contentHashHigh = static_cast<uint32_t>(contentHash >> 32U);
+        header.caps[0]         = kDDSCapsTexture;
+        header.dxgiFormat      = formatIterator->second;
+        header.dimension       = kDDSDimension2D;
+        header.arraySize       = 1U;
+
+        header.pixelFormat.size   = sizeof(DDSPixelFormat);
+        header.pixelFormat.flags  = kDDSPixelFourCC;
+        header.pixelFormat.fourCC = kDDSFourCCDX10;
+    }
+
+    auto filePath     = GetFilePath(contentHash);
+    auto filePathTemp = filePath;
+    filePathTemp += std::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream file(filePathTemp, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open())
+        {
+            spdlog::warn("Failed to open texture cache file for writing: {}", filePathTemp.string());
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(TextureCacheHeader));
+        file.write(reinterpret_cast<const char*>(texture.blocks.data()), static_cast<std::streamsize>(texture.blocks.size()));
+
+        if (!file.good())
+        {
+            spdlog::warn("Failed to write texture cache file: {}", filePathTemp.string());
+            return;
+        }
+    }
+
+    // Move the complete file into place so that readers never observe a partially written file.
+    std::error_code error;
+    std::filesystem::rename(filePathTemp, filePath, error);
+
+    if (error)
+    {
+        std::filesystem::remove(filePathTemp, error);
+        spdlog::warn("Failed to commit texture cache file: {}", filePath.string());
+    }
+}
+
+void TextureCache::RecordLoadTime(bool cacheHit, std::chrono::nanoseconds duration)
+{
+    (cacheHit ? m_HitTimeNs : m_MissTimeNs) += static_cast<uint64_t>(duration.count());
+}
+
+void TextureCache::ReportStatistics()
+{
+    auto hitCount  = m_HitCount.exchange(0U);
+    auto missCount = m_MissCount.exchange(0U);
+    auto hitTime   = static_cast<double>(m_HitTimeNs.exchange(0U)) * 1e-6;
+    auto missTime  = static_cast<double>(m_MissTimeNs.exchange(0U)) * 1e-6;
+
+    if (hitCount + missCount == 0U)
+        return;
+
+    spdlog::info("Compressed Texture Cache: {} hits / {} misses ({:.1f}% hit rate) | Hit: {:.2f} ms ({:.3f} ms avg) | Miss: {:.2f} ms ({:.3f} ms avg)",
+                 hitCount,
+                 missCount,
+                 100.0 * hitCount / (hitCount + missCount),
+                 hitTime,
+                 hitCount != 0U ? hitTime / hitCount : 0.0,
+                 missTime,
+                 missCount != 0U ? missTime / missCount : 0.0);
+}
@@ -0,0 +1,568 @@
+#include <Common.h>
+#include <TextureCompression.h>
+
+#include <cstddef>
+
+// Texel Block Helpers
+// ------------------------------------------------------------
+
+constexpr uint32_t kBlockDim = 4U;
+
+// RGBA texels of a 4x4 block.
+using TexelBlock = std::array<std::array<uint8_t, 4>, kBlockDim * kBlockDim>;
+
+// Edge texels are replicated into the blocks that overhang levels which are not a multiple of the block size.
+static void FetchBlock(const uint8_t* pTexels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, TexelBlock& block)
+{
+    for (uint32_t y = 0U; y < kBlockDim; y++)
+    {
+        for (uint32_t x = 0U; x < kBlockDim; x++)
+        {
+            auto texelX = std::min(blockX * kBlockDim + x, width - 1U);
+            auto texelY = std::min(blockY * kBlockDim + y, height - 1U);
+
+            memcpy(block.at(y * kBlockDim + x).data(), pTexels + (static_cast<size_t>(texelY) * width + texelX) * 4U, 4U); // NOLINT
+        }
+    }
+}
+
+// Endpoints of the block's extent along the principal axis of its first N channels (power iteration on the covariance).
+template <size_t N>
+static void ComputePrincipalEndpoints(const TexelBlock& block, std::array<float, N>& endpoint0, std::array<float, N>& endpoint1)
+{
+    std::array<float, N> mean {};
+    std::array<float, N> minimum;
+    std::array<float, N> maximum;
+
+    minimum.fill(255.0F);
+    maximum.fill(0.0F);
+
+    for (const auto& texel : block)
+    {
+        for (size_t c = 0U; c < N; c++)
+        {
+            mean[c] += texel[c];
+            minimum[c] = std::min(minimum[c], static_cast<float>(texel[c]));
+            maximum[c] = std::max(maximum[c], static_cast<float>(texel[c]));
+        }
+    }
+
+    for (auto& channel : mean)
+        channel /= static_cast<float>(block.size());
+
+    std::array<float, N * N> covariance {};
+
+    for (const auto& texel : block)
+    {
+        for (size_t row = 0U; row < N; row++)
+        {
+            for (size_t column = 0U; column < N; column++)
+                covariance[row * N + column] += (texel[row] - mean[row]) * (texel[column] - mean[column]);
+        }
+    }
+
+    // Start from the diagonal of the bounding box, which is close to the principal axis for most blocks.
+    std::array<float, N> axis;
+
+    for (size_t c = 0U; c < N; c++)
+        axis[c] = maximum[c] - minimum[c];
+
+    for (uint32_t iteration = 0U; iteration < 8U; iteration++)
+    {
+        std::array<float, N> product {};
+
+        for (size_t row = 0U; row < N; row++)
+        {
+            for (size_t column = 0U; column < N; column++)
+                product[row] += covariance[row * N + column] * axis[column];
+        }
+
+        auto length = 0.0F;
+
+        for (auto channel : product)
+            length = std::max(length, std::abs(channel));
+
+        // Uniform block (or an axis orthogonal to the spread), keep the last estimate.
+        if (length < 1e-6F)
+            break;
+
+        for (size_t c = 0U; c < N; c++)
+            axis[c] = product[c] / length;
+    }
+
+    auto axisLengthSquared = 0.0F;
+
+    for (auto channel : axis)
+        axisLengthSquared += channel * channel;
+
+    if (axisLengthSquared < 1e-6F)
+    {
+        endpoint0 = mean;
+        endpoint1 = mean;
+        return;
+    }
+
+    auto projectionMin = FLT_MAX;
+    auto projectionMax = -FLT_MAX;
+
+    for (const auto& texel : block)
+    {
+        auto projection = 0.0F;
+
+        for (size_t c = 0U; c < N; c++)
+            projection += (texel[c] - mean[c]) * axis[c];
+
+        projectionMin = std::min(projectionMin, projection);
+        projectionMax = std::max(projectionMax, projection);
+    }
+
+    for (size_t c = 0U; c < N; c++)
+    {
+        endpoint0[c] = std::clamp(mean[c] + axis[c] * projectionMin / axisLengthSquared, 0.0F, 255.0F);
+        endpoint1[c] = std::clamp(mean[c] + axis[c] * projectionMax / axisLengthSquared, 0.0F, 255.0F);
+    }
+}
+
+template <size_t N>
+static uint32_t SelectNearestIndex(const uint8_t* pTexel, const std::array<std::array<int32_t, 4>, 16>& palette, uint32_t paletteSize)
+{
+    auto bestIndex = 0U;
+    auto bestError = INT32_MAX;
+
+    for (uint32_t index = 0U; index < paletteSize; index++)
+    {
+        auto error = 0;
+
+        for (size_t c = 0U; c < N; c++)
+        {
+            auto delta = static_cast<int32_t>(pTexel[c]) - palette.at(index)[c]; // NOLINT
+            error += delta * delta;
+        }
+
+        if (error < bestError)
+        {
+            bestIndex = index;
+            bestError = error;
+        }
+    }
+
+    return bestIndex;
+}
+
+// Packs fields into a 128-bit block, least significant bit first.
+class BlockBitWriter
+{
+public:
+
+    void Write(uint64_t value, uint32_t bitCount)
+    {
+        for (uint32_t bit = 0U; bit < bitCount; bit++, m_Offset++)
+            m_Bits.at(m_Offset / 64U) |= ((value >> bit) & 1U) << (m_Offset % 64U);
+    }
+
+    [[nodiscard]] inline const std::array<uint64_t, 2>& GetBits() const { return m_Bits; }
+
+private:
+
+    std::array<uint64_t, 2> m_Bits {};
+    uint32_t                m_Offset {};
+};
+
+// Block Encoders
+// ------------------------------------------------------------
+
+// BC1: two RGB565 endpoints and 2-bit indices (four color mode).
+static void EncodeBC1(const TexelBlock& block, std::byte* pBlock)
+{
+    std::array<float, 3> endpoint0 {};
+    std::array<float, 3> endpoint1 {};
+    ComputePrincipalEndpoints<3>(block, endpoint0, endpoint1);
+
+    auto Quantize = [](const std::array<float, 3>& endpoint)
+    {
+        auto r = static_cast<uint32_t>(std::lround(endpoint[0] * 31.0F / 255.0F));
+        auto g = static_cast<uint32_t>(std::lround(endpoint[1] * 63.0F / 255.0F));
+        auto b = static_cast<uint32_t>(std::lround(endpoint[2] * 31.0F / 255.0F));
+
+        return static_cast<uint16_t>((r << 11U) | (g << 5U) | b);
+    };
+
+    auto Expand = [](uint16_t color) -> std::array<int32_t, 4>
+    {
+        auto r = (color >> 11U) & 0x1FU;
+        auto g = (color >> 5U) & 0x3FU;
+        auto b = color & 0x1FU;
+
+        return { static_cast<int32_t>((r << 3U) | (r >> 2U)), static_cast<int32_t>((g << 2U) | (g >> 4U)), static_cast<int32_t>((b << 3U) | (b >> 2U)), 255 };
+    };
+
+    auto color0 = Quantize(endpoint1);
+    auto color1 = Quantize(endpoint0);
+
+    // The four color mode requires the first endpoint to be the larger one.
+    if (color0 < color1)
+        std::swap(color0, color1);
+
+    uint32_t indices = 0U;
+
+    if (color0 != color1)
+    {
+        std::array<std::array<int32_t, 4>, 16> palette {};
+        {
+            palette[0] = Expand(color0);
+            palette[1] = Expand(color1);
+
+            for (size_t c = 0U; c < 3U; c++)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+        }
+
+        for (uint32_t texelIndex = 0U; texelIndex < block.size(); texelIndex++)
+            indices |= SelectNearestIndex<3>(block.at(texelIndex).data(), palette, 4U) << (texelIndex * 2U);
+    }
+
+    memcpy(pBlock, &color0, sizeof(uint16_t));
+    memcpy(pBlock + 2, &color1, sizeof(uint16_t)); // NOLINT
+    memcpy(pBlock + 4, &indices, sizeof(uint32_t)); // NOLINT
+}
+
+// BC4: two 8-bit endpoints and 3-bit indices (eight value mode) for a single channel.
+static void EncodeBC4(const TexelBlock& block, uint32_t channel, std::byte* pBlock)
+{
+    uint8_t value0 = 0U;
+    uint8_t value1 = 255U;
+
+    for (const auto& texel : block)
+    {
+        value0 = std::max(value0, texel.at(channel));
+        value1 = std::min(value1, texel.at(channel));
+    }
+
+    uint64_t bits = static_cast<uint64_t>(value0) | (static_cast<uint64_t>(value1) << 8U);
+
+    // A uniform block decodes from the first endpoint alone (all indices zero).
+    if (value0 != value1)
+    {
+        std::array<std::array<int32_t, 4>, 16> palette {};
+        {
+            palette[0][0] = value0;
+            palette[1][0] = value1;
+
+            for (int32_t index = 2; index < 8; index++)
+                palette.at(index)[0] = ((8 - index) * value0 + (index - 1) * value1) / 7;
+        }
+
+        for (uint32_t texelIndex = 0U; texelIndex < block.size(); texelIndex++)
+        {
+            auto value = block.at(texelIndex).at(channel);
+
+            bits |= static_cast<uint64_t>(SelectNearestIndex<1>(&value, palette, 8U)) << (16U + texelIndex * 3U);
+        }
+    }
+
+    memcpy(pBlock, &bits, sizeof(uint64_t));
+}
+
+// BC5: two BC4 blocks (red, then green).
+static void EncodeBC5(const TexelBlock& block, std::byte* pBlock)
+{
+    EncodeBC4(block, 0U, pBlock);
+    EncodeBC4(block, 1U, pBlock + 8); // NOLINT
+}
+
+// BC7 (mode 6 only): a single subset with RGBA 7.7.7.7 endpoints + a p-bit each, and 4-bit indices.
+static void EncodeBC7(const TexelBlock& block, std::byte* pBlock)
+{
+    static constexpr std::array<int32_t, 16> kWeights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    std::array<float, 4> endpoint0 {};
+    std::array<float, 4> endpoint1 {};
+    ComputePrincipalEndpoints<4>(block, endpoint0, endpoint1);
+
+    // Quantize to 7 bits with the shared p-bit that minimizes the error of the endpoint.
+    auto Quantize = [](const std::array<float, 4>& endpoint, std::array<uint32_t, 4>& quantized, uint32_t& pBit)
+    {
+        auto bestError = FLT_MAX;
+
+        for (uint32_t candidateBit = 0U; candidateBit < 2U; candidateBit++)
+        {
+            std::array<uint32_t, 4> candidate {};
+
+            auto error = 0.0F;
+
+            for (size_t c = 0U; c < 4U; c++)
+            {
+                candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - static_cast<float>(candidateBit)) * 0.5F), 0L, 127L));
+
+                auto delta = static_cast<float>((candidate[c] << 1U) | candidateBit) - endpoint[c];
+                error += delta * delta;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                quantized = candidate;
+                pBit      = candidateBit;
+            }
+        }
+    };
+
+    std::array<uint32_t, 4> quantized0 {};
+    std::array<uint32_t, 4> quantized1 {};
+    uint32_t                pBit0 = 0U;
+    uint32_t                pBit1 = 0U;
+
+    Quantize(endpoint0, quantized0, pBit0);
+    Quantize(endpoint1, quantized1, pBit1);
+
+    std::array<std::array<int32_t, 4>, 16> palette {};
+
+    for (size_t index = 0U; index < kWeights.size(); index++)
+    {
+        for (size_t c = 0U; c < 4U; c++)
+        {
+            auto value0 = static_cast<int32_t>((quantized0[c] << 1U) | pBit0);
+            auto value1 = static_cast<int32_t>((quantized1[c] << 1U) | pBit1);
+
+            palette.at(index)[c] = ((64 - kWeights.at(index)) * value0 + kWeights.at(index) * value1 + 32) >> 6;
+        }
+    }
+
+    std::array<uint32_t, 16> indices {};
+
+    for (uint32_t texelIndex = 0U; texelIndex < block.size(); texelIndex++)
+        indices.at(texelIndex) = SelectNearestIndex<4>(block.at(texelIndex).data(), palette, 16U);
+
+    // The index of the first texel is stored without its top bit, swap the endpoints if it is set.
+    if (indices[0] >= 8U)
+    {
+        std::swap(quantized0, quantized1);
+        std::swap(pBit0, pBit1);
+
+        for (auto& index : indices)
+            index = 15U - index;
+    }
+
+    BlockBitWriter writer;
+    {
+        writer.Write(1U << 6U, 7U);
+
+        for (size_t c = 0U; c < 4U; c++)
+        {
+            writer.Write(quantized0[c], 7U);
+            writer.Write(quantized1[c], 7U);
+        }
+
+        writer.Write(pBit0, 1U);
+        writer.Write(pBit1, 1U);
+
+        for (uint32_t texelIndex = 0U; texelIndex < block.size(); texelIndex++)
+            writer.Write(indices.at(texelIndex), texelIndex == 0U ? 3U : 4U);
+    }
+
+    memcpy(pBlock, writer.GetBits().data(), 16U);
+}
+
+// Mip Chain
+// ------------------------------------------------------------
+
+static float SRGBToLinear(uint8_t value)
+{
+    static const auto kTable = []
+    {
+        std::array<float, 256> table {};
+
+        for (uint32_t i = 0U; i < 256U; i++)
+        {
+            auto channel = static_cast<float>(i) / 255.0F;
+            table.at(i)  = channel <= 0.04045F ? channel / 12.92F : std::pow((channel + 0.055F) / 1.055F, 2.4F);
+        }
+
+        return table;
+    }();
+
+    return kTable.at(value);
+}
+
+static uint8_t LinearToSRGB(float value)
+{
+    constexpr uint32_t kTableSize = 4096U;
+
+    static const auto kTable = []
+    {
+        std::array<uint8_t, kTableSize> table {};
+
+        for (uint32_t i = 0U; i < kTableSize; i++)
+        {
+            auto channel = static_cast<float>(i) / static_cast<float>(kTableSize - 1U);
+            auto encoded = channel <= 0.0031308F ? channel * 12.92F : 1.055F * std::pow(channel, 1.0F / 2.4F) - 0.055F;
+
+            table.at(i) = static_cast<uint8_t>(std::lround(encoded * 255.0F));
+        }
+
+        return table;
+    }();
+
+    return kTable.at(static_cast<size_t>(std::lround(std::clamp(value, 0.0F, 1.0F) * static_cast<float>(kTableSize - 1U))));
+}
+
+// 2x2 box filter (clamped at the edges of odd sized levels). Albedo color is averaged in linear space, normals are
+// re-normalized.
+static void DownsampleLevel(const uint8_t* pSource, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* pDestination, VkExtent3D extent, TextureRole role)
+{
+    tbb::parallel_for(
+        tbb::blocked_range<uint32_t>(0U, extent.height),
+        [&](const tbb::blocked_range<uint32_t>& rows)
+        {
+            for (auto y = rows.begin(); y != rows.end(); y++)
+            {
+                for (uint32_t x = 0U; x < extent.width; x++)
+                {
+                    std::array<const uint8_t*, 4> pTexels {};
+                    {
+                        auto x0 = std::min(x * 2U, sourceWidth - 1U);
+                        auto x1 = std::min(x * 2U + 1U, sourceWidth - 1U);
+                        auto y0 = std::min(y * 2U, sourceHeight - 1U);
+                        auto y1 = std::min(y * 2U + 1U, sourceHeight - 1U);
+
+                        pTexels[0] = pSource + (static_cast<size_t>(y0) * sourceWidth + x0) * 4U; // NOLINT
+                        pTexels[1] = pSource + (static_cast<size_t>(y0) * sourceWidth + x1) * 4U; // NOLINT
+                        pTexels[2] = pSource + (static_cast<size_t>(y1) * sourceWidth + x0) * 4U; // NOLINT
+                        pTexels[3] = pSource + (static_cast<size_t>(y1) * sourceWidth + x1) * 4U; // NOLINT
+                    }
+
+                    auto* pTexel = pDestination + (static_cast<size_t>(y) * extent.width + x) * 4U; // NOLINT
+
+                    std::array<float, 4> sum {};
+
+                    for (const auto* pSourceTexel : pTexels)
+                    {
+                        for (size_t c = 0U; c < 4U; c++)
+                        {
+                            auto channel = pSourceTexel[c]; // NOLINT
+
+                            if (role == TextureRole::Albedo && c < 3U)
+                                sum[c] += SRGBToLinear(channel);
+                            else if (role == TextureRole::Normal && c < 3U)
+                                sum[c] += static_cast<float>(channel) / 127.5F - 1.0F;
+                            else
+                                sum[c] += static_cast<float>(channel);
+                        }
+                    }
+
+                    if (role == TextureRole::Normal)
+                    {
+                        auto length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+
+                        for (size_t c = 0U; c < 3U; c++)
+                            sum[c] = length > 1e-6F ? sum[c] / length : (c == 2U ? 1.0F : 0.0F);
+                    }
+
+                    for (size_t c = 0U; c < 4U; c++)
+                    {
+                        if (role == TextureRole::Albedo && c < 3U)
+                            pTexel[c] = LinearToSRGB(sum[c] * 0.25F); // NOLINT
+                        else if (role == TextureRole::Normal && c < 3U)
+                            pTexel[c] = static_cast<uint8_t>(std::lround((sum[c] + 1.0F) * 127.5F)); // NOLINT
+                        else
+                            pTexel[c] = static_cast<uint8_t>(std::lround(sum[c] * 0.25F)); // NOLINT
+                    }
+                }
+            }
+        });
+}
+
+// Compression Implementation
+// ------------------------------------------------------------
+
+void CompressTexture(const uint8_t* pTexels, VkExtent3D extent, TextureRole role, CompressedTexture* pTexture)
+{
+    PROFILE_START("Compress Texture");
+
+    auto texelCount = static_cast<size_t>(extent.width) * extent.height;
+
+    switch (role)
+    {
+        case TextureRole::Albedo:
+        {
+            // BC1 has no (useful) alpha, BC7 spends some of its precision on it.
+            auto isOpaque = true;
+
+            for (size_t texelIndex = 0U; texelIndex < texelCount && isOpaque; texelIndex++)
+                isOpaque = pTexels[texelIndex * 4U + 3U] == 255U; // NOLINT
+
+            pTexture->format        = isOpaque ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK;
+            pTexture->bytesPerBlock = isOpaque ? 8U : 16U;
+            break;
+        }
+        case TextureRole::Mask:
+            pTexture->format        = VK_FORMAT_BC4_UNORM_BLOCK;
+            pTexture->bytesPerBlock = 8U;
+            break;
+        case TextureRole::Normal:
+            pTexture->format        = VK_FORMAT_BC5_UNORM_BLOCK;
+            pTexture->bytesPerBlock = 16U;
+            break;
+    }
+
+    pTexture->extent    = { extent.width, extent.height, 1U };
+    pTexture->mipLevels = GetMipChainLevels(pTexture->extent);
+    pTexture->blocks.resize(GetMipChainSize(pTexture->extent, pTexture->format, pTexture->bytesPerBlock, pTexture->mipLevels));
+
+    const auto* pLevelTexels = pTexels;
+    auto*       pLevelBlocks = pTexture->blocks.data();
+
+    // Texels of the level being compressed, and of the one downsampled from it.
+    std::vector<uint8_t> levelTexels;
+    std::vector<uint8_t> nextLevelTexels;
+
+    for (uint32_t mipLevel = 0U; mipLevel < pTexture->mipLevels; mipLevel++)
+    {
+        auto levelWidth  = std::max(extent.width >> mipLevel, 1U);
+        auto levelHeight = std::max(extent.height >> mipLevel, 1U);
+
+        auto blocksWide = (levelWidth + kBlockDim - 1U) / kBlockDim;
+        auto blocksHigh = (levelHeight + kBlockDim - 1U) / kBlockDim;
+
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0U, blocksHigh),
+                          [&](const tbb::blocked_range<uint32_t>& blockRows)
+                          {
+                              TexelBlock block {};
+
+                              for (auto blockY = blockRows.begin(); blockY != blockRows.end(); blockY++)
+                              {
+                                  for (uint32_t blockX = 0U; blockX < blocksWide; blockX++)
+                                  {
+                                      FetchBlock(pLevelTexels, levelWidth, levelHeight, blockX, blockY, block);
+
+                                      auto* pBlock = pLevelBlocks + (static_cast<size_t>(blockY) * blocksWide + blockX) * pTexture->bytesPerBlock; // NOLINT
+
+                                      switch (pTexture->format)
+                                      {
+                                          case VK_FORMAT_BC1_RGB_SRGB_BLOCK: EncodeBC1(block, pBlock); break;
+                                          case VK_FORMAT_BC4_UNORM_BLOCK: EncodeBC4(block, 0U, pBlock); break;
+                                          case VK_FORMAT_BC5_UNORM_BLOCK: EncodeBC5(block, pBlock); break;
+                                          default: EncodeBC7(block, pBlock); break;
+                                      }
+                                  }
+                              }
+                          });
+
+        pLevelBlocks += static_cast<size_t>(blocksWide) * blocksHigh * pTexture->bytesPerBlock; // NOLINT
+
+        if (mipLevel + 1U == pTexture->mipLevels)
+            break;
+
+        VkExtent3D nextExtent = { std::max(levelWidth >> 1U, 1U), std::max(levelHeight >> 1U, 1U), 1U };
+
+        nextLevelTexels.resize(static_cast<size_t>(nextExtent.width) * nextExtent.height * 4U);
+        DownsampleLevel(pLevelTexels, levelWidth, levelHeight, nextLevelTexels.data(), nextExtent, role);
+
+        std::swap(levelTexels, nextLevelTexels);
+        pLevelTexels = levelTexels.data();
+    }
+
+    PROFILE_END;
+}